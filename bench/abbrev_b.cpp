@@ -0,0 +1,62 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the parsing of long options in a parser with many options, with
+// exact names and with abbreviated names.
+//
+// usage: abbrev_bench [OPTION_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct Definition
+{
+   std::vector<std::string> names;
+   std::vector<std::string> abbreviations;
+   std::deque<bool> targets;
+
+   Definition( size_t count )
+      : targets( count )
+   {
+      for ( size_t i = 0; i < count; ++i ) {
+         auto id = std::to_string( i );
+         names.push_back( "--option-" + id + "-with-a-long-name" );
+         abbreviations.push_back( "--option-" + id + "-" );
+      }
+   }
+
+   double parse( bool allowAbbrev, const std::vector<std::string>& args )
+   {
+      auto parser = argument_parser{};
+      parser.config().allow_abbrev( allowAbbrev );
+      auto params = parser.params();
+      for ( size_t i = 0; i < targets.size(); ++i )
+         params.add_parameter( targets[i], names[i] );
+
+      Stopwatch sw;
+      auto res = parser.parse_args( args );
+      auto ms = sw.elapsedMs();
+      return res ? ms : -1;
+   }
+};
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 5000 );
+
+   Definition definition( count );
+   report( "exact names", count, definition.parse( false, definition.names ) );
+   report( "exact names, abbrev enabled", count, definition.parse( true, definition.names ) );
+   report( "abbreviated names", count, definition.parse( true, definition.abbreviations ) );
+   return 0;
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Replacements of the global allocation functions that count the allocations
+// of a benchmark.  All the variants of operator new and operator delete are
+// replaced so that every allocation is counted and released by the matching
+// function.  Include this file in exactly one translation unit of a program.
+//
+// The functions are not inlined.  When an inlined operator delete calls
+// free() on a pointer returned by operator new, GCC reports
+// -Wmismatched-new-delete.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined( _MSC_VER )
+#define BENCH_NOINLINE __declspec( noinline )
+#elif defined( __GNUC__ )
+#define BENCH_NOINLINE __attribute__( ( noinline ) )
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace benchutil {
+inline size_t allocationCount = 0;
+inline size_t allocatedBytes = 0;
+
+namespace detail {
+BENCH_NOINLINE inline void* allocate( std::size_t size ) noexcept
+{
+   ++allocationCount;
+   allocatedBytes += size;
+   return std::malloc( size ? size : 1 );
+}
+
+BENCH_NOINLINE inline void* allocateAligned( std::size_t size, std::align_val_t align ) noexcept
+{
+   ++allocationCount;
+   allocatedBytes += size;
+   auto alignment = static_cast<std::size_t>( align );
+   // The size of aligned_alloc must be a multiple of the alignment.
+   size = ( ( size ? size : 1 ) + alignment - 1 ) / alignment * alignment;
+#ifdef _WIN32
+   return _aligned_malloc( size, alignment );
+#else
+   return std::aligned_alloc( alignment, size );
+#endif
+}
+
+BENCH_NOINLINE inline void release( void* p ) noexcept
+{
+   std::free( p );
+}
+
+BENCH_NOINLINE inline void releaseAligned( void* p ) noexcept
+{
+#ifdef _WIN32
+   _aligned_free( p );
+#else
+   std::free( p );
+#endif
+}
+
+inline void* allocateOrThrow( std::size_t size )
+{
+   if ( auto p = allocate( size ) )
+      return p;
+   throw std::bad_alloc();
+}
+
+inline void* allocateAlignedOrThrow( std::size_t size, std::align_val_t align )
+{
+   if ( auto p = allocateAligned( size, align ) )
+      return p;
+   throw std::bad_alloc();
+}
+}   // namespace detail
+}   // namespace benchutil
+
+BENCH_NOINLINE void* operator new( std::size_t size )
+{
+   return benchutil::detail::allocateOrThrow( size );
+}
+
+BENCH_NOINLINE void* operator new[]( std::size_t size )
+{
+   return benchutil::detail::allocateOrThrow( size );
+}
+
+BENCH_NOINLINE void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+   return benchutil::detail::allocate( size );
+}
+
+BENCH_NOINLINE void* operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+   return benchutil::detail::allocate( size );
+}
+
+BENCH_NOINLINE void* operator new( std::size_t size, std::align_val_t align )
+{
+   return benchutil::detail::allocateAlignedOrThrow( size, align );
+}
+
+BENCH_NOINLINE void* operator new[]( std::size_t size, std::align_val_t align )
+{
+   return benchutil::detail::allocateAlignedOrThrow( size, align );
+}
+
+BENCH_NOINLINE void* operator new(
+      std::size_t size, std::align_val_t align, const std::nothrow_t& ) noexcept
+{
+   return benchutil::detail::allocateAligned( size, align );
+}
+
+BENCH_NOINLINE void* operator new[](
+      std::size_t size, std::align_val_t align, const std::nothrow_t& ) noexcept
+{
+   return benchutil::detail::allocateAligned( size, align );
+}
+
+BENCH_NOINLINE void operator delete( void* p ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete( void* p, std::size_t ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p, std::size_t ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete( void* p, const std::nothrow_t& ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p, const std::nothrow_t& ) noexcept
+{
+   benchutil::detail::release( p );
+}
+
+BENCH_NOINLINE void operator delete( void* p, std::align_val_t ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p, std::align_val_t ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
+
+BENCH_NOINLINE void operator delete( void* p, std::size_t, std::align_val_t ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p, std::size_t, std::align_val_t ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
+
+BENCH_NOINLINE void operator delete( void* p, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
+
+BENCH_NOINLINE void operator delete[]( void* p, std::align_val_t, const std::nothrow_t& ) noexcept
+{
+   benchutil::detail::releaseAligned( p );
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the parse of many arguments read from a contiguous argument stream
+// and from a stream that only implements next() and peek().  The arguments
+// are flags and runs of values of vector options.
+//
+// usage: argstream_bench [ARGUMENT_COUNT] [PARSE_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+constexpr size_t valuesPerRun = 8;
+
+// Reads the arguments from a contiguous stream without exposing its windows.
+class SequentialStream : public ArgumentStream
+{
+   ArgumentStream& mStream;
+
+public:
+   SequentialStream( ArgumentStream& stream )
+      : mStream( stream )
+   {}
+
+   std::optional<std::string_view> next() override
+   {
+      return mStream.next();
+   }
+
+   void peek( std::function<EPeekResult( std::string_view )> fnPeek ) override
+   {
+      mStream.peek( fnPeek );
+   }
+};
+
+void measure( std::string_view name, size_t argumentCount, size_t parseCount, bool useWindows )
+{
+   std::vector<std::string> args;
+   while ( args.size() < argumentCount ) {
+      args.push_back( "-v" );
+      args.push_back( "--items" );
+      for ( size_t i = 0; i < valuesPerRun; ++i )
+         args.push_back( std::to_string( args.size() ) );
+   }
+   std::vector<std::string_view> views( args.begin(), args.end() );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   std::vector<long> items;
+   bool verbose = false;
+   params.add_parameter( items, "--items" ).minargs( 1 );
+   params.add_parameter( verbose, "-v" );
+
+   size_t failed = 0;
+   Stopwatch watch;
+   for ( size_t i = 0; i < parseCount; ++i ) {
+      auto stream = ContiguousArgumentStream( views.data(), views.data() + views.size() );
+      auto sequential = SequentialStream( stream );
+      ArgumentStream& source = useWindows ? static_cast<ArgumentStream&>( stream ) : sequential;
+      auto res = parser.parse_args( source );
+      failed += res ? 0 : 1;
+   }
+   auto ms = watch.elapsedMs();
+   if ( failed > 0 )
+      std::cout << "FAILED " << failed << " ";
+   report( name, parseCount * args.size(), ms );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto argumentCount = getCount( argc, argv, 1, 100000 );
+   auto parseCount = getCount( argc, argv, 2, 20 );
+
+   measure( "next and peek", argumentCount, parseCount, false );
+   measure( "windows", argumentCount, parseCount, true );
+
+   return 0;
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace benchutil {
+
+class Stopwatch
+{
+   using clock_t = std::chrono::steady_clock;
+   clock_t::time_point mStart = clock_t::now();
+
+public:
+   void restart()
+   {
+      mStart = clock_t::now();
+   }
+
+   double elapsedMs() const
+   {
+      return std::chrono::duration<double, std::milli>( clock_t::now() - mStart ).count();
+   }
+};
+
+// Read the @p index-th command line argument as a count or return @p defaultCount.
+inline size_t getCount( int argc, char** argv, int index, size_t defaultCount )
+{
+   if ( index < argc )
+      return std::strtoull( argv[index], nullptr, 10 );
+   return defaultCount;
+}
+
+inline void report( std::string_view name, size_t count, double ms )
+{
+   std::cout << name << ": " << count << " items, " << ms << " ms";
+   if ( count > 0 )
+      std::cout << ", " << ms * 1e6 / count << " ns/item";
+   std::cout << "\n";
+}
+
+}   // namespace benchutil
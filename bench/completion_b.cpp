@@ -0,0 +1,88 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the completion queries of a CLI with many commands and options.
+// Every command has 4 options; the rest of the options are defined in the
+// top-level parser.
+//
+// usage: completion_bench [COMMAND_COUNT [OPTION_COUNT]]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+class SubcommandOptions : public CommandOptions
+{
+   std::optional<std::string> mode;
+   std::optional<long> level;
+   std::optional<std::string> output;
+   bool force = false;
+
+public:
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( mode, "--mode" ).nargs( 1 ).choices( { "fast", "full", "safe" } );
+      params.add_parameter( level, "--level" ).nargs( 1 );
+      params.add_parameter( output, "--output", "-o" ).nargs( 1 );
+      params.add_parameter( force, "--force", "-f" );
+   }
+};
+
+struct Cli
+{
+   std::vector<std::optional<long>> targets;
+   argument_parser parser;
+
+   Cli( size_t commandCount, size_t optionCount )
+      : targets( optionCount > 4 * commandCount ? optionCount - 4 * commandCount : 0 )
+   {
+      auto params = parser.params();
+      for ( size_t i = 0; i < targets.size(); ++i )
+         params.add_parameter( targets[i], "--option-" + std::to_string( i ) ).nargs( 1 );
+      for ( size_t i = 0; i < commandCount; ++i )
+         params.add_command<SubcommandOptions>( "command-" + std::to_string( i ) );
+   }
+};
+
+double measureQueries( completion_engine& engine, const std::vector<std::string>& args, int count )
+{
+   size_t found = 0;
+   Stopwatch sw;
+   for ( int i = 0; i < count; ++i )
+      found += engine.complete( args, args.size() - 1 ).size();
+   auto ms = sw.elapsedMs();
+   return found > 0 ? ms / count : -1;
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto commandCount = getCount( argc, argv, 1, 1200 );
+   auto optionCount = getCount( argc, argv, 2, 5000 );
+
+   Stopwatch sw;
+   Cli cli( commandCount, optionCount );
+   report( "define parser", optionCount, sw.elapsedMs() );
+
+   sw.restart();
+   completion_engine engine( cli.parser );
+   auto candidates = engine.complete( { "command-11" }, 0 );
+   report( "create engine and first query", optionCount, sw.elapsedMs() );
+
+   const int queries = 1000;
+   report( "complete command prefix", 1, measureQueries( engine, { "command-11" }, queries ) );
+   report( "complete option prefix", 1, measureQueries( engine, { "--option-12" }, queries ) );
+   report( "complete subcommand option", 1,
+         measureQueries( engine, { "command-7", "--mode", "f" }, queries ) );
+   return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the assignment of values from a configuration file with many keys
+// and compare it with the parsing of the same values converted to arguments.
+//
+// usage: configfile_bench [KEY_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct Definition
+{
+   std::vector<std::string> names;
+   std::vector<std::string> targets;
+
+   Definition( size_t count )
+      : targets( count )
+   {
+      for ( size_t i = 0; i < count; ++i )
+         names.push_back( "setting-" + std::to_string( i ) );
+   }
+
+   void define( argument_parser& parser )
+   {
+      auto params = parser.params();
+      for ( size_t i = 0; i < targets.size(); ++i )
+         params.add_parameter( targets[i], "--" + names[i] ).nargs( 1 );
+   }
+
+   void write( const std::string& path )
+   {
+      std::ofstream file( path );
+      for ( auto& name : names )
+         file << name << " = value of " << name << "\n";
+   }
+
+   // The file is converted to arguments of the form --key=value.
+   double parseArguments( const std::string& path )
+   {
+      auto parser = argument_parser{};
+      define( parser );
+
+      Stopwatch sw;
+      std::vector<std::string> args;
+      std::ifstream file( path );
+      std::string line;
+      while ( std::getline( file, line ) ) {
+         auto eqpos = line.find( " = " );
+         args.push_back( "--" + line.substr( 0, eqpos ) + "=" + line.substr( eqpos + 3 ) );
+      }
+      auto res = parser.parse_args( args );
+      auto ms = sw.elapsedMs();
+      return res ? ms : -1;
+   }
+
+   double parseConfigFile( const std::string& path )
+   {
+      auto parser = argument_parser{};
+      define( parser );
+
+      Stopwatch sw;
+      config_file config;
+      config.open( path );
+      auto parse = parser.begin_parse();
+      parse.feed( config );
+      auto res = parse.finish();
+      auto ms = sw.elapsedMs();
+      return res ? ms : -1;
+   }
+};
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 20000 );
+   auto path = std::string( "argumentum-bench.ini" );
+
+   Definition definition( count );
+   definition.write( path );
+   report( "arguments from file", count, definition.parseArguments( path ) );
+   report( "config file", count, definition.parseConfigFile( path ) );
+   std::remove( path.c_str() );
+   return 0;
+}
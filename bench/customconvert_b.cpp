@@ -0,0 +1,124 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the conversion of arguments to custom types with
+// from_string<T>::convert( const std::string& ) and with
+// from_string<T>::convert( std::string_view ).  The arguments are longer than
+// the small string buffer so every copy to a string allocates.
+//
+// usage: customconvert_bench [ARGUMENT_COUNT]
+
+#include "allocationcounter.h"
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+// A 128-bit hash written as 32 hexadecimal digits.
+struct Hash
+{
+   uint64_t high = 0;
+   uint64_t low = 0;
+};
+
+struct StringHash : public Hash
+{};
+
+struct ViewHash : public Hash
+{};
+
+std::optional<Hash> parseHash( std::string_view s )
+{
+   Hash hash;
+   if ( s.size() != 32 )
+      return {};
+   auto phalf = s.data() + 16;
+   auto pend = s.data() + 32;
+   if ( std::from_chars( s.data(), phalf, hash.high, 16 ).ptr != phalf
+         || std::from_chars( phalf, pend, hash.low, 16 ).ptr != pend )
+      return {};
+   return hash;
+}
+}   // namespace
+
+namespace argumentum {
+template<>
+struct from_string<StringHash>
+{
+   static StringHash convert( const std::string& s )
+   {
+      auto hash = parseHash( s );
+      if ( !hash )
+         throw std::invalid_argument( s );
+      StringHash result;
+      static_cast<Hash&>( result ) = *hash;
+      return result;
+   }
+};
+
+template<>
+struct from_string<ViewHash>
+{
+   static std::optional<ViewHash> convert( std::string_view s )
+   {
+      auto hash = parseHash( s );
+      if ( !hash )
+         return {};
+      ViewHash result;
+      static_cast<Hash&>( result ) = *hash;
+      return result;
+   }
+};
+}   // namespace argumentum
+
+namespace {
+template<typename T>
+void measure( std::string_view name, const std::vector<std::string>& args )
+{
+   std::vector<T> hashes;
+   hashes.reserve( args.size() );
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( hashes, "--hash" ).minargs( 1 );
+
+   auto startCount = allocationCount;
+   Stopwatch watch;
+   auto res = parser.parse_args( args );
+   auto ms = watch.elapsedMs();
+   if ( !res || hashes.size() + 1 != args.size() )
+      std::cout << "FAILED ";
+   report( name, hashes.size(), ms );
+   std::cout << "   allocations: " << allocationCount - startCount << "\n";
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 100000 );
+
+   std::vector<std::string> args;
+   args.reserve( count + 1 );
+   args.push_back( "--hash" );
+   char digits[] = "0123456789abcdef";
+   for ( size_t i = 0; i < count; ++i ) {
+      std::string hash( 32, '0' );
+      auto n = i * 2654435761u;
+      for ( size_t k = 0; k < hash.size(); ++k, n = n * 31 + 7 )
+         hash[k] = digits[n % 16];
+      args.push_back( hash );
+   }
+
+   measure<StringHash>( "convert( const std::string& )", args );
+   measure<ViewHash>( "convert( std::string_view )", args );
+   return 0;
+}
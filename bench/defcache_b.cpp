@@ -0,0 +1,72 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the definition of a parser with many options and groups with and
+// without a definition cache.
+//
+// usage: defcache_bench [OPTION_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct Definition
+{
+   std::vector<std::string> names;
+   std::vector<std::string> help;
+   std::vector<std::optional<long>> targets;
+
+   Definition( size_t count )
+      : targets( count )
+   {
+      for ( size_t i = 0; i < count; ++i ) {
+         names.push_back( "--option-" + std::to_string( i ) );
+         help.push_back( "The help of the option number " + std::to_string( i ) + "." );
+      }
+   }
+
+   double define( const std::string& cachePath )
+   {
+      Stopwatch sw;
+      auto parser = argument_parser{};
+      if ( !cachePath.empty() )
+         parser.config().definition_cache( cachePath, "bench" );
+
+      auto params = parser.params();
+      for ( size_t i = 0; i < targets.size(); ++i ) {
+         if ( i % 100 == 0 )
+            params.add_group( "group-" + std::to_string( i / 100 ) );
+         params.add_parameter( targets[i], names[i] ).nargs( 1 ).help( help[i] );
+      }
+      params.end_group();
+
+      auto res = parser.parse_args( { names[0], "1" } );
+      auto ms = sw.elapsedMs();
+      return res ? ms : -1;
+   }
+};
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 5000 );
+   const std::string cachePath = "defcache_bench.cache";
+   std::remove( cachePath.c_str() );
+
+   Definition definition( count );
+   report( "define without cache", count, definition.define( "" ) );
+   report( "define and write cache", count, definition.define( cachePath ) );
+   report( "define from cache", count, definition.define( cachePath ) );
+
+   std::remove( cachePath.c_str() );
+   return 0;
+}
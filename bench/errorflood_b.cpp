@@ -0,0 +1,140 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the parse of input in which most of the arguments can not be
+// converted.  The benchmark is built with and without exceptions
+// (errorflood_bench and errorflood_noexcept_bench).
+//
+// usage: errorflood_bench [ARGUMENT_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse-h.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct Point
+{
+   long x = 0;
+   long y = 0;
+};
+
+// A custom type that reports its conversion errors by throwing.
+struct ThrowingPoint : public Point
+{};
+}   // namespace
+
+namespace argumentum {
+template<>
+struct from_string<Point>
+{
+   static ConversionResult<Point> try_convert( const std::string& s )
+   {
+      auto comma = s.find( ',' );
+      if ( comma == std::string::npos )
+         return EConversionError::invalidValue;
+
+      Point point;
+      if ( !parse_number( std::string_view( s ).substr( 0, comma ), point.x )
+            || !parse_number( std::string_view( s ).substr( comma + 1 ), point.y ) )
+         return EConversionError::invalidValue;
+      return point;
+   }
+};
+
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+template<>
+struct from_string<ThrowingPoint>
+{
+   static ThrowingPoint convert( const std::string& s )
+   {
+      auto res = from_string<Point>::try_convert( s );
+      if ( !res )
+         throw std::invalid_argument( s );
+      ThrowingPoint point;
+      point.x = res.value.x;
+      point.y = res.value.y;
+      return point;
+   }
+};
+#endif
+}   // namespace argumentum
+
+namespace {
+struct FloodOptions
+{
+   long count = 0;
+   short level = 0;
+   std::string color;
+   std::vector<long> ids;
+   Point point;
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+   ThrowingPoint throwingPoint;
+#endif
+
+   void add( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( count, "--count" ).nargs( 1 );
+      params.add_parameter( level, "--level" ).nargs( 1 );
+      params.add_parameter( color, "--color" ).nargs( 1 ).choices( { "red", "green" } );
+      params.add_parameter( ids, "--ids" ).minargs( 1 ).split( ',' );
+      params.add_parameter( point, "--point" ).nargs( 1 );
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+      params.add_parameter( throwingPoint, "--throwing-point" ).nargs( 1 );
+#endif
+   }
+};
+
+void measure( argument_parser& parser, std::string_view name, const std::string& option,
+      const std::string& value, size_t count )
+{
+   std::vector<std::string> args;
+   args.reserve( 2 * count );
+   for ( size_t i = 0; i < count; ++i ) {
+      args.push_back( option );
+      args.push_back( value );
+   }
+
+   Stopwatch watch;
+   auto res = parser.parse_args( args );
+   auto ms = watch.elapsedMs();
+   std::cout << ( res ? "ok    " : "errors" ) << " " << res.errors.size() << " ";
+   report( name, count, ms );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 100000 );
+
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   std::cout << "without exceptions\n";
+#else
+   std::cout << "with exceptions\n";
+#endif
+
+   // The errors are described to a stream without a buffer.
+   std::ostream discard( nullptr );
+   FloodOptions opt;
+   auto parser = argument_parser{};
+   parser.config().cout( discard );
+   opt.add( parser );
+
+   measure( parser, "valid number", "--count", "42", count );
+   measure( parser, "invalid number", "--count", "many", count );
+   measure( parser, "number out of range", "--level", "99999", count );
+   measure( parser, "invalid choice", "--color", "blue", count );
+   measure( parser, "invalid list element", "--ids", "1,2,x", count );
+   measure( parser, "invalid custom value", "--point", "1;2", count );
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+   measure( parser, "throwing custom value", "--throwing-point", "1;2", count );
+#endif
+   return 0;
+}
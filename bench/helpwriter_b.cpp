@@ -0,0 +1,93 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the formatting of a generated help page with many options and of
+// the same help texts written directly with a Writer.
+//
+// usage: helpwriter_bench [OPTION_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <argumentum/../../src/writer.h>
+
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct HelpPage
+{
+   std::vector<std::string> names;
+   std::vector<std::string> help;
+   std::vector<std::optional<long>> targets;
+
+   HelpPage( size_t count )
+      : targets( count )
+   {
+      for ( size_t i = 0; i < count; ++i ) {
+         names.push_back( "--option-" + std::to_string( i ) );
+         auto text = "Set the value of the option number " + std::to_string( i )
+               + ". The value is used by the command when the input is processed.";
+         if ( i % 4 == 0 )
+            text += "\n\nThe second paragraph mentions the naïve café and the 日本語 text.";
+         help.push_back( text );
+      }
+   }
+
+   size_t formatHelp( double& ms )
+   {
+      std::stringstream strout;
+      auto parser = argument_parser{};
+      parser.config().program( "helpwriter_bench" ).cout( strout );
+      auto params = parser.params();
+      for ( size_t i = 0; i < targets.size(); ++i )
+         params.add_parameter( targets[i], names[i] ).nargs( 1 ).help( help[i] );
+
+      Stopwatch sw;
+      auto res = parser.parse_args( { "--help" } );
+      ms = sw.elapsedMs();
+      return !res && res.help_was_shown() ? strout.str().size() : 0;
+   }
+
+   size_t writeHelp( double& ms )
+   {
+      std::stringstream strout;
+      Stopwatch sw;
+      {
+         Writer writer( strout, 80 );
+         for ( size_t i = 0; i < help.size(); ++i ) {
+            writer.setIndent( 2 );
+            writer.write( names[i] );
+            writer.skipToColumnOrNewLine( 30 );
+            writer.setIndent( 30 );
+            writer.write( help[i] );
+            writer.startLine();
+         }
+      }
+      ms = sw.elapsedMs();
+      return strout.str().size();
+   }
+};
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 10000 );
+
+   HelpPage page( count );
+   double ms = 0;
+   auto size = page.formatHelp( ms );
+   report( "format help", count, ms );
+   std::cout << "help size: " << size << " bytes\n";
+
+   size = page.writeHelp( ms );
+   report( "write help texts", count, ms );
+   std::cout << "text size: " << size << " bytes\n";
+   return 0;
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// A program with a generated CLI used by largecli_bench.  It defines the
+// parser for the given size, parses a generated command line and prints the
+// number of allocations and the time spent in the library.  It is built with
+// the static library and with the header-only library
+// (LARGECLI_HEADER_ONLY).
+//
+// usage: largecli OPTION_COUNT COMMAND_COUNT GROUP_COUNT
+
+#ifdef LARGECLI_HEADER_ONLY
+#include <argumentum/argparse-h.h>
+#else
+#include <argumentum/argparse.h>
+#endif
+
+#include "allocationcounter.h"
+#include "largecli.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace largecli;
+
+namespace {
+// The targets of the options of a command.  The deques keep the references
+// to the targets valid while they grow.
+struct Targets
+{
+   std::deque<bool> flags;
+   std::deque<long> numbers;
+   std::deque<std::string> strings;
+   std::deque<std::vector<std::string>> lists;
+};
+
+void defineOption( ParameterConfig& params, const OptionSpec& option, Targets& targets )
+{
+   auto name = "--" + option.name;
+   switch ( option.kind ) {
+      case EOptionKind::flag:
+         params.add_parameter( targets.flags.emplace_back(), name ).help( option.help );
+         break;
+      case EOptionKind::number:
+         params.add_parameter( targets.numbers.emplace_back(), name ).nargs( 1 ).help( option.help );
+         break;
+      case EOptionKind::choice:
+         params.add_parameter( targets.strings.emplace_back(), name )
+               .nargs( 1 )
+               .choices( option.choices )
+               .help( option.help );
+         break;
+      case EOptionKind::list:
+         params.add_parameter( targets.lists.emplace_back(), name ).minargs( 1 ).help( option.help );
+         break;
+   }
+}
+
+void defineCommands( ParameterConfig& params, const CommandSpec& parent );
+
+// The options of a generated command are defined when the command is
+// selected by an input argument.
+class GeneratedCommand : public CommandOptions
+{
+   const CommandSpec& mSpec;
+   Targets mTargets;
+
+public:
+   GeneratedCommand( std::string_view name, const CommandSpec& spec )
+      : CommandOptions( name )
+      , mSpec( spec )
+   {}
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      for ( auto& option : mSpec.options )
+         defineOption( params, option, mTargets );
+      defineCommands( params, mSpec );
+   }
+};
+
+void defineCommands( ParameterConfig& params, const CommandSpec& parent )
+{
+   for ( auto& command : parent.commands ) {
+      auto factory = [&command]( std::string_view name ) {
+         return std::make_shared<GeneratedCommand>( name, command );
+      };
+      params.add_command( command.name, factory ).help( command.help );
+   }
+}
+
+void defineCli( argument_parser& parser, const CliSpec& spec, Targets& targets )
+{
+   auto params = parser.params();
+   for ( auto& option : spec.program.options )
+      if ( option.group < 0 )
+         defineOption( params, option, targets );
+
+   for ( size_t group = 0; group < spec.groups.size(); ++group ) {
+      params.add_group( spec.groups[group] ).description( "The options of " + spec.groups[group] );
+      for ( auto& option : spec.program.options )
+         if ( option.group == static_cast<int>( group ) )
+            defineOption( params, option, targets );
+      params.end_group();
+   }
+
+   defineCommands( params, spec.program );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   if ( argc < 4 ) {
+      std::fputs( "usage: largecli OPTION_COUNT COMMAND_COUNT GROUP_COUNT\n", stderr );
+      return 2;
+   }
+
+   auto spec = generateCli( std::strtoull( argv[1], nullptr, 10 ),
+         std::strtoull( argv[2], nullptr, 10 ), std::strtoull( argv[3], nullptr, 10 ) );
+   auto args = generateArguments( spec, 20 );
+
+   auto startCount = benchutil::allocationCount;
+   auto startBytes = benchutil::allocatedBytes;
+   auto start = std::chrono::steady_clock::now();
+
+   Targets targets;
+   auto parser = argument_parser{};
+   parser.config().program( "largecli" );
+   defineCli( parser, spec, targets );
+   auto res = parser.parse_args( args, 0 );
+
+   auto ms = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start )
+                   .count();
+   if ( !res ) {
+      std::fputs( "largecli: the generated arguments were not parsed\n", stderr );
+      return 1;
+   }
+
+   std::printf( "%zu %zu %.3f %zu\n", benchutil::allocationCount - startCount,
+         benchutil::allocatedBytes - startBytes, ms, res.commands.size() );
+   return 0;
+}
@@ -0,0 +1,189 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// A generator of large synthetic command line interfaces.  A CliSpec is
+// generated from the number of options, commands and groups and a seed.  The
+// options are distributed between the program and the commands, the commands
+// are nested up to three levels and some options have choices.  A matching
+// command line is generated with generateArguments().  The spec is bound to a
+// parser in largecli.cpp.
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace largecli {
+
+enum class EOptionKind { flag, number, choice, list };
+
+struct OptionSpec
+{
+   std::string name;
+   std::string help;
+   EOptionKind kind = EOptionKind::flag;
+   std::vector<std::string> choices;
+   // The index of the group or -1 if the option is not in a group.
+   int group = -1;
+};
+
+struct CommandSpec
+{
+   std::string name;
+   std::string help;
+   std::vector<OptionSpec> options;
+   std::vector<CommandSpec> commands;
+};
+
+struct CliSpec
+{
+   std::vector<std::string> groups;
+   // The options and the commands of the program.
+   CommandSpec program;
+};
+
+namespace detail {
+inline const std::vector<std::string>& words()
+{
+   static const std::vector<std::string> words = { "build", "cache", "color", "config",
+      "debug", "depth", "dry", "format", "index", "input", "jobs", "level", "limit", "log",
+      "mode", "output", "path", "profile", "quiet", "retry", "root", "run", "server", "size",
+      "skip", "sync", "target", "test", "timeout", "trace", "user", "verbose" };
+   return words;
+}
+
+inline std::string makeName( std::mt19937& rng, size_t index )
+{
+   auto& w = words();
+   return w[rng() % w.size()] + "-" + w[rng() % w.size()] + "-" + std::to_string( index );
+}
+
+inline OptionSpec makeOption( std::mt19937& rng, size_t index, int group )
+{
+   OptionSpec option;
+   option.name = makeName( rng, index );
+   option.help = "Set the " + option.name + " of the operation.  The value is used when the "
+         + "input is processed.";
+   option.group = group;
+   switch ( index % 10 ) {
+      case 0:
+      case 1:
+      case 2:
+      case 3:
+         option.kind = EOptionKind::flag;
+         break;
+      case 4:
+      case 5:
+      case 6:
+         option.kind = EOptionKind::number;
+         break;
+      case 7:
+      case 8:
+         option.kind = EOptionKind::choice;
+         for ( size_t i = 0, count = 3 + rng() % 4; i < count; ++i )
+            option.choices.push_back( words()[( index + i * 7 ) % words().size()] );
+         break;
+      default:
+         option.kind = EOptionKind::list;
+         break;
+   }
+   return option;
+}
+
+inline void collectCommands( CommandSpec& command, std::vector<CommandSpec*>& commands )
+{
+   for ( auto& sub : command.commands ) {
+      commands.push_back( &sub );
+      collectCommands( sub, commands );
+   }
+}
+}   // namespace detail
+
+// Generate a CLI with @p optionCount options, @p commandCount commands and
+// @p groupCount option groups.  Half of the options belong to the program and
+// the rest are distributed among the commands.  The groups are defined in the
+// program.
+inline CliSpec generateCli(
+      size_t optionCount, size_t commandCount, size_t groupCount, unsigned seed = 1 )
+{
+   std::mt19937 rng( seed );
+   CliSpec spec;
+   for ( size_t i = 0; i < groupCount; ++i )
+      spec.groups.push_back( "group-" + std::to_string( i ) );
+
+   // A quarter of the commands are nested in the top-level commands or in
+   // their subcommands.
+   auto topCount = commandCount - commandCount / 4;
+   auto& program = spec.program;
+   for ( size_t i = 0; i < commandCount; ++i ) {
+      CommandSpec command;
+      command.name = detail::words()[rng() % detail::words().size()] + std::to_string( i );
+      command.help = "Run the command " + command.name + ".";
+      if ( i < topCount )
+         program.commands.push_back( std::move( command ) );
+      else {
+         auto pParent = &program.commands[rng() % topCount];
+         if ( !pParent->commands.empty() && rng() % 2 )
+            pParent = &pParent->commands[rng() % pParent->commands.size()];
+         pParent->commands.push_back( std::move( command ) );
+      }
+   }
+
+   std::vector<CommandSpec*> commands;
+   detail::collectCommands( program, commands );
+
+   auto programCount = commands.empty() ? optionCount : ( optionCount + 1 ) / 2;
+   for ( size_t i = 0; i < optionCount; ++i ) {
+      if ( i < programCount ) {
+         auto group = groupCount > 0 ? static_cast<int>( i % ( groupCount + 1 ) ) - 1 : -1;
+         program.options.push_back( detail::makeOption( rng, i, group ) );
+      }
+      else
+         commands[rng() % commands.size()]->options.push_back( detail::makeOption( rng, i, -1 ) );
+   }
+
+   return spec;
+}
+
+// Generate a command line with @p optionCount options of the program and a
+// path of commands with their options.
+inline std::vector<std::string> generateArguments(
+      const CliSpec& spec, size_t optionCount, unsigned seed = 1 )
+{
+   std::mt19937 rng( seed );
+   std::vector<std::string> args;
+   auto addOptions = [&]( const CommandSpec& command, size_t count ) {
+      if ( command.options.empty() )
+         return;
+      for ( size_t i = 0; i < count; ++i ) {
+         auto& option = command.options[rng() % command.options.size()];
+         args.push_back( "--" + option.name );
+         switch ( option.kind ) {
+            case EOptionKind::flag:
+               break;
+            case EOptionKind::number:
+               args.push_back( std::to_string( rng() % 1000 ) );
+               break;
+            case EOptionKind::choice:
+               args.push_back( option.choices[rng() % option.choices.size()] );
+               break;
+            case EOptionKind::list:
+               args.push_back( "first" );
+               args.push_back( "second" );
+               break;
+         }
+      }
+   };
+
+   addOptions( spec.program, optionCount );
+   auto pCommand = &spec.program;
+   while ( !pCommand->commands.empty() ) {
+      pCommand = &pCommand->commands[rng() % pCommand->commands.size()];
+      args.push_back( pCommand->name );
+      addOptions( *pCommand, 4 );
+   }
+   return args;
+}
+
+}   // namespace largecli
@@ -0,0 +1,135 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the programs with generated CLIs of increasing size from the start
+// of the process to the finished parse.  The programs are built with the
+// static and with the header-only library.  For every size the benchmark
+// reports:
+//    - the median wall time of the process,
+//    - the median time spent in the library (define + parse),
+//    - the number and the size of the allocations in the library,
+//    - the maximum resident set size of the process.
+//
+// usage: largecli_bench [RUN_COUNT [OPTION_COUNT COMMAND_COUNT GROUP_COUNT]]
+
+#include "benchutil.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace benchutil;
+
+namespace {
+struct CliSize
+{
+   size_t options;
+   size_t commands;
+   size_t groups;
+};
+
+struct RunResult
+{
+   bool ok = false;
+   double wallMs = 0;
+   double parseMs = 0;
+   size_t allocations = 0;
+   size_t allocatedBytes = 0;
+   long maxRssKb = 0;
+};
+
+RunResult runProgram( const std::string& program, const CliSize& size )
+{
+   RunResult result;
+   int fds[2];
+   if ( pipe( fds ) != 0 )
+      return result;
+
+   auto options = std::to_string( size.options );
+   auto commands = std::to_string( size.commands );
+   auto groups = std::to_string( size.groups );
+
+   Stopwatch sw;
+   auto pid = fork();
+   if ( pid == 0 ) {
+      dup2( fds[1], STDOUT_FILENO );
+      close( fds[0] );
+      close( fds[1] );
+      execl( program.c_str(), program.c_str(), options.c_str(), commands.c_str(),
+            groups.c_str(), static_cast<char*>( nullptr ) );
+      _exit( 127 );
+   }
+   close( fds[1] );
+
+   std::string output;
+   std::array<char, 256> buffer;
+   ssize_t count;
+   while ( ( count = read( fds[0], buffer.data(), buffer.size() ) ) > 0 )
+      output.append( buffer.data(), static_cast<size_t>( count ) );
+   close( fds[0] );
+
+   int status = 0;
+   struct rusage usage;
+   if ( pid < 0 || wait4( pid, &status, 0, &usage ) != pid )
+      return result;
+   result.wallMs = sw.elapsedMs();
+
+   size_t commandCount = 0;
+   auto parsed = std::sscanf( output.c_str(), "%zu %zu %lf %zu", &result.allocations,
+         &result.allocatedBytes, &result.parseMs, &commandCount );
+   result.ok = WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && parsed == 4;
+   result.maxRssKb = usage.ru_maxrss;
+   return result;
+}
+
+double median( std::vector<double> values )
+{
+   std::sort( values.begin(), values.end() );
+   return values.empty() ? 0 : values[values.size() / 2];
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto runCount = std::max<size_t>( 1, getCount( argc, argv, 1, 5 ) );
+   std::vector<CliSize> sizes = { { 100, 10, 5 }, { 1000, 50, 10 }, { 10000, 200, 20 },
+      { 50000, 1000, 50 } };
+   if ( argc > 4 )
+      sizes = { { getCount( argc, argv, 2, 0 ), getCount( argc, argv, 3, 0 ),
+            getCount( argc, argv, 4, 0 ) } };
+
+   const std::pair<std::string, std::string> programs[] = {
+      { "static", LARGECLI_STATIC },
+      { "header-only", LARGECLI_HEADER_ONLY },
+   };
+
+   for ( auto& size : sizes ) {
+      for ( auto& [name, program] : programs ) {
+         std::vector<double> wall;
+         std::vector<double> parse;
+         RunResult last;
+         for ( size_t i = 0; i < runCount; ++i ) {
+            last = runProgram( program, size );
+            if ( !last.ok ) {
+               std::cout << name << ": the program failed\n";
+               return 1;
+            }
+            wall.push_back( last.wallMs );
+            parse.push_back( last.parseMs );
+         }
+
+         std::cout << name << " " << size.options << " options, " << size.commands
+                   << " commands, " << size.groups << " groups: process " << median( wall )
+                   << " ms, library " << median( parse ) << " ms, " << last.allocations
+                   << " allocations (" << last.allocatedBytes / 1024 << " KiB), max RSS "
+                   << last.maxRssKb << " KiB\n";
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the conversion of a single argument with a long comma delimited list
+// of numbers.
+//
+// usage: numlist_bench [COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 10'000'000 );
+
+   std::string ids;
+   std::string weights;
+   for ( size_t i = 0; i < count; ++i ) {
+      if ( i > 0 ) {
+         ids += ',';
+         weights += ',';
+      }
+      ids += std::to_string( i * 7919 );
+      weights += std::to_string( i ) + ".25";
+   }
+
+   {
+      std::vector<uint64_t> values;
+      auto parser = argument_parser{};
+      parser.params().add_parameter( values, "--ids" ).split();
+
+      Stopwatch sw;
+      auto res = parser.parse_args( { "--ids", ids } );
+      report( "split vector<uint64_t>", values.size(), sw.elapsedMs() );
+      if ( !res )
+         return 1;
+   }
+
+   {
+      std::vector<double> values;
+      auto parser = argument_parser{};
+      parser.params().add_parameter( values, "--weights" ).split();
+
+      Stopwatch sw;
+      auto res = parser.parse_args( { "--weights", weights } );
+      report( "split vector<double>", values.size(), sw.elapsedMs() );
+      if ( !res )
+         return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the memory used by the definitions of many options with help texts,
+// metavars and choices and the time to parse the arguments of all the options.
+//
+// usage: optionmemory_bench [OPTION_COUNT]
+
+#include "allocationcounter.h"
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+const char* helpTexts[] = {
+   "Set the level of detail of the messages written to the log.",
+   "The maximum number of entries kept in the cache before the oldest are evicted.",
+   "The directory where the output files are written.",
+   "The number of threads used for the processing of the input files.",
+   "The timeout in seconds after which the connection is closed.",
+   "The format of the generated report.",
+   "The number of times a failed request is retried.",
+   "The size of the buffer used for reading the input in kilobytes.",
+};
+
+const char* metavars[] = { "LEVEL", "COUNT", "PATH", "N", "SECONDS", "FORMAT" };
+
+void defineOptions( argument_parser& parser, std::vector<std::string>& values )
+{
+   auto params = parser.params();
+   for ( size_t i = 0; i < values.size(); ++i ) {
+      auto option = params.add_parameter( values[i], "--option-" + std::to_string( i ) );
+      option.nargs( 1 ).metavar( metavars[i % 6] ).help( helpTexts[i % 8] );
+      if ( i % 4 == 0 )
+         option.choices( { "text", "json", "yaml", "xml" } );
+   }
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 10000 );
+
+   std::vector<std::string> values( count );
+   auto parser = argument_parser{};
+
+   Stopwatch watch;
+   auto startCount = allocationCount;
+   auto startBytes = allocatedBytes;
+   defineOptions( parser, values );
+   report( "define", count, watch.elapsedMs() );
+   std::cout << "  allocations: " << allocationCount - startCount << ", "
+             << ( allocatedBytes - startBytes ) / 1024 << " KiB, "
+             << ( allocatedBytes - startBytes ) / count << " bytes/option\n";
+
+   auto usage = parser.memory_usage();
+   std::cout << "  memory_usage: " << usage.total() / 1024 << " KiB, " << usage.perOption()
+             << " bytes/option (hot " << usage.options.hotBytes / usage.optionCount
+             << ", cold " << usage.options.coldBytes / usage.optionCount << ", heap "
+             << usage.options.heapBytes / usage.optionCount << ", string pool "
+             << usage.stringPoolBytes << " bytes)\n";
+
+   std::vector<std::string> args;
+   for ( size_t i = 0; i < count; ++i ) {
+      args.push_back( "--option-" + std::to_string( i ) );
+      args.push_back( i % 4 == 0 ? "json" : "value" );
+   }
+
+   size_t rounds = 3;
+   watch.restart();
+   for ( size_t i = 0; i < rounds; ++i ) {
+      auto res = parser.parse_args( args );
+      if ( !res ) {
+         std::cout << "parse failed\n";
+         return 1;
+      }
+   }
+   report( "parse", count * rounds, watch.elapsedMs() );
+   return 0;
+}
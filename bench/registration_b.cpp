@@ -0,0 +1,81 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the registration of many options with add_parameter and with
+// add_parameters_bulk and the parse of the arguments of all the options.
+//
+// usage: registration_bench [OPTION_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct PluginOptions
+{
+   std::vector<std::string> names;
+   std::vector<std::string> values;
+   std::vector<std::string> args;
+
+   explicit PluginOptions( size_t count )
+      : names( count )
+      , values( count )
+   {
+      for ( size_t i = 0; i < count; ++i ) {
+         names[i] = "--plugin-" + std::to_string( i % 97 ) + "-option-" + std::to_string( i );
+         args.push_back( names[i] );
+         args.push_back( "value" );
+      }
+   }
+};
+
+void parseAll( std::string_view name, argument_parser& parser, const PluginOptions& options )
+{
+   Stopwatch watch;
+   auto res = parser.parse_args( options.args );
+   auto ms = watch.elapsedMs();
+   if ( !res )
+      std::cout << "FAILED ";
+   report( name, options.names.size(), ms );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 5000 );
+
+   {
+      PluginOptions options( count );
+      Stopwatch watch;
+      auto parser = argument_parser{};
+      auto params = parser.params();
+      for ( size_t i = 0; i < count; ++i )
+         params.add_parameter( options.values[i], options.names[i] ).nargs( 1 ).help( "A value." );
+      report( "add_parameter", count, watch.elapsedMs() );
+      parseAll( "parse", parser, options );
+   }
+
+#ifndef REGISTRATION_BASELINE
+   {
+      PluginOptions options( count );
+      Stopwatch watch;
+      std::vector<ParameterDescriptor<std::string>> descriptors;
+      descriptors.reserve( count );
+      for ( size_t i = 0; i < count; ++i )
+         descriptors.push_back( { &options.values[i], options.names[i], {}, 1, "A value." } );
+
+      auto parser = argument_parser{};
+      parser.params().add_parameters_bulk( descriptors.data(), descriptors.size() );
+      report( "add_parameters_bulk", count, watch.elapsedMs() );
+      parseAll( "parse", parser, options );
+   }
+#endif
+
+   return 0;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure a loop that parses a few arguments with the same parser.  The
+// parser has many options with string and vector targets and each parse uses
+// only three of them.
+//
+// usage: reparse_bench [OPTION_COUNT] [PARSE_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+#ifdef REPARSE_BASELINE
+// The targets are always reset eagerly by the parsers without the reset modes.
+enum class EValueReset { eager };
+#endif
+
+void measure( std::string_view name, size_t optionCount, size_t parseCount, EValueReset reset )
+{
+   std::vector<std::string> strings( optionCount / 2 );
+   std::vector<std::vector<std::string>> lists( optionCount - strings.size() );
+   auto parser = argument_parser{};
+#ifndef REPARSE_BASELINE
+   parser.config().value_reset( reset );
+#endif
+   auto params = parser.params();
+   for ( size_t i = 0; i < strings.size(); ++i )
+      params.add_parameter( strings[i], "--string-" + std::to_string( i ) ).nargs( 1 );
+   for ( size_t i = 0; i < lists.size(); ++i )
+      params.add_parameter( lists[i], "--list-" + std::to_string( i ) ).minargs( 1 );
+
+   std::vector<std::string> args = { "--string-7", "value", "--list-3", "a", "b", "--string-11",
+      "other" };
+
+   size_t failed = 0;
+   Stopwatch watch;
+   for ( size_t i = 0; i < parseCount; ++i ) {
+      auto res = parser.parse_args( args );
+      failed += res ? 0 : 1;
+   }
+   auto ms = watch.elapsedMs();
+   if ( failed > 0 )
+      std::cout << "FAILED " << failed << " ";
+   report( name, parseCount, ms );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto optionCount = getCount( argc, argv, 1, 5000 );
+   auto parseCount = getCount( argc, argv, 2, 1000 );
+
+   measure( "reset eager", optionCount, parseCount, EValueReset::eager );
+#ifndef REPARSE_BASELINE
+   measure( "reset on touch", optionCount, parseCount, EValueReset::onTouch );
+#endif
+
+   return 0;
+}
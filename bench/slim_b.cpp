@@ -0,0 +1,67 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Compare the full and the slim (ARGUMENTUM_SLIM) build of the header-only
+// library: the size of the executables built from slimprogram.cpp, the time
+// to run them and the time to compile them.
+//
+// usage: slim_bench [RUN_COUNT [COMPILE_COUNT]]
+
+#include "benchutil.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+using namespace benchutil;
+
+namespace {
+struct Variant
+{
+   std::string name;
+   std::string program;
+   std::string compileFlags;
+};
+
+int run( const std::string& command )
+{
+   return std::system( ( command + " > /dev/null 2>&1" ).c_str() );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto runCount = getCount( argc, argv, 1, 100 );
+   auto compileCount = getCount( argc, argv, 2, 1 );
+
+   const Variant variants[] = {
+      { "full", SLIMPROGRAM_FULL, "" },
+      { "slim", SLIMPROGRAM_SLIM, "-DARGUMENTUM_SLIM" },
+   };
+
+   for ( auto& variant : variants ) {
+      std::cout << variant.name << " executable: " << std::filesystem::file_size( variant.program )
+                << " bytes\n";
+
+      auto command = variant.program + " -v --count 3 --ratio 0.5 a b c";
+      Stopwatch sw;
+      for ( size_t i = 0; i < runCount; ++i ) {
+         if ( run( command ) != 0 ) {
+            std::cout << variant.name << ": the program failed\n";
+            return 1;
+         }
+      }
+      report( variant.name + " run", runCount, sw.elapsedMs() );
+
+      auto compile = std::string( BENCH_CXX ) + " -std=c++17 -O2 -c -o /dev/null -I"
+            + BENCH_INCLUDE_DIR + " " + variant.compileFlags + " " + BENCH_SOURCE;
+      sw.restart();
+      for ( size_t i = 0; i < compileCount; ++i ) {
+         if ( run( compile ) != 0 ) {
+            std::cout << variant.name << ": the compilation failed\n";
+            return 1;
+         }
+      }
+      report( variant.name + " compile", compileCount, sw.elapsedMs() );
+   }
+}
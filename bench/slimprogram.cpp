@@ -0,0 +1,42 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// A small tool used by slim_bench to compare the full and the slim build of
+// the library.  It is built twice, with and without ARGUMENTUM_SLIM.
+
+#include <argumentum/argparse-h.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+
+int main( int argc, char** argv )
+{
+   long count = 1;
+   double ratio = 1.0;
+   bool verbose = false;
+   std::string mode;
+   std::vector<std::string> files;
+
+   auto parser = argument_parser{};
+   parser.config().program( argv[0] ).description( "Process some files." );
+   auto params = parser.params();
+   params.add_parameter( count, "--count", "-n" ).nargs( 1 ).help( "The number of passes." );
+   params.add_parameter( ratio, "--ratio" ).nargs( 1 ).help( "The compression ratio." );
+   params.add_parameter( verbose, "--verbose", "-v" ).help( "Print the progress." );
+   params.add_parameter( mode, "--mode" )
+         .choices( { "fast", "best" } )
+         .default_value( "fast" )
+         .help( "The processing mode." );
+   params.add_parameter( files, "files" ).minargs( 1 ).help( "The files to process." );
+
+   if ( !parser.parse_args( argc, argv, 1 ) )
+      return 1;
+
+   if ( verbose )
+      std::printf( "%s: %zu files, %ld passes, ratio %g\n", mode.c_str(), files.size(), count,
+            ratio );
+   return 0;
+}
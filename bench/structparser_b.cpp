@@ -0,0 +1,96 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the parse of many short command lines into new struct instances with
+// argument_parser (the parameters are defined for every instance) and with
+// struct_parser (the parameters are defined once).
+//
+// usage: structparser_bench [REQUEST_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+#include <argumentum/structparser.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+struct Request
+{
+   bool verbose = false;
+   long level = 0;
+   std::string name;
+   std::vector<long> ids;
+   std::string input;
+};
+
+void defineParameters( argument_parser& parser, Request& request )
+{
+   auto params = parser.params();
+   params.add_parameter( request.verbose, "--verbose", "-v" );
+   params.add_parameter( request.level, "--level", "-l" ).nargs( 1 );
+   params.add_parameter( request.name, "--name" ).nargs( 1 );
+   params.add_parameter( request.ids, "--ids" ).minargs( 1 );
+   params.add_parameter( request.input, "input" );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 100000 );
+   std::vector<std::string> args{ "-v", "--level", "3", "--name", "request", "--ids", "1", "2",
+      "3", "--", "input.txt" };
+
+   long checksum = 0;
+   {
+      Stopwatch watch;
+      for ( size_t i = 0; i < count; ++i ) {
+         Request request;
+         auto parser = argument_parser{};
+         defineParameters( parser, request );
+         auto res = parser.parse_args( args );
+         if ( res )
+            checksum += request.level + long( request.ids.size() );
+      }
+      report( "argument_parser, define and parse", count, watch.elapsedMs() );
+   }
+
+   {
+      Request request;
+      auto parser = argument_parser{};
+      defineParameters( parser, request );
+      Stopwatch watch;
+      for ( size_t i = 0; i < count; ++i ) {
+         request = Request{};
+         auto res = parser.parse_args( args );
+         if ( res )
+            checksum += request.level + long( request.ids.size() );
+      }
+      report( "argument_parser, parse into the same struct", count, watch.elapsedMs() );
+   }
+
+   {
+      auto parser = struct_parser<Request>{};
+      parser.add( &Request::verbose, "--verbose", "-v" );
+      parser.add( &Request::level, "--level", "-l" ).nargs( 1 );
+      parser.add( &Request::name, "--name" ).nargs( 1 );
+      parser.add( &Request::ids, "--ids" ).minargs( 1 );
+      parser.add( &Request::input, "input" );
+
+      Stopwatch watch;
+      for ( size_t i = 0; i < count; ++i ) {
+         Request request;
+         auto res = parser.parse_args( request, args );
+         if ( res )
+            checksum += request.level + long( request.ids.size() );
+      }
+      report( "struct_parser, parse into a new struct", count, watch.elapsedMs() );
+   }
+
+   std::cout << "checksum " << checksum << "\n";
+   return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the suggestions for misspelled option names in a parser with many
+// options and compare them with a scan that computes the full edit distance
+// to every name.
+//
+// usage: suggest_bench [NAME_COUNT] [QUERY_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+size_t fullDistance( std::string_view a, std::string_view b )
+{
+   std::vector<size_t> row( b.size() + 1 );
+   for ( size_t j = 0; j <= b.size(); ++j )
+      row[j] = j;
+   for ( size_t i = 1; i <= a.size(); ++i ) {
+      auto diagonal = row[0];
+      row[0] = i;
+      for ( size_t j = 1; j <= b.size(); ++j ) {
+         auto above = row[j];
+         row[j] = std::min( { row[j - 1] + 1, above + 1,
+               diagonal + ( a[i - 1] == b[j - 1] ? 0 : 1 ) } );
+         diagonal = above;
+      }
+   }
+   return row.back();
+}
+
+std::vector<std::string> scanNames(
+      const std::vector<std::string>& names, std::string_view query, size_t maxDistance )
+{
+   std::vector<std::pair<size_t, std::string>> found;
+   for ( auto& name : names ) {
+      auto d = fullDistance( query, name );
+      if ( d <= maxDistance )
+         found.emplace_back( d, name );
+   }
+   std::sort( found.begin(), found.end() );
+
+   std::vector<std::string> result;
+   for ( size_t i = 0; i < found.size() && i < 3; ++i )
+      result.push_back( found[i].second );
+   return result;
+}
+
+std::vector<std::string> makeNames( size_t count )
+{
+   static const char* words[] = { "log", "level", "max", "min", "cache", "size", "thread",
+      "count", "path", "output", "input", "format", "timeout", "retry", "buffer", "color" };
+   std::vector<std::string> names;
+   for ( size_t i = 0; i < count; ++i ) {
+      auto name = std::string( "--" ) + words[i % 16] + "-" + words[( i / 16 ) % 16];
+      names.push_back( name + "-" + std::to_string( i / 256 ) );
+   }
+   return names;
+}
+
+// Misspell the names by swapping two characters.
+std::vector<std::string> makeQueries( const std::vector<std::string>& names, size_t count )
+{
+   std::mt19937 rng( 3 );
+   std::vector<std::string> queries;
+   for ( size_t i = 0; i < count; ++i ) {
+      auto query = names[rng() % names.size()];
+      auto pos = 2 + rng() % ( query.size() - 3 );
+      std::swap( query[pos], query[pos + 1] );
+      queries.push_back( query );
+   }
+   return queries;
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto nameCount = getCount( argc, argv, 1, 10000 );
+   auto queryCount = getCount( argc, argv, 2, 1000 );
+   auto names = makeNames( nameCount );
+   auto queries = makeQueries( names, queryCount );
+
+   Stopwatch sw;
+   size_t found = 0;
+   for ( auto& query : queries )
+      found += scanNames( names, query, 3 ).size();
+   report( "full distance scan", queryCount, sw.elapsedMs() );
+
+   sw.restart();
+   NameSuggester suggester;
+   for ( auto& name : names )
+      suggester.insert( name );
+   report( "build suggester", nameCount, sw.elapsedMs() );
+
+   sw.restart();
+   size_t suggested = 0;
+   for ( auto& query : queries )
+      suggested += suggester.suggest( query, 3, 3 ).size();
+   report( "suggester", queryCount, sw.elapsedMs() );
+
+   // The parser reports every unknown option with suggestions.
+   std::deque<bool> targets( nameCount );
+   auto parser = argument_parser{};
+   std::stringstream strout;
+   parser.config().cout( strout );
+   auto params = parser.params();
+   for ( size_t i = 0; i < nameCount; ++i )
+      params.add_parameter( targets[i], names[i] );
+
+   sw.restart();
+   auto res = parser.parse_args( queries );
+   report( "parse unknown options", queryCount, sw.elapsedMs() );
+
+   if ( res || found != suggested )
+      std::cout << "unexpected result: " << found << " != " << suggested << "\n";
+   return 0;
+}
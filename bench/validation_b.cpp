@@ -0,0 +1,75 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the repeated parse of a few arguments with a parser that has many
+// options.  The options are either in no groups or in required and exclusive
+// groups which have to be validated after every parse.  The targets are reset
+// on touch so that the validation is not hidden by the reset of the targets.
+//
+// usage: validation_bench [OPTION_COUNT] [PARSE_COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+namespace {
+constexpr size_t optionsPerGroup = 50;
+
+void measure( std::string_view name, size_t optionCount, size_t parseCount, bool useGroups )
+{
+   std::vector<int> values( optionCount );
+   std::vector<std::string> names( optionCount );
+   auto parser = argument_parser{};
+   parser.config().value_reset( EValueReset::onTouch );
+   auto params = parser.params();
+   for ( size_t i = 0; i < optionCount; ++i ) {
+      auto group = i / optionsPerGroup;
+      if ( useGroups && i % optionsPerGroup == 0 ) {
+         auto groupName = "group-" + std::to_string( group );
+         if ( group % 2 == 0 )
+            params.add_group( groupName ).required( true );
+         else
+            params.add_exclusive_group( groupName );
+      }
+      names[i] = "--option-" + std::to_string( i );
+      params.add_parameter( values[i], names[i] );
+      if ( useGroups && i % optionsPerGroup == optionsPerGroup - 1 )
+         params.end_group();
+   }
+   if ( useGroups )
+      params.end_group();
+
+   // Use one option from each required group so that the parse succeeds.
+   std::vector<std::string> args;
+   for ( size_t i = 0; i < optionCount; i += 2 * optionsPerGroup )
+      args.push_back( names[i] );
+
+   size_t failed = 0;
+   Stopwatch watch;
+   for ( size_t i = 0; i < parseCount; ++i ) {
+      auto res = parser.parse_args( args );
+      failed += res ? 0 : 1;
+   }
+   auto ms = watch.elapsedMs();
+   if ( failed > 0 )
+      std::cout << "FAILED " << failed << " ";
+   report( name, parseCount, ms );
+}
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   auto optionCount = getCount( argc, argv, 1, 10000 );
+   auto parseCount = getCount( argc, argv, 2, 200 );
+
+   measure( "parse without groups", optionCount, parseCount, false );
+   measure( "parse with groups", optionCount, parseCount, true );
+
+   return 0;
+}
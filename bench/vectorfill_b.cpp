@@ -0,0 +1,69 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// Measure the time needed to fill large vector targets from positional
+// arguments and from option arguments.
+//
+// usage: vectorfill_bench [COUNT]
+
+#include "benchutil.h"
+
+#include <argumentum/argparse.h>
+
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace benchutil;
+
+int main( int argc, char** argv )
+{
+   auto count = getCount( argc, argv, 1, 10'000'000 );
+
+   std::vector<std::string> args;
+   args.reserve( count + 1 );
+   for ( size_t i = 0; i < count; ++i )
+      args.push_back( "/data/input/file-" + std::to_string( i ) );
+
+   {
+      std::vector<std::string> paths;
+      auto parser = argument_parser{};
+      parser.params().add_parameter( paths, "paths" ).minargs( 0 );
+
+      Stopwatch sw;
+      auto res = parser.parse_args( args );
+      report( "positional vector<string>", paths.size(), sw.elapsedMs() );
+      if ( !res )
+         return 1;
+   }
+
+   for ( size_t i = 0; i < count; ++i )
+      args[i] = std::to_string( i );
+   args.insert( args.begin(), "--numbers" );
+
+   {
+      std::vector<long> numbers;
+      auto parser = argument_parser{};
+      parser.params().add_parameter( numbers, "--numbers" ).minargs( 0 );
+
+      Stopwatch sw;
+      auto res = parser.parse_args( args );
+      report( "option vector<long>", numbers.size(), sw.elapsedMs() );
+      if ( !res )
+         return 1;
+   }
+
+   {
+      std::vector<long> numbers;
+      auto parser = argument_parser{};
+      parser.params().add_parameter( numbers, "--numbers" ).minargs( 0 ).parallel();
+
+      Stopwatch sw;
+      auto res = parser.parse_args( args );
+      report( "option vector<long>, parallel", numbers.size(), sw.elapsedMs() );
+      if ( !res )
+         return 1;
+   }
+
+   return 0;
+}
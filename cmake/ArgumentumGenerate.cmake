@@ -0,0 +1,43 @@
+# argumentum_generate_parser( <target> SCHEMA <schema-file> [OUTPUT <header-name>] )
+#
+# Generate a static parser from a schema file with argumentum-gen and add the
+# generated header to <target>.  The header is written to the directory
+# argumentum-gen in the current binary directory which is added to the include
+# directories of <target>.  The default name of the header is
+# <schema-name>_args.h.
+function( argumentum_generate_parser target )
+   cmake_parse_arguments( ARG "" "SCHEMA;OUTPUT" "" ${ARGN} )
+
+   if( NOT ARG_SCHEMA )
+      message( FATAL_ERROR "argumentum_generate_parser: SCHEMA is required" )
+   endif()
+
+   get_filename_component( schema "${ARG_SCHEMA}" ABSOLUTE )
+   if( NOT ARG_OUTPUT )
+      get_filename_component( schema_name "${schema}" NAME_WE )
+      set( ARG_OUTPUT "${schema_name}_args.h" )
+   endif()
+
+   if( TARGET argumentum-gen )
+      set( generator argumentum-gen )
+   elseif( TARGET Argumentum::argumentum-gen )
+      set( generator Argumentum::argumentum-gen )
+   else()
+      message( FATAL_ERROR "argumentum_generate_parser: argumentum-gen is not available" )
+   endif()
+
+   set( output_dir "${CMAKE_CURRENT_BINARY_DIR}/argumentum-gen" )
+   set( output "${output_dir}/${ARG_OUTPUT}" )
+
+   add_custom_command(
+      OUTPUT "${output}"
+      COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+      COMMAND $<TARGET_FILE:${generator}> "${schema}" "${output}"
+      DEPENDS "${schema}" ${generator}
+      COMMENT "Generating parser ${ARG_OUTPUT}"
+      VERBATIM
+      )
+
+   target_sources( ${target} PRIVATE "${output}" )
+   target_include_directories( ${target} PRIVATE "${output_dir}" )
+endfunction()
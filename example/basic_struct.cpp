@@ -1,5 +1,6 @@
 #include <argumentum/argparse.h>
 #include <climits>
+#include <iostream>
 #include <numeric>
 #include <vector>
 
@@ -12,20 +12,29 @@
 #include "../../src/argumentstream_impl.h"
 #include "../../src/command_impl.h"
 #include "../../src/commandconfig_impl.h"
+#include "../../src/completion_impl.h"
+#include "../../src/configfile_impl.h"
 #include "../../src/convert_impl.h"
+#include "../../src/definitioncache_impl.h"
 #include "../../src/environment_impl.h"
 #include "../../src/group_impl.h"
 #include "../../src/groupconfig_impl.h"
 #include "../../src/helpformatter_impl.h"
+#include "../../src/incrementalparser_impl.h"
+#include "../../src/namesuggester_impl.h"
+#include "../../src/nametrie_impl.h"
 #include "../../src/option_impl.h"
 #include "../../src/optionconfig_impl.h"
 #include "../../src/optionpack_impl.h"
 #include "../../src/optionsorter_impl.h"
+#include "../../src/optionvalidator_impl.h"
+#include "../../src/parallel_impl.h"
 #include "../../src/parameterconfig_impl.h"
 #include "../../src/parser_impl.h"
 #include "../../src/parserconfig_impl.h"
 #include "../../src/parserdefinition_impl.h"
 #include "../../src/parseresult_impl.h"
+#include "../../src/stringpool_impl.h"
 #include "../../src/value_impl.h"
 #include "../../src/writer_impl.h"
 
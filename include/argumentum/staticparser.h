@@ -0,0 +1,6 @@
+// Copyright (c) 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "../../src/staticparser.h"
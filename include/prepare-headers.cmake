@@ -29,3 +29,17 @@ if( P_HEADERONLY )
    file( WRITE ${P_BINARY_DIR}/argumentum/argparse-h.h
       "${main_header}" )
 endif()
+
+# The asynchronous parser is an optional C++20 header.  The static parser is
+# used by the code generated with argumentum-gen.  The struct parser binds the
+# options to the members of a struct.
+foreach( optional_header asyncparse.h staticparser.h structparser.h )
+   file( READ ${P_SOURCE_DIR}/argumentum/${optional_header}
+      optional_content )
+
+   string( REPLACE "../../src/" "inc/"
+      optional_content "${optional_content}" )
+
+   file( WRITE ${P_BINARY_DIR}/argumentum/${optional_header}
+      "${optional_content}" )
+endforeach()
@@ -10,7 +10,6 @@
 #include "option.h"
 #include "parser.h"
 
-#include <sstream>
 #include <string>
 
 namespace argumentum {
@@ -24,7 +23,11 @@ ARGUMENTUM_INLINE ArgumentHelpResult ArgumentDescriber::describe_argument(
       if ( pOpt->hasName( name ) )
          return describeOption( *pOpt );
 
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   return {};
+#else
    throw std::invalid_argument( "Unknown option." );
+#endif
 }
 
 ARGUMENTUM_INLINE std::vector<ArgumentHelpResult> ArgumentDescriber::describe_arguments(
@@ -94,9 +97,9 @@ ARGUMENTUM_INLINE std::string ArgumentDescriber::describeArguments(
    } );
 
    unsigned closecount = 0;
-   auto getOpenBracket( [&closecount]( std::stringstream& res ) {
+   auto getOpenBracket( [&closecount]( const std::string& res ) {
       ++closecount;
-      return res.tellp() == 0 ? "[" : " [";
+      return res.empty() ? "[" : " [";
    } );
 
    unsigned ivar = 0;
@@ -104,40 +107,44 @@ ARGUMENTUM_INLINE std::string ArgumentDescriber::describeArguments(
    if ( mmin < 0 )
       mmin = 0;
 
-   std::stringstream res;
+   std::string res;
    if ( mmin > 0 ) {
       // Mandatory parameters
-      res << getMetavar( 0 );
+      res += getMetavar( 0 );
       for ( ivar = 1; ivar < unsigned( mmin ); ++ivar )
-         res << " " << getMetavar( ivar );
+         res += " " + getMetavar( ivar );
    }
 
    if ( mmax < mmin ) {
       // Optional parameters, unlimited
-      while ( ivar < metavars.size() - 1 )
-         res << getOpenBracket( res ) << getMetavar( ivar++ );
+      while ( ivar < metavars.size() - 1 ) {
+         res += getOpenBracket( res );
+         res += getMetavar( ivar++ );
+      }
 
-      res << getOpenBracket( res ) << getMetavar( ivar ) << " ...";
+      res += getOpenBracket( res );
+      res += getMetavar( ivar ) + " ...";
    }
    else if ( mmax > mmin ) {
       // Optional parameters, limited
       auto limit = std::min<size_t>( mmax - 1, metavars.size() - 1 );
-      while ( ivar < limit )
-         res << getOpenBracket( res ) << getMetavar( ivar++ );
+      while ( ivar < limit ) {
+         res += getOpenBracket( res );
+         res += getMetavar( ivar++ );
+      }
 
       auto remaining = mmax - limit;
+      res += getOpenBracket( res );
       if ( remaining == 1 )
-         res << getOpenBracket( res ) + getMetavar( ivar );
-      else {
-         res << getOpenBracket( res ) << getMetavar( ivar ) << " {0.."
-             << std::to_string( remaining ) << "}";
-      }
+         res += getMetavar( ivar );
+      else
+         res += getMetavar( ivar ) + " {0.." + std::to_string( remaining ) + "}";
    }
 
    if ( closecount > 0 )
-      res << std::string( closecount, ']' );
+      res += std::string( closecount, ']' );
 
-   return res.str();
+   return res;
 }
 
 }   // namespace argumentum
@@ -6,20 +6,29 @@
 #include "argumentstream_impl.h"
 #include "command_impl.h"
 #include "commandconfig_impl.h"
+#include "completion_impl.h"
+#include "configfile_impl.h"
 #include "convert_impl.h"
+#include "definitioncache_impl.h"
 #include "environment_impl.h"
 #include "group_impl.h"
 #include "groupconfig_impl.h"
 #include "helpformatter_impl.h"
+#include "incrementalparser_impl.h"
+#include "namesuggester_impl.h"
+#include "nametrie_impl.h"
 #include "option_impl.h"
 #include "optionconfig_impl.h"
 #include "optionpack_impl.h"
 #include "optionsorter_impl.h"
+#include "optionvalidator_impl.h"
+#include "parallel_impl.h"
 #include "parameterconfig_impl.h"
 #include "parser_impl.h"
 #include "parserconfig_impl.h"
 #include "parserdefinition_impl.h"
 #include "parseresult_impl.h"
+#include "stringpool_impl.h"
 #include "value_impl.h"
 #include "writer_impl.h"
 
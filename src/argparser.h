@@ -5,9 +5,13 @@
 
 #include "argumentstream.h"
 #include "commandconfig.h"
+#include "completion.h"
+#include "configfile.h"
 #include "environment.h"
 #include "groupconfig.h"
 #include "helpformatter.h"
+#include "incrementalparser.h"
+#include "nametrie.h"
 #include "optionconfig.h"
 #include "optionfactory.h"
 #include "optionpack.h"
@@ -15,12 +19,12 @@
 #include "parserconfig.h"
 #include "parserdefinition.h"
 #include "parseresult.h"
+#include "stringpool.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <functional>
-#include <iostream>
 #include <map>
 #include <memory>
 #include <optional>
@@ -32,6 +36,8 @@ namespace argumentum {
 class argument_parser
 {
    friend class Parser;
+   friend class incremental_parser;
+   friend class completion_engine;
    friend class ParameterConfig;
 
 private:
@@ -161,19 +167,33 @@ public:
    // Parse input arguments and return errors in a ParseResult.
    ParseResult parse_args( ArgumentStream& args );
 
+   // Start a parse that receives the input arguments in chunks.  The parser
+   // must outlive the returned incremental_parser.
+   incremental_parser begin_parse();
+
    ArgumentHelpResult describe_argument( std::string_view name ) const;
    std::vector<ArgumentHelpResult> describe_arguments() const;
 
+   // The errors in the definitions of the parameters.  The errors are
+   // collected only when the exceptions are disabled (ARGUMENTUM_NO_EXCEPTIONS);
+   // otherwise the definition methods throw.  The errors are also reported as
+   // INVALID_DEFINITION by every parse.
+   std::vector<std::string> definition_errors() const;
+
+   // Measure the memory used by the definitions of the options of this
+   // parser.
+   ParserMemoryUsage memory_usage() const;
+
 private:
    static argument_parser createSubParser();
    void resetOptionValues();
-   void assignDefaultValues();
+   void assignDefaultValues( ParseResultBuilder& result );
    void verifyDefinedOptions();
    void validateParsedOptions( ParseResultBuilder& result );
-   void reportMissingOptions( ParseResultBuilder& result );
    bool hasRequiredArguments() const;
-   void reportExclusiveViolations( ParseResultBuilder& result );
-   void reportMissingGroups( ParseResultBuilder& result );
+   // Show the help if the parser has required arguments and there are no
+   // input arguments.
+   std::optional<ParseResult> showHelpWithoutArguments();
    void describe_errors( ParseResult& result );
    // TODO (mmahnic): remove, moved to ParameterConfig
    OptionFactory& getOptionFactory();
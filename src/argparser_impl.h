@@ -7,6 +7,7 @@
 
 #include "argdescriber.h"
 #include "command.h"
+#include "definitioncache.h"
 #include "exceptions.h"
 #include "group.h"
 #include "notifier.h"
@@ -53,11 +54,20 @@ ARGUMENTUM_INLINE ParseResult argument_parser::parse_args( int argc, char** argv
       return res.getResult();
    }
 
-   std::vector<std::string> args;
+   // The arguments are read from argv without copying.
+   std::vector<std::string_view> args;
    for ( int i = std::max( 0, skip_args ); i < argc; ++i )
       args.emplace_back( argv[i] );
 
-   return parse_args( std::begin( args ), std::end( args ) );
+   if ( args.empty() ) {
+      auto help = showHelpWithoutArguments();
+      if ( help )
+         return std::move( *help );
+   }
+
+   auto pArgs = args.data();
+   auto argStream = ContiguousArgumentStream( pArgs, pArgs + args.size() );
+   return parse_args( argStream );
 }
 
 ARGUMENTUM_INLINE ParseResult argument_parser::parse_args(
@@ -75,51 +85,49 @@ ARGUMENTUM_INLINE ParseResult argument_parser::parse_args(
       std::vector<std::string>::const_iterator iend )
 {
    if ( ibegin == iend ) {
-      verifyDefinedOptions();
-      if ( hasRequiredArguments() ) {
-         ParseResultBuilder result;
-
-         auto config = getConfig();
-         auto pFormatter = config.help_formatter( "" );
-         auto pStream = config.output_stream();
-         assert( pFormatter && pStream );
-
-         pFormatter->format( mParserDef, *pStream );
-         result.signalHelpShown();
-         result.requestExit();
-
-         return std::move( result.getResult() );
-      }
+      auto help = showHelpWithoutArguments();
+      if ( help )
+         return std::move( *help );
    }
 
    auto argStream = IteratorArgumentStream( ibegin, iend );
    return parse_args( argStream );
 }
 
-ARGUMENTUM_INLINE ParseResult argument_parser::parse_args( ArgumentStream& args )
+ARGUMENTUM_INLINE std::optional<ParseResult> argument_parser::showHelpWithoutArguments()
 {
    verifyDefinedOptions();
-   resetOptionValues();
+   // The required options may be set from the environment so the input
+   // is parsed and the missing options are reported.
+   if ( !hasRequiredArguments() || mParserDef.hasEnvironmentOptions() )
+      return {};
 
    ParseResultBuilder result;
-   Parser parser( mParserDef, result );
-   parser.parse( args );
-   if ( result.wasExitRequested() )
-      return std::move( result.getResult() );
-
-   assignDefaultValues();
-   validateParsedOptions( result );
-
-   if ( mTopLevel && result.hasArgumentProblems() ) {
-      result.signalErrorsShown();
-      auto res = std::move( result.getResult() );
-      describe_errors( res );
-      return res;
-   }
+
+   auto config = getConfig();
+   auto pFormatter = config.help_formatter( "" );
+   auto pSink = config.output_sink();
+   assert( pFormatter && pSink );
+
+   pFormatter->format( mParserDef, *pSink );
+   result.signalHelpShown();
+   result.requestExit();
 
    return std::move( result.getResult() );
 }
 
+ARGUMENTUM_INLINE ParseResult argument_parser::parse_args( ArgumentStream& args )
+{
+   auto parse = begin_parse();
+   parse.feed( args );
+   return parse.finish();
+}
+
+ARGUMENTUM_INLINE incremental_parser argument_parser::begin_parse()
+{
+   return incremental_parser( *this );
+}
+
 ARGUMENTUM_INLINE ArgumentHelpResult argument_parser::describe_argument(
       std::string_view name ) const
 {
@@ -133,24 +141,32 @@ ARGUMENTUM_INLINE std::vector<ArgumentHelpResult> argument_parser::describe_argu
    return describer.describe_arguments( mParserDef );
 }
 
-ARGUMENTUM_INLINE void argument_parser::resetOptionValues()
+ARGUMENTUM_INLINE std::vector<std::string> argument_parser::definition_errors() const
 {
-   for ( auto& pOption : mParserDef.mOptions )
-      pOption->resetValue();
+   return mParserDef.getDefinitionErrors();
+}
 
-   for ( auto& pOption : mParserDef.mPositional )
-      pOption->resetValue();
+ARGUMENTUM_INLINE ParserMemoryUsage argument_parser::memory_usage() const
+{
+   return mParserDef.getMemoryUsage();
 }
 
-ARGUMENTUM_INLINE void argument_parser::assignDefaultValues()
+ARGUMENTUM_INLINE void argument_parser::resetOptionValues()
 {
-   for ( auto& pOption : mParserDef.mOptions )
-      if ( !pOption->wasAssigned() && pOption->hasDefault() )
-         pOption->assignDefault();
+   mParserDef.startParse();
+}
 
-   for ( auto& pOption : mParserDef.mPositional )
-      if ( !pOption->wasAssigned() && pOption->hasDefault() )
-         pOption->assignDefault();
+ARGUMENTUM_INLINE void argument_parser::assignDefaultValues( ParseResultBuilder& result )
+{
+   auto& validator = mParserDef.getValidator();
+   for ( auto pOption : mParserDef.getDefaultOptions() ) {
+      auto& option = *pOption;
+      if ( !option.wasAssigned() ) {
+         option.assignDefault();
+         validator.markAssigned( option );
+         result.addValueSource( { option.getName(), EValueSource::defaultValue, {}, 0 } );
+      }
+   }
 }
 
 ARGUMENTUM_INLINE void argument_parser::verifyDefinedOptions()
@@ -158,100 +174,72 @@ ARGUMENTUM_INLINE void argument_parser::verifyDefinedOptions()
    // Check if any help options are defined and add the default if not.
    if ( mParserDef.mHelpOptionNames.empty() ) {
       params().end_group();
-      try {
-         params().add_default_help_option();
-      }
-      catch ( const std::invalid_argument& ) {
+      if ( mParserDef.findOption( "-h" ) && mParserDef.findOption( "--help" ) )
          Notifier::warn( "Failed to add default help options." );
-      }
+      else
+         params().add_default_help_option();
    }
 
+   if ( mParserDef.isFinalized() )
+      return;
+
    // A required option can not be in an exclusive group.
    for ( auto& pOption : mParserDef.mOptions ) {
       if ( pOption->isRequired() ) {
          auto pGroup = pOption->getGroup();
-         if ( pGroup && pGroup->isExclusive() )
-            throw RequiredExclusiveOption( pOption->getName(), pGroup->getName() );
+         if ( pGroup && pGroup->isExclusive() ) {
+            throw_or_report( RequiredExclusiveOption( pOption->getName(), pGroup->getName() ),
+                  [&]( std::string_view message ) {
+                     pOption->addDefinitionError( message );
+                  } );
+         }
       }
    }
-}
-
-ARGUMENTUM_INLINE void argument_parser::validateParsedOptions( ParseResultBuilder& result )
-{
-   reportMissingOptions( result );
-   reportExclusiveViolations( result );
-   reportMissingGroups( result );
-}
-
-ARGUMENTUM_INLINE void argument_parser::reportMissingOptions( ParseResultBuilder& result )
-{
-   for ( auto& pOption : mParserDef.mOptions )
-      if ( pOption->isRequired() && !pOption->wasAssigned() )
-         result.addError( pOption->getHelpName(), MISSING_OPTION );
-
-   for ( auto& pOption : mParserDef.mPositional )
-      // A positional option must have enough arguments.
-      if ( pOption->needsMoreArguments() )
-         // If it is optional, it may have no arguments.
-         if ( pOption->isRequired() || pOption->wasAssigned() )
-            result.addError( pOption->getHelpName(), MISSING_ARGUMENT );
-}
 
-ARGUMENTUM_INLINE bool argument_parser::hasRequiredArguments() const
-{
-   for ( auto& pOption : mParserDef.mOptions )
-      if ( pOption->isRequired() )
-         return true;
-
-   for ( auto& pOption : mParserDef.mPositional )
-      if ( pOption->isRequired() )
-         return true;
+   mParserDef.buildLongNameIndex();
+   mParserDef.buildEnvironmentIndex();
+   mParserDef.buildValidator();
+   mParserDef.buildResetIndex();
+
+   // The definitions are complete.  Store them if the cache is missing or
+   // stale.  A cache that can not be written is ignored.
+   auto pCache = mParserDef.getDefinitionCache();
+   if ( pCache ) {
+      auto& config = getConfig();
+      pCache->update( config.definition_cache_path(), config.definition_schema(), mParserDef );
+   }
 
-   return false;
+   mParserDef.markFinalized();
 }
 
-ARGUMENTUM_INLINE void argument_parser::reportExclusiveViolations( ParseResultBuilder& result )
+ARGUMENTUM_INLINE void argument_parser::validateParsedOptions( ParseResultBuilder& result )
 {
-   std::map<std::string, std::vector<std::string>> counts;
-   for ( auto& pOption : mParserDef.mOptions ) {
-      auto pGroup = pOption->getGroup();
-      if ( pGroup && pGroup->isExclusive() && pOption->wasAssignedThroughThisOption() )
-         counts[pGroup->getName()].push_back( pOption->getHelpName() );
-   }
-
-   for ( auto& c : counts )
-      if ( c.second.size() > 1 )
-         result.addError( c.second.front(), EXCLUSIVE_OPTION );
+   auto& validator = mParserDef.getValidator();
+   validator.reportMissingOptions( result );
+   validator.reportExclusiveViolations( result );
+   validator.reportMissingGroups( result );
 }
 
-ARGUMENTUM_INLINE void argument_parser::reportMissingGroups( ParseResultBuilder& result )
+ARGUMENTUM_INLINE bool argument_parser::hasRequiredArguments() const
 {
-   std::map<std::string, int> counts;
-   for ( auto& pOption : mParserDef.mOptions ) {
-      auto pGroup = pOption->getGroup();
-      if ( pGroup && pGroup->isRequired() )
-         counts[pGroup->getName()] += pOption->wasAssigned() ? 1 : 0;
-   }
-
-   for ( auto& c : counts )
-      if ( c.second < 1 )
-         result.addError( c.first, MISSING_OPTION_GROUP );
+   return mParserDef.getValidator().hasRequired();
 }
 
 ARGUMENTUM_INLINE void argument_parser::describe_errors( ParseResult& result )
 {
-   auto pStream = mParserDef.getConfig().output_stream();
-   assert( pStream );
+   auto pSink = mParserDef.getConfig().output_sink();
+   assert( pSink );
 
    for ( const auto& e : result.errors )
-      e.describeError( *pStream );
+      e.describeError( *pSink );
 
    if ( !result.ignoredArguments.empty() ) {
       auto it = result.ignoredArguments.begin();
-      *pStream << "Error: Ignored arguments: " << *it;
+      std::string text = "Error: Ignored arguments: " + *it;
       for ( ++it; it != result.ignoredArguments.end(); ++it )
-         *pStream << ", " << *it;
-      *pStream << "\n";
+         text += ", " + *it;
+      text += "\n";
+      pSink->write( text );
    }
 }
 
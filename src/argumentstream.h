@@ -7,10 +7,59 @@
 #include <istream>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace argumentum {
 
+class MappedFile;
+
+// A range of arguments that are stored contiguously in memory.
+class ArgumentWindow
+{
+   const std::string_view* mpBegin = nullptr;
+   const std::string_view* mpEnd = nullptr;
+
+public:
+   ArgumentWindow() = default;
+   ArgumentWindow( const std::string_view* pBegin, const std::string_view* pEnd )
+      : mpBegin( pBegin )
+      , mpEnd( pEnd )
+   {}
+
+   const std::string_view* begin() const
+   {
+      return mpBegin;
+   }
+
+   const std::string_view* end() const
+   {
+      return mpEnd;
+   }
+
+   size_t size() const
+   {
+      return size_t( mpEnd - mpBegin );
+   }
+
+   bool empty() const
+   {
+      return mpBegin == mpEnd;
+   }
+
+   std::string_view operator[]( size_t index ) const
+   {
+      return mpBegin[index];
+   }
+
+   // The arguments that follow the first @p count arguments of the window.
+   ArgumentWindow tail( size_t count ) const
+   {
+      return { mpBegin + count, mpEnd };
+   }
+};
+
 class ArgumentStream
 {
 public:
@@ -33,15 +82,32 @@ public:
    //
    // An implementation may choose to not support peeking.
    virtual void peek( std::function<EPeekResult( std::string_view )> fnPeek );
+
+   // Returns the arguments from the current position that are stored
+   // contiguously in memory.  The parser reads the arguments of the window
+   // directly and moves the current position with advance().  The window is
+   // valid until the next call to a method of the stream.
+   //
+   // The default implementation returns an empty window and the arguments are
+   // read with next().
+   virtual ArgumentWindow window();
+
+   // Moves the current position by @p count arguments.
+   virtual void advance( size_t count );
 };
 
 // An implementation of ArgumentStream that reads arguments from a string
 // container.
+//
+// The views of the arguments are created by the first call to window().
 template<typename TIter>
 class IteratorArgumentStream : public ArgumentStream
 {
    TIter current;
    TIter end;
+   std::vector<std::string_view> mViews;
+   // The position of the argument at current in mViews.
+   size_t mViewPos = 0;
 
 public:
    IteratorArgumentStream( TIter begin, TIter end )
@@ -54,9 +120,30 @@ public:
       if ( current == end )
          return {};
 
+      ++mViewPos;
       return *current++;
    }
 
+   ArgumentWindow window() override
+   {
+      if ( mViews.empty() ) {
+         for ( auto iarg = current; iarg != end; ++iarg )
+            mViews.emplace_back( *iarg );
+         mViewPos = 0;
+      }
+
+      auto pViews = mViews.data();
+      return { pViews + mViewPos, pViews + mViews.size() };
+   }
+
+   void advance( size_t count ) override
+   {
+      for ( ; count > 0 && current != end; --count ) {
+         ++current;
+         ++mViewPos;
+      }
+   }
+
    void peek( std::function<EPeekResult( std::string_view )> fnPeek ) override
    {
       if ( !fnPeek )
@@ -82,4 +169,41 @@ public:
    std::optional<std::string_view> next() override;
 };
 
+// An implementation of ArgumentStream that reads arguments from an array of
+// string views.  The array must outlive the stream.
+class ContiguousArgumentStream : public ArgumentStream
+{
+   const std::string_view* mpCurrent;
+   const std::string_view* mpEnd;
+
+public:
+   ContiguousArgumentStream( const std::string_view* pBegin, const std::string_view* pEnd );
+   std::optional<std::string_view> next() override;
+   void peek( std::function<EPeekResult( std::string_view )> fnPeek ) override;
+   ArgumentWindow window() override;
+   void advance( size_t count ) override;
+};
+
+// An implementation of ArgumentStream that maps a file into memory.  The file
+// has one argument per line.
+class MappedArgumentStream : public ArgumentStream
+{
+   std::unique_ptr<MappedFile> mpFile;
+   std::vector<std::string_view> mLines;
+   size_t mPos = 0;
+
+public:
+   MappedArgumentStream();
+   ~MappedArgumentStream();
+
+   // Map the file @p path into memory and split it into lines.  Returns false
+   // if the file can not be mapped.
+   bool open( const std::string& path );
+
+   std::optional<std::string_view> next() override;
+   void peek( std::function<EPeekResult( std::string_view )> fnPeek ) override;
+   ArgumentWindow window() override;
+   void advance( size_t count ) override;
+};
+
 }   // namespace argumentum
@@ -6,11 +6,27 @@
 
 #include "argumentstream.h"
 
+#include "definitioncache.h"
+
+#include <algorithm>
+
 namespace argumentum {
 
 ARGUMENTUM_INLINE void ArgumentStream::peek( std::function<EPeekResult( std::string_view )> )
 {}
 
+ARGUMENTUM_INLINE ArgumentWindow ArgumentStream::window()
+{
+   return {};
+}
+
+ARGUMENTUM_INLINE void ArgumentStream::advance( size_t count )
+{
+   for ( ; count > 0; --count )
+      if ( !next() )
+         break;
+}
+
 ARGUMENTUM_INLINE StdStreamArgumentStream::StdStreamArgumentStream(
       const std::shared_ptr<std::istream>& pStream )
    : mpStream( pStream )
@@ -27,4 +43,97 @@ ARGUMENTUM_INLINE std::optional<std::string_view> StdStreamArgumentStream::next(
    return mCurrent;
 }
 
+ARGUMENTUM_INLINE ContiguousArgumentStream::ContiguousArgumentStream(
+      const std::string_view* pBegin, const std::string_view* pEnd )
+   : mpCurrent( pBegin )
+   , mpEnd( pEnd )
+{}
+
+ARGUMENTUM_INLINE std::optional<std::string_view> ContiguousArgumentStream::next()
+{
+   if ( mpCurrent == mpEnd )
+      return {};
+
+   return *mpCurrent++;
+}
+
+ARGUMENTUM_INLINE void ContiguousArgumentStream::peek(
+      std::function<EPeekResult( std::string_view )> fnPeek )
+{
+   if ( !fnPeek )
+      return;
+
+   for ( auto parg = mpCurrent; parg != mpEnd; ++parg )
+      if ( fnPeek( *parg ) == peekDone )
+         break;
+}
+
+ARGUMENTUM_INLINE ArgumentWindow ContiguousArgumentStream::window()
+{
+   return { mpCurrent, mpEnd };
+}
+
+ARGUMENTUM_INLINE void ContiguousArgumentStream::advance( size_t count )
+{
+   mpCurrent += std::min<size_t>( count, mpEnd - mpCurrent );
+}
+
+ARGUMENTUM_INLINE MappedArgumentStream::MappedArgumentStream() = default;
+
+ARGUMENTUM_INLINE MappedArgumentStream::~MappedArgumentStream() = default;
+
+// The lines are split like with std::getline: a newline at the end of the
+// file does not start an empty argument.
+ARGUMENTUM_INLINE bool MappedArgumentStream::open( const std::string& path )
+{
+   mLines.clear();
+   mPos = 0;
+   mpFile = std::make_unique<MappedFile>();
+   if ( !mpFile->open( path ) ) {
+      mpFile.reset();
+      return false;
+   }
+
+   auto data = std::string_view( mpFile->data(), mpFile->size() );
+   while ( !data.empty() ) {
+      auto eol = data.find( '\n' );
+      mLines.push_back( data.substr( 0, eol ) );
+      if ( eol == std::string_view::npos )
+         break;
+      data.remove_prefix( eol + 1 );
+   }
+
+   return true;
+}
+
+ARGUMENTUM_INLINE std::optional<std::string_view> MappedArgumentStream::next()
+{
+   if ( mPos == mLines.size() )
+      return {};
+
+   return mLines[mPos++];
+}
+
+ARGUMENTUM_INLINE void MappedArgumentStream::peek(
+      std::function<EPeekResult( std::string_view )> fnPeek )
+{
+   if ( !fnPeek )
+      return;
+
+   for ( auto i = mPos; i < mLines.size(); ++i )
+      if ( fnPeek( mLines[i] ) == peekDone )
+         break;
+}
+
+ARGUMENTUM_INLINE ArgumentWindow MappedArgumentStream::window()
+{
+   auto pLines = mLines.data();
+   return { pLines + mPos, pLines + mLines.size() };
+}
+
+ARGUMENTUM_INLINE void MappedArgumentStream::advance( size_t count )
+{
+   mPos += std::min( count, mLines.size() - mPos );
+}
+
 }   // namespace argumentum
@@ -0,0 +1,242 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+// Asynchronous parsing requires C++20 coroutines.  In earlier language modes
+// this header is empty.
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+
+#include "argparser.h"
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace argumentum {
+
+// An argument stream that produces batches of arguments asynchronously, eg.
+// from a pipe or a socket.
+//
+// A batch is read with read_batch().  When no data is available the stream
+// returns wouldBlock and async_parse_args suspends.  The stream must then
+// resume the suspended coroutine through the handle passed to
+// wait_readable() when more data may be available.  The handle is usually
+// resumed by an event loop.
+class AsyncArgumentStream
+{
+public:
+   enum EReadResult { batchReady, wouldBlock, endOfStream };
+
+   class BatchAwaiter
+   {
+      AsyncArgumentStream& mStream;
+      std::vector<std::string>& mBatch;
+      EReadResult mResult = wouldBlock;
+
+   public:
+      BatchAwaiter( AsyncArgumentStream& stream, std::vector<std::string>& batch )
+         : mStream( stream )
+         , mBatch( batch )
+      {}
+
+      bool await_ready()
+      {
+         mResult = mStream.read_batch( mBatch );
+         return mResult != wouldBlock;
+      }
+
+      void await_suspend( std::coroutine_handle<> handle )
+      {
+         mStream.wait_readable( handle );
+      }
+
+      // After a suspension the batch is read again.  The result may again be
+      // wouldBlock.
+      EReadResult await_resume()
+      {
+         if ( mResult == wouldBlock )
+            mResult = mStream.read_batch( mBatch );
+         return mResult;
+      }
+   };
+
+public:
+   virtual ~AsyncArgumentStream() = default;
+
+   // Append the available arguments to @p batch.  Returns batchReady if any
+   // arguments were added, wouldBlock if the stream has to wait for more data
+   // and endOfStream when there are no more arguments.
+   virtual EReadResult read_batch( std::vector<std::string>& batch ) = 0;
+
+   // Register @p handle to be resumed when more data may be available.
+   virtual void wait_readable( std::coroutine_handle<> handle ) = 0;
+
+   // Await the next batch of arguments.
+   BatchAwaiter next_batch( std::vector<std::string>& batch )
+   {
+      return BatchAwaiter( *this, batch );
+   }
+};
+
+// The coroutine that runs an asynchronous parse.  The parse starts
+// immediately and runs until the stream has to wait for data.  The task can be
+// awaited by another coroutine or polled with done().
+class parse_task
+{
+public:
+   struct promise_type
+   {
+      // The result is stored without the check requirement so that an
+      // abandoned task can be destroyed.  The requirement is restored when
+      // the result is taken.
+      std::optional<ParseResult> mResult;
+      bool mMustCheckResult = false;
+      std::exception_ptr mpException;
+      std::coroutine_handle<> mContinuation;
+
+      parse_task get_return_object()
+      {
+         return parse_task( std::coroutine_handle<promise_type>::from_promise( *this ) );
+      }
+
+      std::suspend_never initial_suspend() noexcept
+      {
+         return {};
+      }
+
+      auto final_suspend() noexcept
+      {
+         struct FinalAwaiter
+         {
+            bool await_ready() noexcept
+            {
+               return false;
+            }
+
+            std::coroutine_handle<> await_suspend(
+                  std::coroutine_handle<promise_type> handle ) noexcept
+            {
+               auto continuation = handle.promise().mContinuation;
+               return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {}
+         };
+         return FinalAwaiter{};
+      }
+
+      void return_value( ParseResult&& result )
+      {
+         mMustCheckResult = result.mustCheck.required;
+         result.mustCheck.clear();
+         mResult.emplace( std::move( result ) );
+      }
+
+      void unhandled_exception()
+      {
+         mpException = std::current_exception();
+      }
+   };
+
+private:
+   std::coroutine_handle<promise_type> mHandle;
+
+   explicit parse_task( std::coroutine_handle<promise_type> handle )
+      : mHandle( handle )
+   {}
+
+public:
+   parse_task( parse_task&& other ) noexcept
+      : mHandle( std::exchange( other.mHandle, nullptr ) )
+   {}
+
+   parse_task& operator=( parse_task&& other ) noexcept
+   {
+      if ( this != &other ) {
+         if ( mHandle )
+            mHandle.destroy();
+         mHandle = std::exchange( other.mHandle, nullptr );
+      }
+      return *this;
+   }
+
+   parse_task( const parse_task& ) = delete;
+   parse_task& operator=( const parse_task& ) = delete;
+
+   ~parse_task()
+   {
+      if ( mHandle )
+         mHandle.destroy();
+   }
+
+   // Returns true when the parse is finished.
+   bool done() const
+   {
+      return !mHandle || mHandle.done();
+   }
+
+   // Take the result of a finished parse.  Rethrows the exception that ended
+   // the parse, if any.
+   ParseResult result()
+   {
+      assert( done() && mHandle );
+      auto& promise = mHandle.promise();
+      if ( promise.mpException )
+         std::rethrow_exception( promise.mpException );
+
+      auto result = std::move( *promise.mResult );
+      promise.mResult.reset();
+      if ( promise.mMustCheckResult )
+         result.mustCheck.activate();
+      return result;
+   }
+
+   bool await_ready() const
+   {
+      return done();
+   }
+
+   void await_suspend( std::coroutine_handle<> handle )
+   {
+      mHandle.promise().mContinuation = handle;
+   }
+
+   ParseResult await_resume()
+   {
+      return result();
+   }
+};
+
+// Parse the arguments from @p stream with @p parser.  The parser and the
+// stream must outlive the returned task.
+inline parse_task async_parse_args( argument_parser& parser, AsyncArgumentStream& stream )
+{
+   auto parse = parser.begin_parse();
+   std::vector<std::string> batch;
+
+   for ( ;; ) {
+      auto state = co_await stream.next_batch( batch );
+      if ( state == AsyncArgumentStream::endOfStream )
+         break;
+
+      if ( state == AsyncArgumentStream::batchReady ) {
+         parse.feed( batch.begin(), batch.end() );
+         batch.clear();
+      }
+   }
+
+   if ( !batch.empty() )
+      parse.feed( batch.begin(), batch.end() );
+
+   co_return parse.finish();
+}
+
+}   // namespace argumentum
+
+#endif
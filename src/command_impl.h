@@ -51,13 +51,19 @@ ARGUMENTUM_INLINE const std::string& Command::getHelp() const
 
 ARGUMENTUM_INLINE std::shared_ptr<CommandOptions> Command::getOptions()
 {
+   // Without exceptions the caller reports the missing options.
    if ( !mpOptions ) {
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+      if ( mFactory )
+         mpOptions = mFactory( mName );
+#else
       if ( !mFactory )
          throw MissingCommandOptions( mName );
 
       mpOptions = mFactory( mName );
       if ( !mpOptions )
          throw MissingCommandOptions( mName );
+#endif
    }
    return mpOptions;
 }
@@ -6,6 +6,7 @@
 #include "commandconfig.h"
 
 #include "command.h"
+#include "exceptions.h"
 
 namespace argumentum {
 
@@ -14,7 +15,7 @@ ARGUMENTUM_INLINE CommandConfig::CommandConfig( const std::shared_ptr<Command>&
 {
    assert( pCommand );
    if ( !mpCommand )
-      throw std::invalid_argument( "CommandConfig requires a command." );
+      throw_or_abort( std::invalid_argument( "CommandConfig requires a command." ) );
 }
 
 // Define the description of the command that will be displayed in the
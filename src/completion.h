@@ -0,0 +1,72 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+class argument_parser;
+class Command;
+
+enum class ECompletionShell { bash, zsh, fish };
+
+struct completion_candidate
+{
+   enum EKind { option, command, choice };
+
+   std::string value;
+   std::string help;
+   EKind kind = option;
+};
+
+// Finds the candidates for the completion of a partial command line.  The
+// words before the cursor are used to resolve the active command and the
+// active option.  The option names, the command names and the choices are
+// looked up by prefix in tries that are built when the level of the command
+// tree is first visited.  The parsers of the commands are created only for
+// the commands on the resolved path.
+//
+// An engine can answer many queries.  The parser must outlive the engine.
+class completion_engine
+{
+   class Level;
+
+   argument_parser* mpArgParser;
+   std::unique_ptr<Level> mpTopLevel;
+   std::map<const Command*, std::unique_ptr<Level>> mCommandLevels;
+
+public:
+   explicit completion_engine( argument_parser& argParser );
+   completion_engine( const completion_engine& ) = delete;
+   completion_engine& operator=( const completion_engine& ) = delete;
+   ~completion_engine();
+
+   // Complete the word @p args[cursor].  The program name is not included
+   // in @p args.  If @p cursor is past the end of @p args the partial word is
+   // empty.
+   std::vector<completion_candidate> complete(
+         const std::vector<std::string>& args, size_t cursor );
+
+   // Complete the word under the cursor in a command line.  The first word is
+   // the name of the program.  The quotes and backslashes in the line are
+   // interpreted like in a shell.
+   std::vector<completion_candidate> complete_line( std::string_view line, size_t cursorPos );
+
+   // Write the candidates in the format expected by the completion functions
+   // of the shell: bash receives one candidate per line, zsh receives
+   // `value:help` lines for _describe and fish receives `value<TAB>help` lines.
+   static void write_candidates( std::ostream& out,
+         const std::vector<completion_candidate>& candidates, ECompletionShell shell );
+
+private:
+   Level& getCommandLevel( Command& command );
+};
+
+}   // namespace argumentum
@@ -0,0 +1,339 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "completion.h"
+
+#include "argparser.h"
+#include "command.h"
+#include "nametrie.h"
+#include "option.h"
+
+#include <cctype>
+
+namespace argumentum {
+
+// The option and command names of one parser in the command tree.
+class completion_engine::Level
+{
+public:
+   std::unique_ptr<argument_parser> mpOwnedParser;
+   const ParserDefinition& mParserDef;
+   NameTrie mOptionNames;
+   NameTrie mCommandNames;
+   std::vector<Option*> mOptions;
+   std::vector<std::string_view> mOptionNameList;
+   std::vector<Command*> mCommands;
+   std::map<const Option*, NameTrie> mChoices;
+   bool mHasNumericOptions = false;
+
+public:
+   Level( const ParserDefinition& parserDef )
+      : mParserDef( parserDef )
+   {
+      for ( auto& pOption : parserDef.mOptions ) {
+         for ( auto& name : { &pOption->getShortName(), &pOption->getLongName() } ) {
+            if ( !name->empty() && mOptionNames.insert( *name, int( mOptions.size() ) ) ) {
+               mOptions.push_back( pOption.get() );
+               mOptionNameList.push_back( *name );
+            }
+         }
+      }
+
+      for ( auto& pCommand : parserDef.mCommands )
+         if ( mCommandNames.insert( pCommand->getName(), int( mCommands.size() ) ) )
+            mCommands.push_back( pCommand.get() );
+
+      mHasNumericOptions = parserDef.hasNumericOptions();
+   }
+
+   Option* findOption( std::string_view name ) const
+   {
+      auto index = mOptionNames.find( name );
+      return index < 0 ? nullptr : mOptions[index];
+   }
+
+   Command* findCommand( std::string_view name ) const
+   {
+      auto index = mCommandNames.find( name );
+      return index < 0 ? nullptr : mCommands[index];
+   }
+
+   bool isOption( std::string_view arg ) const
+   {
+      if ( arg.size() < 2 || arg[0] != '-' )
+         return false;
+      if ( std::isdigit( static_cast<unsigned char>( arg[1] ) ) )
+         return mHasNumericOptions || findOption( arg ) != nullptr;
+      return true;
+   }
+
+   // Find the option that receives the values following @p arg.  In a group
+   // of short options only the last one can receive values.
+   Option* findStartedOption( std::string_view arg ) const
+   {
+      if ( arg.substr( 0, 2 ) == "--" )
+         return findOption( arg.substr( 0, arg.find( '=' ) ) );
+
+      auto pOption = findOption( arg );
+      if ( !pOption && arg.size() > 2 ) {
+         char name[] = { '-', arg.back(), 0 };
+         pOption = findOption( name );
+      }
+      return pOption;
+   }
+
+   // Find the positional parameter that receives the free argument at
+   // @p position.
+   Option* findPositional( size_t position ) const
+   {
+      for ( auto& pOption : mParserDef.mPositional ) {
+         auto [minArgs, maxArgs] = pOption->getArgumentCounts();
+         if ( maxArgs < 0 || position < size_t( std::max( minArgs, maxArgs ) ) )
+            return pOption.get();
+         position -= std::max( minArgs, maxArgs );
+      }
+      return nullptr;
+   }
+
+   const NameTrie& getChoices( const Option& option )
+   {
+      auto it = mChoices.find( &option );
+      if ( it != mChoices.end() )
+         return it->second;
+
+      auto& trie = mChoices[&option];
+      auto& choices = option.getChoices();
+      for ( size_t i = 0; i < choices.size(); ++i )
+         trie.insert( choices[i], int( i ) );
+      return trie;
+   }
+
+   void addChoices( const Option& option, std::string_view prefix, std::string_view valuePrefix,
+         std::vector<completion_candidate>& candidates )
+   {
+      auto& choices = option.getChoices();
+      if ( choices.empty() )
+         return;
+
+      for ( auto index : getChoices( option ).findPrefixed( valuePrefix ) ) {
+         candidates.push_back( { std::string( prefix ).append( choices[index] ), {},
+               completion_candidate::choice } );
+      }
+   }
+
+   void addOptions( std::string_view prefix, std::vector<completion_candidate>& candidates ) const
+   {
+      for ( auto index : mOptionNames.findPrefixed( prefix ) ) {
+         candidates.push_back( { std::string( mOptionNameList[index] ),
+               std::string( mOptions[index]->getRawHelp() ), completion_candidate::option } );
+      }
+   }
+
+   void addCommands( std::string_view prefix, std::vector<completion_candidate>& candidates ) const
+   {
+      for ( auto index : mCommandNames.findPrefixed( prefix ) ) {
+         auto pCommand = mCommands[index];
+         candidates.push_back(
+               { pCommand->getName(), pCommand->getHelp(), completion_candidate::command } );
+      }
+   }
+};
+
+ARGUMENTUM_INLINE completion_engine::completion_engine( argument_parser& argParser )
+   : mpArgParser( &argParser )
+{
+   mpArgParser->verifyDefinedOptions();
+   mpTopLevel = std::make_unique<Level>( mpArgParser->getDefinition() );
+}
+
+ARGUMENTUM_INLINE completion_engine::~completion_engine() = default;
+
+ARGUMENTUM_INLINE completion_engine::Level& completion_engine::getCommandLevel( Command& command )
+{
+   auto it = mCommandLevels.find( &command );
+   if ( it != mCommandLevels.end() )
+      return *it->second;
+
+   auto pParser = std::make_unique<argument_parser>( argument_parser::createSubParser() );
+   auto pCmdOptions = command.getOptions();
+   if ( pCmdOptions )
+      pParser->params().add_parameters( pCmdOptions );
+   pParser->verifyDefinedOptions();
+
+   auto pLevel = std::make_unique<Level>( pParser->getDefinition() );
+   pLevel->mpOwnedParser = std::move( pParser );
+   auto& level = *pLevel;
+   mCommandLevels[&command] = std::move( pLevel );
+   return level;
+}
+
+ARGUMENTUM_INLINE std::vector<completion_candidate> completion_engine::complete(
+      const std::vector<std::string>& args, size_t cursor )
+{
+   auto pLevel = mpTopLevel.get();
+   const Option* pActive = nullptr;
+   int activeCount = 0;
+   size_t freeCount = 0;
+   bool ignoreOptions = false;
+
+   // Resolve the command and the active option from the complete words.
+   for ( size_t i = 0; i < std::min( cursor, args.size() ); ++i ) {
+      std::string_view arg = args[i];
+      if ( !ignoreOptions && arg == "--" ) {
+         ignoreOptions = true;
+         pActive = nullptr;
+         continue;
+      }
+
+      if ( !ignoreOptions && pLevel->isOption( arg ) ) {
+         pActive = pLevel->findStartedOption( arg );
+         if ( pActive && ( !pActive->acceptsAnyArguments() || arg.find( '=' ) != arg.npos ) )
+            pActive = nullptr;
+         activeCount = 0;
+         continue;
+      }
+
+      if ( pActive ) {
+         auto maxArgs = std::get<1>( pActive->getArgumentCounts() );
+         if ( maxArgs < 0 || activeCount < maxArgs ) {
+            ++activeCount;
+            continue;
+         }
+         pActive = nullptr;
+      }
+
+      auto pCommand = pLevel->findCommand( arg );
+      if ( pCommand ) {
+         pLevel = &getCommandLevel( *pCommand );
+         freeCount = 0;
+         ignoreOptions = false;
+         continue;
+      }
+
+      ++freeCount;
+   }
+
+   std::vector<completion_candidate> candidates;
+   std::string_view partial = cursor < args.size() ? args[cursor] : std::string_view{};
+
+   // The value of an option in the same word: --name=value.
+   auto eqpos = partial.find( '=' );
+   if ( !ignoreOptions && partial.substr( 0, 2 ) == "--" && eqpos != partial.npos ) {
+      auto pOption = pLevel->findOption( partial.substr( 0, eqpos ) );
+      if ( pOption )
+         pLevel->addChoices(
+               *pOption, partial.substr( 0, eqpos + 1 ), partial.substr( eqpos + 1 ), candidates );
+      return candidates;
+   }
+
+   if ( pActive ) {
+      auto [minArgs, maxArgs] = pActive->getArgumentCounts();
+      if ( maxArgs < 0 || activeCount < maxArgs ) {
+         pLevel->addChoices( *pActive, {}, partial, candidates );
+         if ( activeCount < minArgs )
+            return candidates;
+      }
+   }
+
+   if ( !ignoreOptions && partial.substr( 0, 1 ) == "-" ) {
+      pLevel->addOptions( partial, candidates );
+      return candidates;
+   }
+
+   if ( !ignoreOptions )
+      pLevel->addCommands( partial, candidates );
+
+   auto pPositional = pLevel->findPositional( freeCount );
+   if ( pPositional )
+      pLevel->addChoices( *pPositional, {}, partial, candidates );
+
+   return candidates;
+}
+
+ARGUMENTUM_INLINE std::vector<completion_candidate> completion_engine::complete_line(
+      std::string_view line, size_t cursorPos )
+{
+   std::vector<std::string> words;
+   std::string word;
+   bool inWord = false;
+   char quote = 0;
+
+   for ( size_t i = 0; i < std::min( cursorPos, line.size() ); ++i ) {
+      auto ch = line[i];
+      if ( quote ) {
+         if ( ch == quote )
+            quote = 0;
+         else if ( ch == '\\' && quote == '"' && i + 1 < line.size() )
+            word += line[++i];
+         else
+            word += ch;
+      }
+      else if ( ch == '\'' || ch == '"' ) {
+         quote = ch;
+         inWord = true;
+      }
+      else if ( ch == '\\' && i + 1 < line.size() ) {
+         word += line[++i];
+         inWord = true;
+      }
+      else if ( std::isspace( static_cast<unsigned char>( ch ) ) ) {
+         if ( inWord )
+            words.push_back( std::move( word ) );
+         word.clear();
+         inWord = false;
+      }
+      else {
+         word += ch;
+         inWord = true;
+      }
+   }
+
+   // The last word is the partial word.  It is empty if the cursor follows a
+   // space.
+   words.push_back( std::move( word ) );
+   if ( words.size() < 2 )
+      return {};
+
+   words.erase( words.begin() );
+   return complete( words, words.size() - 1 );
+}
+
+namespace detail {
+ARGUMENTUM_INLINE std::string_view getFirstLine( std::string_view help )
+{
+   return help.substr( 0, help.find( '\n' ) );
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE void completion_engine::write_candidates( std::ostream& out,
+      const std::vector<completion_candidate>& candidates, ECompletionShell shell )
+{
+   for ( auto& candidate : candidates ) {
+      auto help = detail::getFirstLine( candidate.help );
+      switch ( shell ) {
+         case ECompletionShell::bash:
+            out << candidate.value << "\n";
+            break;
+         case ECompletionShell::zsh:
+            for ( auto ch : candidate.value ) {
+               if ( ch == ':' || ch == '\\' )
+                  out << '\\';
+               out << ch;
+            }
+            if ( !help.empty() )
+               out << ":" << help;
+            out << "\n";
+            break;
+         case ECompletionShell::fish:
+            out << candidate.value;
+            if ( !help.empty() )
+               out << "\t" << help;
+            out << "\n";
+            break;
+      }
+   }
+}
+
+}   // namespace argumentum
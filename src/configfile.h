@@ -0,0 +1,70 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+class MappedFile;
+
+// An INI-style configuration file with `key = value` lines.  The file is
+// mapped into memory and the entries are views into the mapped data.
+//
+// The keys are the long names of options without the leading dashes.  A key
+// without a value sets a flag.  Lines that start with '#' or ';' are comments.
+// A value enclosed in quotes is used without the quotes.  The keys that follow
+// a `[section]` line belong to the group or to the command named by the
+// section.  The sections of nested commands are named `command.subcommand`.
+//
+// The file is read by an incremental_parser with feed().  The file must
+// outlive the parse.
+class config_file
+{
+public:
+   struct entry
+   {
+      std::string_view section;
+      std::string_view key;
+      std::string_view value;
+      unsigned line = 0;
+      // The line of the section header.
+      unsigned sectionLine = 0;
+      bool hasValue = false;
+   };
+
+private:
+   std::string mPath;
+   std::unique_ptr<MappedFile> mpFile;
+   std::vector<entry> mEntries;
+   std::vector<entry> mInvalidEntries;
+
+public:
+   config_file();
+   config_file( config_file&& ) noexcept;
+   config_file& operator=( config_file&& ) noexcept;
+   ~config_file();
+
+   // Map the file @p path into memory and index its entries.  Returns false
+   // if the file can not be read.
+   bool open( const std::string& path );
+
+   const std::string& path() const;
+   const std::vector<entry>& entries() const;
+
+   // The lines that are not comments, sections or entries.  The key of an
+   // invalid entry holds the text of the line.
+   const std::vector<entry>& invalid_entries() const;
+
+   // The location of a line in the form 'path:line'.
+   std::string location( unsigned line ) const;
+
+private:
+   void index( std::string_view data );
+};
+
+}   // namespace argumentum
@@ -0,0 +1,122 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "configfile.h"
+
+#include "definitioncache.h"
+
+#include <fstream>
+
+namespace argumentum {
+
+ARGUMENTUM_INLINE config_file::config_file() = default;
+
+ARGUMENTUM_INLINE config_file::config_file( config_file&& ) noexcept = default;
+
+ARGUMENTUM_INLINE config_file& config_file::operator=( config_file&& ) noexcept = default;
+
+ARGUMENTUM_INLINE config_file::~config_file() = default;
+
+ARGUMENTUM_INLINE bool config_file::open( const std::string& path )
+{
+   mPath = path;
+   mEntries.clear();
+   mInvalidEntries.clear();
+   mpFile = std::make_unique<MappedFile>();
+   if ( mpFile->open( path ) ) {
+      index( std::string_view( mpFile->data(), mpFile->size() ) );
+      return true;
+   }
+
+   // An empty file can not be mapped.
+   mpFile.reset();
+   return std::ifstream( path ).good();
+}
+
+ARGUMENTUM_INLINE const std::string& config_file::path() const
+{
+   return mPath;
+}
+
+ARGUMENTUM_INLINE auto config_file::entries() const -> const std::vector<entry>&
+{
+   return mEntries;
+}
+
+ARGUMENTUM_INLINE auto config_file::invalid_entries() const -> const std::vector<entry>&
+{
+   return mInvalidEntries;
+}
+
+ARGUMENTUM_INLINE std::string config_file::location( unsigned line ) const
+{
+   return mPath + ":" + std::to_string( line );
+}
+
+namespace detail {
+ARGUMENTUM_INLINE std::string_view trimConfigText( std::string_view text )
+{
+   auto begin = text.find_first_not_of( " \t\r" );
+   if ( begin == std::string_view::npos )
+      return {};
+   auto end = text.find_last_not_of( " \t\r" );
+   return text.substr( begin, end - begin + 1 );
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE void config_file::index( std::string_view data )
+{
+   std::string_view section;
+   unsigned sectionLine = 0;
+   unsigned lineNo = 0;
+
+   while ( !data.empty() ) {
+      ++lineNo;
+      auto eol = data.find( '\n' );
+      auto line = detail::trimConfigText( data.substr( 0, eol ) );
+      data.remove_prefix( eol == std::string_view::npos ? data.size() : eol + 1 );
+
+      if ( line.empty() || line[0] == '#' || line[0] == ';' )
+         continue;
+
+      if ( line[0] == '[' ) {
+         if ( line.back() != ']' ) {
+            mInvalidEntries.push_back( { section, line, {}, lineNo, sectionLine, false } );
+            continue;
+         }
+         section = detail::trimConfigText( line.substr( 1, line.size() - 2 ) );
+         sectionLine = lineNo;
+         continue;
+      }
+
+      entry item;
+      item.section = section;
+      item.sectionLine = sectionLine;
+      item.line = lineNo;
+
+      auto eqpos = line.find( '=' );
+      item.key = detail::trimConfigText( line.substr( 0, eqpos ) );
+      if ( eqpos != std::string_view::npos ) {
+         auto value = detail::trimConfigText( line.substr( eqpos + 1 ) );
+         if ( value.size() >= 2 && ( value[0] == '"' || value[0] == '\'' )
+               && value.back() == value[0] )
+            value = value.substr( 1, value.size() - 2 );
+         item.value = value;
+         item.hasValue = true;
+      }
+
+      // The option names do not contain white space.
+      auto isInvalidKey = item.key.empty()
+            || item.key.find_first_of( " \t" ) != std::string_view::npos;
+      if ( isInvalidKey ) {
+         item.key = line;
+         mInvalidEntries.push_back( item );
+      }
+      else
+         mEntries.push_back( item );
+   }
+}
+
+}   // namespace argumentum
@@ -3,12 +3,18 @@
 
 #pragma once
 
+#include "exceptions.h"
+
+#include <algorithm>
 #include <cerrno>
+#include <charconv>
+#include <cstring>
 #include <limits>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace argumentum {
@@ -16,10 +22,91 @@ namespace argumentum {
 std::tuple<int, int, int> parse_int_prefix( std::string_view sv );
 std::tuple<int, int> parse_float_prefix( std::string_view sv );
 
+// The reason why an argument could not be assigned to a value.
+enum class EConversionError {
+   none,
+   // The argument does not represent a value of the target type.
+   invalidValue,
+   // The value is not in the range of the target type.
+   outOfRange,
+   // The argument is not one of the choices of the option.
+   invalidChoice
+};
+
+// The value converted from an argument or the reason why the conversion
+// failed.  It is returned by the conversions that do not throw.
 template<typename T>
-T parse_int( const std::string& s )
+struct ConversionResult
+{
+   T value{};
+   EConversionError error = EConversionError::none;
+
+   ConversionResult() = default;
+   ConversionResult( T value_ )
+      : value( std::move( value_ ) )
+   {}
+   ConversionResult( EConversionError error_ )
+      : error( error_ )
+   {}
+
+   bool has_value() const
+   {
+      return error == EConversionError::none;
+   }
+
+   explicit operator bool() const
+   {
+      return has_value();
+   }
+};
+
+// strtol and strtod require a terminated string.  Short texts are copied to
+// the stack.
+class TerminatedText
+{
+   char mBuffer[64];
+   std::string mLongText;
+   const char* mpText;
+
+public:
+   explicit TerminatedText( std::string_view text )
+   {
+      if ( text.size() < sizeof( mBuffer ) ) {
+         std::memcpy( mBuffer, text.data(), text.size() );
+         mBuffer[text.size()] = '\0';
+         mpText = mBuffer;
+      }
+      else {
+         mLongText = std::string{ text };
+         mpText = mLongText.c_str();
+      }
+   }
+
+   TerminatedText( const TerminatedText& ) = delete;
+   TerminatedText& operator=( const TerminatedText& ) = delete;
+
+   const char* c_str() const
+   {
+      return mpText;
+   }
+};
+
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+// Return the converted value or throw invalid_argument or out_of_range.
+template<typename T>
+T value_or_throw( ConversionResult<T>&& result, std::string_view s )
+{
+   if ( result.error == EConversionError::outOfRange )
+      throw std::out_of_range( std::string{ s } );
+   if ( result.error != EConversionError::none )
+      throw std::invalid_argument( std::string{ s } );
+   return std::move( result.value );
+}
+#endif
+
+template<typename T>
+ConversionResult<T> try_parse_int( std::string_view sv )
 {
-   std::string_view sv( s );
    auto [sign, base, skip] = parse_int_prefix( sv );
    if ( skip > 0 )
       sv = sv.substr( skip );
@@ -32,27 +119,36 @@ T parse_int( const std::string& s )
       }
    } clear_errno;
 
+   TerminatedText text( sv );
    char* pend;
-   auto checkResult = [&]( auto res ) {
+   auto checkResult = [&]( auto res ) -> ConversionResult<T> {
       if ( errno == ERANGE )
-         throw std::out_of_range( s );
-      if ( errno == EINVAL || pend == sv.data() )
-         throw std::invalid_argument( s );
+         return EConversionError::outOfRange;
+      if ( errno == EINVAL || pend == text.c_str() )
+         return EConversionError::invalidValue;
       if ( res < std::numeric_limits<T>::min() || res > std::numeric_limits<T>::max() )
-         throw std::out_of_range( s );
+         return EConversionError::outOfRange;
       return static_cast<T>( res );
    };
 
    if constexpr ( std::numeric_limits<T>::is_signed )
-      return checkResult( sign * strtoll( sv.data(), &pend, base ) );
+      return checkResult( sign * strtoll( text.c_str(), &pend, base ) );
    else {
       if ( sign > 0 )
-         return checkResult( strtoull( sv.data(), &pend, base ) );
+         return checkResult( strtoull( text.c_str(), &pend, base ) );
       else
-         throw std::out_of_range( s );
+         return EConversionError::outOfRange;
    }
 }
 
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+template<typename T>
+T parse_int( const std::string& s )
+{
+   return value_or_throw( try_parse_int<T>( s ), s );
+}
+#endif
+
 namespace strtodx {
 template<typename T>
 T parse( const char* pdata, char** pend )
@@ -72,9 +168,8 @@ inline long double parse<long double>( const char* pdata, char** pend )
 }   // namespace strtodx
 
 template<typename T>
-T parse_float( const std::string& s )
+ConversionResult<T> try_parse_float( std::string_view sv )
 {
-   std::string_view sv( s );
    auto [sign, skip] = parse_float_prefix( sv );
    if ( skip > 0 )
       sv = sv.substr( skip );
@@ -87,20 +182,190 @@ T parse_float( const std::string& s )
       }
    } clear_errno;
 
+   TerminatedText text( sv );
    char* pend;
-   auto checkResult = [&]( auto res ) {
+   auto checkResult = [&]( auto res ) -> ConversionResult<T> {
       if ( errno == ERANGE )
-         throw std::out_of_range( s );
-      if ( errno == EINVAL || pend == sv.data() )
-         throw std::invalid_argument( s );
+         return EConversionError::outOfRange;
+      if ( errno == EINVAL || pend == text.c_str() )
+         return EConversionError::invalidValue;
       if ( res < -std::numeric_limits<T>::max() || res > std::numeric_limits<T>::max() )
-         throw std::out_of_range( s );
+         return EConversionError::outOfRange;
       return static_cast<T>( res );
    };
 
-   return checkResult( sign * strtodx::parse<T>( sv.data(), &pend ) );
+   return checkResult( sign * strtodx::parse<T>( text.c_str(), &pend ) );
+}
+
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+template<typename T>
+T parse_float( const std::string& s )
+{
+   return value_or_throw( try_parse_float<T>( s ), s );
+}
+#endif
+
+// Convert a number without allocating a string.  Returns false if @p sv is
+// not a valid number of type T.  Unlike parse_int and parse_float, the whole
+// string must represent a number.
+//
+// Plain decimal numbers are converted directly.  The numbers with multiple
+// signs or a base prefix are converted after the prefix is removed.
+template<typename T>
+bool parse_number( std::string_view sv, T& value )
+{
+   static_assert( std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+         "parse_number requires a numeric type." );
+
+   if ( sv.empty() )
+      return false;
+
+   if constexpr ( std::is_integral<T>::value ) {
+      auto [ptr, ec] = std::from_chars( sv.data(), sv.data() + sv.size(), value );
+      if ( ec == std::errc{} && ptr == sv.data() + sv.size() )
+         return true;
+      if ( ec == std::errc::result_out_of_range )
+         return false;
+
+      auto [sign, base, skip] = parse_int_prefix( sv );
+      auto digits = sv.substr( skip );
+      if ( skip == 0 || digits.empty() )
+         return false;
+
+      unsigned long long magnitude = 0;
+      auto pend = digits.data() + digits.size();
+      auto [pmag, ecmag] = std::from_chars( digits.data(), pend, magnitude, base );
+      if ( ecmag != std::errc{} || pmag != pend )
+         return false;
+
+      using limits = std::numeric_limits<T>;
+      if ( sign > 0 ) {
+         if ( magnitude > static_cast<unsigned long long>( limits::max() ) )
+            return false;
+         value = static_cast<T>( magnitude );
+         return true;
+      }
+
+      if constexpr ( limits::is_signed ) {
+         auto maxNegative = static_cast<unsigned long long>( limits::max() ) + 1;
+         if ( magnitude > maxNegative )
+            return false;
+         if ( magnitude == maxNegative )
+            value = limits::min();
+         else
+            value = static_cast<T>( -static_cast<T>( magnitude ) );
+         return true;
+      }
+
+      return false;
+   }
+   else {
+      auto parseFloat = [&value]( std::string_view text, int sign ) {
+         TerminatedText terminated( text );
+         auto pstart = terminated.c_str();
+         char* pparsed;
+         errno = 0;
+         auto res = strtodx::parse<T>( pstart, &pparsed );
+         auto ok = errno == 0 && pparsed == pstart + text.size() && !text.empty();
+         errno = 0;
+         if ( ok )
+            value = sign * res;
+         return ok;
+      };
+
+      if ( parseFloat( sv, 1 ) )
+         return true;
+
+      auto [sign, skip] = parse_float_prefix( sv );
+      return skip > 0 && parseFloat( sv.substr( skip ), sign );
+   }
+}
+
+// Split @p text at @p delimiter and append the converted elements to @p
+// values.  An empty text is an empty list and appends nothing.  Returns the
+// position of the first element that can not be converted; the elements are
+// appended only if all of them are converted.
+//
+// The delimiters are found with memchr which is vectorized in the common C
+// libraries.
+template<typename T>
+std::optional<size_t> try_parse_list(
+      std::string_view text, char delimiter, std::vector<T>& values )
+{
+   if ( text.empty() )
+      return {};
+
+   const auto pend = text.data() + text.size();
+   auto findDelimiter = [&]( const char* pstart ) -> const char* {
+      auto pfound = std::memchr( pstart, delimiter, pend - pstart );
+      return pfound ? static_cast<const char*>( pfound ) : pend;
+   };
+
+   size_t count = 1;
+   for ( auto p = findDelimiter( text.data() ); p != pend; p = findDelimiter( p + 1 ) )
+      ++count;
+
+   std::vector<T> converted;
+   converted.reserve( count );
+
+   size_t index = 0;
+   auto pstart = text.data();
+   while ( true ) {
+      auto pdelim = findDelimiter( pstart );
+      auto element = std::string_view( pstart, pdelim - pstart );
+      T value;
+      if ( !parse_number( element, value ) )
+         return index;
+      converted.push_back( value );
+
+      if ( pdelim == pend )
+         break;
+      pstart = pdelim + 1;
+      ++index;
+   }
+
+   if ( values.empty() )
+      values.swap( converted );
+   else {
+      // Keep the geometric growth of the target when it receives many lists.
+      auto required = values.size() + count;
+      if ( required > values.capacity() )
+         values.reserve( std::max( required, 2 * values.capacity() ) );
+      values.insert( values.end(), converted.begin(), converted.end() );
+   }
+   return {};
+}
+
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+// Like try_parse_list but throws ListElementError with the position of the
+// first element that can not be converted.
+template<typename T>
+void parse_list( std::string_view text, char delimiter, std::vector<T>& values )
+{
+   auto failed = try_parse_list( text, delimiter, values );
+   if ( failed ) {
+      auto element = text;
+      for ( size_t i = 0; i < *failed; ++i )
+         element = element.substr( element.find( delimiter ) + 1 );
+      throw ListElementError( *failed, element.substr( 0, element.find( delimiter ) ) );
+   }
 }
+#endif
 
+// The conversions of the arguments to the values of the targets.  A
+// specialization defines at least one of the static functions (the first one
+// that exists is used):
+//
+// - `convert( std::string_view )` returns a std::optional<T>, a
+//   ConversionResult<T> or the value.  The argument is not copied to a
+//   string.  An empty optional is reported as an invalid value.
+// - `try_convert( ... )` returns a ConversionResult<T>.  The built-in types
+//   accept a std::string_view.
+// - `convert( const std::string& )` returns the value or throws
+//   invalid_argument or out_of_range.
+//
+// In the build without exceptions only the conversions that return an
+// optional or a ConversionResult can report errors.
 template<typename T, typename Enable = void>
 struct from_string
 {
@@ -109,10 +374,17 @@ struct from_string
 template<typename T>
 struct from_string<std::optional<T>>
 {
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
    static T convert( const std::string& s )
    {
       return from_string<T>::convert( s );
    }
+#endif
+
+   static ConversionResult<T> try_convert( const std::string& s )
+   {
+      return from_string<T>::try_convert( s );
+   }
 };
 
 template<>
@@ -122,33 +394,62 @@ struct from_string<std::string>
    {
       return s;
    }
+
+   static ConversionResult<std::string> try_convert( std::string_view s )
+   {
+      return std::string{ s };
+   }
 };
 
 template<>
 struct from_string<bool>
 {
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
    static bool convert( const std::string& s )
    {
       return parse_int<int>( s );
    }
+#endif
+
+   static ConversionResult<bool> try_convert( std::string_view s )
+   {
+      auto res = try_parse_int<int>( s );
+      if ( !res )
+         return res.error;
+      return res.value != 0;
+   }
 };
 
 template<typename T>
 struct from_string<T, typename std::enable_if<std::is_integral<T>::value>::type>
 {
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
    static T convert( const std::string& s )
    {
       return parse_int<T>( s );
    }
+#endif
+
+   static ConversionResult<T> try_convert( std::string_view s )
+   {
+      return try_parse_int<T>( s );
+   }
 };
 
 template<typename T>
 struct from_string<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
 {
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
    static T convert( const std::string& s )
    {
       return parse_float<T>( s );
    }
+#endif
+
+   static ConversionResult<T> try_convert( std::string_view s )
+   {
+      return try_parse_float<T>( s );
+   }
 };
 
 }   // namespace argumentum
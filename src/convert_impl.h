@@ -3,60 +3,59 @@
 
 #pragma once
 
-#include <regex>
+#include <algorithm>
 #include <string_view>
+#include <tuple>
 
 namespace argumentum {
 
+namespace detail {
+// Returns the number of leading '+' and '-' characters in @p sv and the sign
+// they define.
+ARGUMENTUM_INLINE std::tuple<int, size_t> parse_sign_prefix( std::string_view sv )
+{
+   auto length = std::min( sv.find_first_not_of( "+-" ), sv.size() );
+   auto minusCount = std::count( sv.begin(), sv.begin() + length, '-' );
+   return std::make_tuple( minusCount % 2 ? -1 : 1, length );
+}
+}   // namespace detail
+
+// Parse the prefix `[-+]*(0[bdox])?` of an integer.
 ARGUMENTUM_INLINE std::tuple<int, int, int> parse_int_prefix( std::string_view sv )
 {
-   static auto rxPrefix = std::regex( "^([-+]*)(0[bdox])?" );
-   int sign = 1;
+   auto [sign, length] = detail::parse_sign_prefix( sv );
    int base = 10;
-   std::match_results<std::string_view::iterator> m;
-   if ( std::regex_search( sv.begin(), sv.end(), m, rxPrefix ) ) {
-      if ( m.length( 1 ) )
-         sign = std::count( m[1].first, m[1].second, '-' ) % 2 ? -1 : 1;
-      if ( m.length( 2 ) ) {
-         switch ( *( m[2].first + 1 ) ) {
-            case 'b':
-               base = 2;
-               break;
-            case 'd':
-               base = 10;
-               break;
-            case 'o':
-               base = 8;
-               break;
-            case 'x':
-               base = 16;
-               break;
-         }
+   if ( length + 1 < sv.size() && sv[length] == '0' ) {
+      switch ( sv[length + 1] ) {
+         case 'b':
+            base = 2;
+            length += 2;
+            break;
+         case 'd':
+            base = 10;
+            length += 2;
+            break;
+         case 'o':
+            base = 8;
+            length += 2;
+            break;
+         case 'x':
+            base = 16;
+            length += 2;
+            break;
       }
-      return std::make_tuple( sign, base, static_cast<int>( m.length( 0 ) ) );
    }
-   return std::make_tuple( sign, base, 0 );
+   return std::make_tuple( sign, base, static_cast<int>( length ) );
 }
 
+// Parse the prefix `[-+]*(0[dx])?` of a floating point number.  The prefix
+// 0x is not skipped because it is handled by the conversion.
 ARGUMENTUM_INLINE std::tuple<int, int> parse_float_prefix( std::string_view sv )
 {
-   static auto rxPrefix = std::regex( "^([-+]*)(0[dx])?" );
-   int sign = 1;
-   std::match_results<std::string_view::iterator> m;
-   if ( std::regex_search( sv.begin(), sv.end(), m, rxPrefix ) ) {
-      if ( m.length( 1 ) )
-         sign = std::count( m[1].first, m[1].second, '-' ) % 2 ? -1 : 1;
-      if ( m.length( 2 ) ) {
-         switch ( *( m[2].first + 1 ) ) {
-            case 'd':
-               return std::make_tuple( sign, static_cast<int>( m.length( 0 ) ) );
-            case 'x':
-               return std::make_tuple( sign, static_cast<int>( m.length( 1 ) ) );
-         }
-      }
-      return std::make_tuple( sign, static_cast<int>( m.length( 1 ) ) );
-   }
-   return std::make_tuple( sign, 0 );
+   auto [sign, length] = detail::parse_sign_prefix( sv );
+   if ( length + 1 < sv.size() && sv[length] == '0' && sv[length + 1] == 'd' )
+      length += 2;
+   return std::make_tuple( sign, static_cast<int>( length ) );
 }
 
 }   // namespace argumentum
@@ -0,0 +1,173 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+class Option;
+class OptionGroup;
+class ParserDefinition;
+
+// A read-only view of a file that is mapped into memory.  If the platform
+// does not support mapping, the file is read into a buffer.
+class MappedFile
+{
+   const char* mpData = nullptr;
+   size_t mSize = 0;
+   bool mIsMapped = false;
+   std::vector<char> mBuffer;
+
+public:
+   MappedFile() = default;
+   MappedFile( const MappedFile& ) = delete;
+   MappedFile& operator=( const MappedFile& ) = delete;
+   ~MappedFile();
+
+   bool open( const std::string& path );
+   const char* data() const;
+   size_t size() const;
+};
+
+// A binary cache of the metadata of the options, groups and commands defined
+// in a parser.  The cache is written after the first definition of a parser
+// and loaded on later runs.  When the cache is valid the parameters are bound
+// to their targets and their metadata is restored from the cache; the names
+// are not validated again and the configuration calls that set the cached
+// metadata have no effect.
+//
+// The cache is valid only if it was written with the same format version and
+// the same schema.  The schema is an arbitrary string that identifies the
+// definition of the parser, eg. a build id.  A cache that does not match the
+// bound parameters or a cached option that is configured with different
+// metadata marks the cache as stale and it is rewritten.
+class DefinitionCache
+{
+public:
+   static constexpr uint32_t formatVersion = 1;
+   static constexpr uint32_t noGroup = ~uint32_t( 0 );
+
+   struct StringRef
+   {
+      uint32_t offset;
+      uint32_t size;
+   };
+
+   struct Header
+   {
+      char magic[8];
+      uint32_t formatVersion;
+      uint32_t headerSize;
+      uint64_t schemaHash;
+      uint32_t optionCount;
+      uint32_t groupCount;
+      uint32_t listCount;
+      uint32_t optionIndexCount;
+      uint32_t commandIndexCount;
+      uint32_t stringBytes;
+   };
+
+   struct OptionRecord
+   {
+      StringRef shortName;
+      StringRef longName;
+      StringRef help;
+      StringRef flagValue;
+      // The metavars and choices are ranges in the list table.
+      uint32_t firstMetavar;
+      uint32_t metavarCount;
+      uint32_t firstChoice;
+      uint32_t choiceCount;
+      int32_t minArgs;
+      int32_t maxArgs;
+      uint32_t group;
+      uint8_t isPositional;
+      uint8_t isRequired;
+      uint8_t isForwarded;
+      uint8_t isVectorValue;
+   };
+
+   struct GroupRecord
+   {
+      StringRef name;
+      StringRef title;
+      StringRef description;
+      uint8_t isExclusive;
+      uint8_t isRequired;
+      uint8_t padding[2];
+   };
+
+   // The entries of the name indices are sorted by name.  The commands are
+   // stored only in the command index.
+   struct IndexEntry
+   {
+      StringRef name;
+      uint32_t record;
+   };
+
+private:
+   MappedFile mFile;
+   const Header* mpHeader = nullptr;
+   const OptionRecord* mpOptions = nullptr;
+   const GroupRecord* mpGroups = nullptr;
+   const StringRef* mpLists = nullptr;
+   const IndexEntry* mpOptionIndex = nullptr;
+   const IndexEntry* mpCommandIndex = nullptr;
+   const char* mpStrings = nullptr;
+   std::vector<bool> mIsOptionBound;
+   std::vector<bool> mIsCommandBound;
+   std::vector<std::shared_ptr<OptionGroup>> mRestoredGroups;
+   bool mIsLoaded = false;
+   bool mIsStale = false;
+   bool mIsWritten = false;
+
+public:
+   // Hash the @p schema together with the format version of the cache.
+   static uint64_t hashSchema( std::string_view schema );
+
+   // Load the cache from @p path.  The returned cache is not valid if the
+   // file does not exist or if it was created with a different schema.
+   static std::shared_ptr<DefinitionCache> load( const std::string& path, std::string_view schema );
+
+   // Write the definitions from @p parserDef to @p path if the cache was not
+   // loaded or if it is stale.  Returns false if the file could not be
+   // written.
+   bool update( const std::string& path, std::string_view schema,
+         const ParserDefinition& parserDef );
+
+   // Returns true if the cache was loaded and no mismatch was found.
+   bool isValid() const;
+
+   // Mark the cache as stale.  The rest of the definitions are processed
+   // without the cache and the cache is written again by update().
+   void invalidate();
+
+   // Find the option record with exactly the names @p names and restore its
+   // metadata into @p option.  Returns false and invalidates the cache if
+   // there is no such record or if it was already bound.
+   bool bindOption( Option& option, const std::vector<std::string_view>& names,
+         ParserDefinition& parserDef );
+
+   // Returns true if a command named @p name is in the cache and it was not
+   // bound yet.  The command names in the cache were already checked for
+   // duplicates.  Invalidates the cache if the command can not be bound.
+   bool bindCommand( std::string_view name );
+
+private:
+   static bool write(
+         const std::string& path, std::string_view schema, const ParserDefinition& parserDef );
+   bool loadFile( const std::string& path, uint64_t schemaHash );
+   bool verifyRecords() const;
+   std::string_view getString( StringRef ref ) const;
+   const IndexEntry* findName(
+         const IndexEntry* pBegin, uint32_t count, std::string_view name ) const;
+   std::shared_ptr<OptionGroup> restoreGroup( uint32_t index, ParserDefinition& parserDef );
+};
+
+}   // namespace argumentum
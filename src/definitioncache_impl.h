@@ -0,0 +1,476 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "definitioncache.h"
+
+#include "command.h"
+#include "group.h"
+#include "option.h"
+#include "parserdefinition.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace argumentum {
+
+ARGUMENTUM_INLINE MappedFile::~MappedFile()
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+   if ( mIsMapped )
+      ::munmap( const_cast<char*>( mpData ), mSize );
+#endif
+}
+
+ARGUMENTUM_INLINE bool MappedFile::open( const std::string& path )
+{
+   assert( mpData == nullptr );
+#if defined( __unix__ ) || defined( __APPLE__ )
+   auto fd = ::open( path.c_str(), O_RDONLY );
+   if ( fd < 0 )
+      return false;
+
+   struct stat st;
+   if ( ::fstat( fd, &st ) != 0 || st.st_size <= 0 ) {
+      ::close( fd );
+      return false;
+   }
+
+   auto pData = ::mmap( nullptr, size_t( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+   ::close( fd );
+   if ( pData == MAP_FAILED )
+      return false;
+
+   mpData = static_cast<const char*>( pData );
+   mSize = size_t( st.st_size );
+   mIsMapped = true;
+   return true;
+#else
+   std::ifstream file( path, std::ios::binary );
+   if ( !file )
+      return false;
+
+   mBuffer.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+   mpData = mBuffer.data();
+   mSize = mBuffer.size();
+   return mSize > 0;
+#endif
+}
+
+ARGUMENTUM_INLINE const char* MappedFile::data() const
+{
+   return mpData;
+}
+
+ARGUMENTUM_INLINE size_t MappedFile::size() const
+{
+   return mSize;
+}
+
+inline constexpr char cacheMagic[8] = { 'A', 'R', 'G', 'M', 'D', 'E', 'F', 'C' };
+
+// Collects the strings and the tables of a definition cache before they are
+// written to a file.
+class DefinitionCacheWriter
+{
+public:
+   using StringRef = DefinitionCache::StringRef;
+   using IndexEntry = DefinitionCache::IndexEntry;
+
+   std::string strings;
+   std::vector<DefinitionCache::OptionRecord> options;
+   std::vector<DefinitionCache::GroupRecord> groups;
+   std::vector<StringRef> lists;
+   std::vector<IndexEntry> optionIndex;
+   std::vector<IndexEntry> commandIndex;
+
+   StringRef addString( std::string_view str )
+   {
+      auto ref = StringRef{ uint32_t( strings.size() ), uint32_t( str.size() ) };
+      strings.append( str );
+      return ref;
+   }
+
+   void addIndexEntry( std::vector<IndexEntry>& index, std::string_view name, size_t record )
+   {
+      if ( !name.empty() )
+         index.push_back( IndexEntry{ addString( name ), uint32_t( record ) } );
+   }
+
+   void sortIndex( std::vector<IndexEntry>& index )
+   {
+      auto name = [this]( const IndexEntry& entry ) {
+         return std::string_view( strings ).substr( entry.name.offset, entry.name.size );
+      };
+      std::sort( index.begin(), index.end(), [&]( const IndexEntry& a, const IndexEntry& b ) {
+         return name( a ) < name( b );
+      } );
+   }
+
+   template<typename T>
+   static void writeTable( std::ostream& stream, const std::vector<T>& table )
+   {
+      if ( !table.empty() )
+         stream.write( reinterpret_cast<const char*>( table.data() ), table.size() * sizeof( T ) );
+   }
+};
+
+ARGUMENTUM_INLINE uint64_t DefinitionCache::hashSchema( std::string_view schema )
+{
+   // FNV-1a
+   uint64_t hash = 14695981039346656037ull;
+   auto addByte = [&hash]( unsigned char byte ) {
+      hash ^= byte;
+      hash *= 1099511628211ull;
+   };
+
+   for ( unsigned i = 0; i < sizeof( formatVersion ); ++i )
+      addByte( ( formatVersion >> ( 8 * i ) ) & 0xff );
+   for ( auto ch : schema )
+      addByte( static_cast<unsigned char>( ch ) );
+
+   return hash;
+}
+
+ARGUMENTUM_INLINE std::shared_ptr<DefinitionCache> DefinitionCache::load(
+      const std::string& path, std::string_view schema )
+{
+   auto pCache = std::make_shared<DefinitionCache>();
+   pCache->loadFile( path, hashSchema( schema ) );
+   return pCache;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::loadFile( const std::string& path, uint64_t schemaHash )
+{
+   if ( !mFile.open( path ) || mFile.size() < sizeof( Header ) )
+      return false;
+
+   auto pHeader = reinterpret_cast<const Header*>( mFile.data() );
+   if ( std::memcmp( pHeader->magic, cacheMagic, sizeof( cacheMagic ) ) != 0
+         || pHeader->formatVersion != formatVersion || pHeader->headerSize != sizeof( Header )
+         || pHeader->schemaHash != schemaHash )
+      return false;
+
+   auto expectedSize = uint64_t( sizeof( Header ) )
+         + uint64_t( pHeader->optionCount ) * sizeof( OptionRecord )
+         + uint64_t( pHeader->groupCount ) * sizeof( GroupRecord )
+         + uint64_t( pHeader->listCount ) * sizeof( StringRef )
+         + uint64_t( pHeader->optionIndexCount ) * sizeof( IndexEntry )
+         + uint64_t( pHeader->commandIndexCount ) * sizeof( IndexEntry ) + pHeader->stringBytes;
+   if ( expectedSize != mFile.size() )
+      return false;
+
+   auto pData = mFile.data() + sizeof( Header );
+   mpHeader = pHeader;
+   mpOptions = reinterpret_cast<const OptionRecord*>( pData );
+   pData += pHeader->optionCount * sizeof( OptionRecord );
+   mpGroups = reinterpret_cast<const GroupRecord*>( pData );
+   pData += pHeader->groupCount * sizeof( GroupRecord );
+   mpLists = reinterpret_cast<const StringRef*>( pData );
+   pData += pHeader->listCount * sizeof( StringRef );
+   mpOptionIndex = reinterpret_cast<const IndexEntry*>( pData );
+   pData += pHeader->optionIndexCount * sizeof( IndexEntry );
+   mpCommandIndex = reinterpret_cast<const IndexEntry*>( pData );
+   pData += pHeader->commandIndexCount * sizeof( IndexEntry );
+   mpStrings = pData;
+
+   if ( !verifyRecords() ) {
+      mpHeader = nullptr;
+      return false;
+   }
+
+   mIsOptionBound.assign( pHeader->optionCount, false );
+   mIsCommandBound.assign( pHeader->commandIndexCount, false );
+   mRestoredGroups.resize( pHeader->groupCount );
+   mIsLoaded = true;
+   return true;
+}
+
+// All the references in the cache must point inside the cache so that the
+// definitions can be restored without further checks.
+ARGUMENTUM_INLINE bool DefinitionCache::verifyRecords() const
+{
+   auto& header = *mpHeader;
+   auto isValidString = [&]( StringRef ref ) {
+      return uint64_t( ref.offset ) + ref.size <= header.stringBytes;
+   };
+   auto isValidList = [&]( uint32_t first, uint32_t count ) {
+      return uint64_t( first ) + count <= header.listCount;
+   };
+
+   for ( uint32_t i = 0; i < header.optionCount; ++i ) {
+      auto& rec = mpOptions[i];
+      if ( !isValidString( rec.shortName ) || !isValidString( rec.longName )
+            || !isValidString( rec.help ) || !isValidString( rec.flagValue )
+            || !isValidList( rec.firstMetavar, rec.metavarCount )
+            || !isValidList( rec.firstChoice, rec.choiceCount )
+            || ( rec.group != noGroup && rec.group >= header.groupCount ) )
+         return false;
+   }
+
+   for ( uint32_t i = 0; i < header.groupCount; ++i ) {
+      auto& rec = mpGroups[i];
+      if ( !isValidString( rec.name ) || !isValidString( rec.title )
+            || !isValidString( rec.description ) )
+         return false;
+   }
+
+   for ( uint32_t i = 0; i < header.listCount; ++i )
+      if ( !isValidString( mpLists[i] ) )
+         return false;
+
+   for ( uint32_t i = 0; i < header.optionIndexCount; ++i )
+      if ( !isValidString( mpOptionIndex[i].name ) || mpOptionIndex[i].record >= header.optionCount )
+         return false;
+
+   for ( uint32_t i = 0; i < header.commandIndexCount; ++i )
+      if ( !isValidString( mpCommandIndex[i].name ) )
+         return false;
+
+   return true;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::update(
+      const std::string& path, std::string_view schema, const ParserDefinition& parserDef )
+{
+   if ( mIsWritten || isValid() )
+      return true;
+
+   mIsWritten = write( path, schema, parserDef );
+   return mIsWritten;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::write(
+      const std::string& path, std::string_view schema, const ParserDefinition& parserDef )
+{
+   DefinitionCacheWriter writer;
+
+   std::map<const OptionGroup*, uint32_t> groupIndex;
+   for ( auto& [name, pGroup] : parserDef.mGroups ) {
+      if ( !pGroup )
+         continue;
+      groupIndex[pGroup.get()] = uint32_t( writer.groups.size() );
+      auto rec = GroupRecord{};
+      rec.name = writer.addString( pGroup->getName() );
+      rec.title = writer.addString( pGroup->getTitle() );
+      rec.description = writer.addString( pGroup->getDescription() );
+      rec.isExclusive = pGroup->isExclusive();
+      rec.isRequired = pGroup->isRequired();
+      writer.groups.push_back( rec );
+   }
+
+   auto addList = [&]( const std::vector<std::string_view>& values, uint32_t& first, uint32_t& count ) {
+      first = uint32_t( writer.lists.size() );
+      count = uint32_t( values.size() );
+      for ( auto& value : values )
+         writer.lists.push_back( writer.addString( value ) );
+   };
+
+   auto addOption = [&]( const Option& option ) {
+      auto index = writer.options.size();
+      auto& desc = *option.mpDescription;
+      auto rec = OptionRecord{};
+      rec.shortName = writer.addString( option.mShortName );
+      rec.longName = writer.addString( option.mLongName );
+      rec.help = writer.addString( desc.help );
+      rec.flagValue = writer.addString( desc.flagValue );
+      addList( desc.metavar, rec.firstMetavar, rec.metavarCount );
+      addList( desc.choices, rec.firstChoice, rec.choiceCount );
+      rec.minArgs = option.mMinArgs;
+      rec.maxArgs = option.mMaxArgs;
+      auto igroup = groupIndex.find( desc.pGroup.get() );
+      rec.group = igroup != groupIndex.end() ? igroup->second : noGroup;
+      rec.isPositional = option.isPositional();
+      rec.isRequired = option.mIsRequired;
+      rec.isForwarded = option.mIsForwarded;
+      rec.isVectorValue = option.mIsVectorValue;
+      writer.options.push_back( rec );
+
+      writer.addIndexEntry( writer.optionIndex, option.mShortName, index );
+      writer.addIndexEntry( writer.optionIndex, option.mLongName, index );
+   };
+
+   for ( auto& pOption : parserDef.mOptions )
+      addOption( *pOption );
+   for ( auto& pOption : parserDef.mPositional )
+      addOption( *pOption );
+
+   for ( auto& pCommand : parserDef.mCommands )
+      writer.addIndexEntry( writer.commandIndex, pCommand->getName(), writer.commandIndex.size() );
+
+   writer.sortIndex( writer.optionIndex );
+   writer.sortIndex( writer.commandIndex );
+
+   auto header = Header{};
+   std::memcpy( header.magic, cacheMagic, sizeof( cacheMagic ) );
+   header.formatVersion = formatVersion;
+   header.headerSize = sizeof( Header );
+   header.schemaHash = hashSchema( schema );
+   header.optionCount = uint32_t( writer.options.size() );
+   header.groupCount = uint32_t( writer.groups.size() );
+   header.listCount = uint32_t( writer.lists.size() );
+   header.optionIndexCount = uint32_t( writer.optionIndex.size() );
+   header.commandIndexCount = uint32_t( writer.commandIndex.size() );
+   header.stringBytes = uint32_t( writer.strings.size() );
+
+   // The cache is written to a temporary file and renamed so that a
+   // concurrent reader never sees a partially written cache.
+   auto tempPath = path + ".tmp";
+   {
+      std::ofstream stream( tempPath, std::ios::binary | std::ios::trunc );
+      if ( !stream )
+         return false;
+
+      stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+      writer.writeTable( stream, writer.options );
+      writer.writeTable( stream, writer.groups );
+      writer.writeTable( stream, writer.lists );
+      writer.writeTable( stream, writer.optionIndex );
+      writer.writeTable( stream, writer.commandIndex );
+      stream.write( writer.strings.data(), writer.strings.size() );
+      if ( !stream )
+         return false;
+   }
+
+   std::remove( path.c_str() );
+   return std::rename( tempPath.c_str(), path.c_str() ) == 0;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::isValid() const
+{
+   return mIsLoaded && !mIsStale;
+}
+
+ARGUMENTUM_INLINE void DefinitionCache::invalidate()
+{
+   mIsStale = true;
+   mIsWritten = false;
+}
+
+ARGUMENTUM_INLINE std::string_view DefinitionCache::getString( StringRef ref ) const
+{
+   return std::string_view( mpStrings + ref.offset, ref.size );
+}
+
+ARGUMENTUM_INLINE auto DefinitionCache::findName(
+      const IndexEntry* pBegin, uint32_t count, std::string_view name ) const -> const IndexEntry*
+{
+   auto pEnd = pBegin + count;
+   auto pFound = std::lower_bound( pBegin, pEnd, name, [this]( const IndexEntry& entry, auto name ) {
+      return getString( entry.name ) < name;
+   } );
+
+   if ( pFound == pEnd || getString( pFound->name ) != name )
+      return nullptr;
+
+   return pFound;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::bindOption(
+      Option& option, const std::vector<std::string_view>& names, ParserDefinition& parserDef )
+{
+   if ( !isValid() || names.empty() )
+      return false;
+
+   auto pEntry = findName( mpOptionIndex, mpHeader->optionIndexCount, names[0] );
+   if ( !pEntry || mIsOptionBound[pEntry->record] ) {
+      invalidate();
+      return false;
+   }
+
+   auto& rec = mpOptions[pEntry->record];
+   auto isPositional = names[0][0] != '-';
+   auto hasAllNames = [&]() {
+      if ( isPositional )
+         return getString( rec.longName ) == names[0];
+
+      auto nameCount = size_t( rec.shortName.size > 0 ) + size_t( rec.longName.size > 0 );
+      return nameCount == names.size()
+            && std::all_of( names.begin(), names.end(), [&]( auto name ) {
+                  return name == getString( rec.shortName ) || name == getString( rec.longName );
+               } );
+   };
+
+   if ( bool( rec.isPositional ) != isPositional
+         || bool( rec.isVectorValue ) != option.hasVectorValue() || !hasAllNames() ) {
+      invalidate();
+      return false;
+   }
+
+   auto getList = [&]( uint32_t first, uint32_t count ) {
+      std::vector<std::string_view> values;
+      values.reserve( count );
+      for ( auto i = first; i < first + count; ++i )
+         values.push_back( option.intern( getString( mpLists[i] ) ) );
+      return values;
+   };
+
+   auto& desc = *option.mpDescription;
+   option.mShortName = getString( rec.shortName );
+   option.mLongName = getString( rec.longName );
+   desc.help = option.intern( getString( rec.help ) );
+   desc.flagValue = option.intern( getString( rec.flagValue ) );
+   desc.metavar = getList( rec.firstMetavar, rec.metavarCount );
+   desc.choices = getList( rec.firstChoice, rec.choiceCount );
+   option.mHasChoices = !desc.choices.empty();
+   option.mMinArgs = rec.minArgs;
+   option.mMaxArgs = rec.maxArgs;
+   option.mIsRequired = rec.isRequired;
+   option.mIsForwarded = rec.isForwarded;
+   if ( rec.group != noGroup )
+      desc.pGroup = restoreGroup( rec.group, parserDef );
+
+   mIsOptionBound[pEntry->record] = true;
+   return true;
+}
+
+ARGUMENTUM_INLINE bool DefinitionCache::bindCommand( std::string_view name )
+{
+   if ( !isValid() )
+      return false;
+
+   auto pEntry = findName( mpCommandIndex, mpHeader->commandIndexCount, name );
+   if ( !pEntry || mIsCommandBound[pEntry - mpCommandIndex] ) {
+      invalidate();
+      return false;
+   }
+
+   mIsCommandBound[pEntry - mpCommandIndex] = true;
+   return true;
+}
+
+// A group may already be defined with add_group.  Otherwise it is created
+// from the cached record.
+ARGUMENTUM_INLINE std::shared_ptr<OptionGroup> DefinitionCache::restoreGroup(
+      uint32_t index, ParserDefinition& parserDef )
+{
+   auto& pGroup = mRestoredGroups[index];
+   if ( pGroup )
+      return pGroup;
+
+   auto& rec = mpGroups[index];
+   auto name = std::string( getString( rec.name ) );
+   pGroup = parserDef.findGroup( name );
+   if ( !pGroup ) {
+      pGroup = std::make_shared<OptionGroup>( name, rec.isExclusive );
+      pGroup->setTitle( getString( rec.title ) );
+      pGroup->setDescription( getString( rec.description ) );
+      pGroup->setRequired( rec.isRequired );
+      parserDef.mGroups[name] = pGroup;
+   }
+
+   return pGroup;
+}
+
+}   // namespace argumentum
@@ -25,7 +25,10 @@ public:
    const ParserConfig::Data& get_config() const;
    const ParserDefinition& get_parser_def() const;
    std::shared_ptr<IFormatHelp> get_help_formatter( const std::string& optionName ) const;
+#ifndef ARGUMENTUM_SLIM
    std::ostream* get_output_stream() const;
+#endif
+   IOutputSink* get_output_sink() const;
    void exit_parser();
    std::string get_option_name() const;
    void add_error( std::string_view error );
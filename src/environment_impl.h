@@ -33,10 +33,17 @@ ARGUMENTUM_INLINE std::shared_ptr<IFormatHelp> Environment::get_help_formatter(
    return get_config().help_formatter( helpOption );
 }
 
+#ifndef ARGUMENTUM_SLIM
 ARGUMENTUM_INLINE std::ostream* Environment::get_output_stream() const
 {
    return get_config().output_stream();
 }
+#endif
+
+ARGUMENTUM_INLINE IOutputSink* Environment::get_output_sink() const
+{
+   return get_config().output_sink();
+}
 
 ARGUMENTUM_INLINE void Environment::exit_parser()
 {
@@ -3,6 +3,17 @@
 
 #pragma once
 
+// The library can be built without exceptions (eg. with -fno-exceptions).  The
+// conversion errors are then reported only in the ParseResult and the errors
+// in the definitions of the parameters are collected by the parser and
+// reported when the arguments are parsed.
+#if !defined( ARGUMENTUM_NO_EXCEPTIONS ) && !defined( __cpp_exceptions ) \
+      && !defined( __EXCEPTIONS ) && !defined( _CPPUNWIND )
+#define ARGUMENTUM_NO_EXCEPTIONS
+#endif
+
+#include <cstdio>
+#include <cstdlib>
 #include <stdexcept>
 #include <string>
 
@@ -16,6 +27,24 @@ public:
    {}
 };
 
+// An element of a delimited list argument could not be converted.
+class ListElementError : public std::invalid_argument
+{
+   size_t mIndex;
+
+public:
+   ListElementError( size_t index, std::string_view value )
+      : std::invalid_argument( std::string{ value } )
+      , mIndex( index )
+   {}
+
+   // The zero-based position of the element in the list.
+   size_t index() const
+   {
+      return mIndex;
+   }
+};
+
 class UnsupportedTargetType : public std::invalid_argument
 {
 public:
@@ -92,4 +121,32 @@ public:
    {}
 };
 
+// Throw the definition error @p error.  Without exceptions @p report receives
+// the message of the error.  The reported errors are returned in the
+// ParseResult of the next parse.
+template<typename TError, typename TReport>
+void throw_or_report( const TError& error, TReport&& report )
+{
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   report( error.what() );
+#else
+   ( void )report;
+   throw error;
+#endif
+}
+
+// Throw @p error.  Without exceptions the program is terminated.  Used for the
+// errors that can not be reported in a ParseResult because they are caused by
+// an invalid use of the library.
+template<typename TError>
+[[noreturn]] void throw_or_abort( const TError& error )
+{
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   std::fprintf( stderr, "** %s\n", error.what() );
+   std::abort();
+#else
+   throw error;
+#endif
+}
+
 }   // namespace argumentum
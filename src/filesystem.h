@@ -24,6 +24,11 @@ class DefaultFilesystem : public Filesystem
 public:
    std::unique_ptr<ArgumentStream> open( const std::string& filename ) override
    {
+      // The arguments of a mapped file are read by the parser without copying.
+      auto pMapped = std::make_unique<MappedArgumentStream>();
+      if ( pMapped->open( filename ) )
+         return pMapped;
+
       return std::make_unique<StdStreamArgumentStream>(
             std::make_unique<std::ifstream>( filename ) );
    }
@@ -6,8 +6,6 @@
 #include "iformathelp.h"
 
 #include <algorithm>
-#include <iomanip>
-#include <iostream>
 #include <string>
 #include <vector>
 
@@ -20,7 +18,7 @@ class HelpFormatter : public IFormatHelp
    // The number of spaces before argument names.
    size_t mArgumentIndent = 2;
 
-   // The width of the formatted text in bytes.
+   // The width of the formatted text in display columns.
    size_t mTextWidth = 80;
 
    // The maximum width of an argument at which the description of the argument
@@ -28,7 +26,8 @@ class HelpFormatter : public IFormatHelp
    size_t mMaxDescriptionIndent = 30;
 
 public:
-   void format( const ParserDefinition& parserDef, std::ostream& out ) override;
+   using IFormatHelp::format;
+   void format( const ParserDefinition& parserDef, IOutputSink& out ) override;
 
    void setTextWidth( size_t widthBytes )
    {
@@ -10,8 +10,6 @@
 #include "parser.h"
 #include "writer.h"
 
-#include <sstream>
-
 namespace argumentum {
 
 ARGUMENTUM_INLINE std::string HelpFormatter::formatArgument( const ArgumentHelpResult& arg ) const
@@ -38,12 +36,11 @@ ARGUMENTUM_INLINE size_t HelpFormatter::deriveMaxArgumentWidth(
    if ( args.empty() )
       return 0U;
 
-   auto imax =
-         std::max_element( std::begin( args ), std::end( args ), [this]( auto&& a, auto&& b ) {
-            return formatArgument( a ).size() < formatArgument( b ).size();
-         } );
+   size_t maxWidth = 0;
+   for ( auto& arg : args )
+      maxWidth = std::max( maxWidth, Writer::displayWidth( formatArgument( arg ) ) );
 
-   return formatArgument( *imax ).size();
+   return maxWidth;
 }
 
 ARGUMENTUM_INLINE void HelpFormatter::formatUsage(
@@ -77,31 +74,38 @@ ARGUMENTUM_INLINE void HelpFormatter::formatUsage(
       else {
          if ( !name.empty() || !arg.arguments.empty() ) {
             auto addBracket = !name.empty() || arg.arguments.substr( 0, 1 ) != "[";
-            std::ostringstream oss;
+            std::string usage;
             if ( addBracket )
-               oss << "[";
+               usage += "[";
             if ( !name.empty() ) {
-               oss << name;
+               usage += name;
                if ( !arg.arguments.empty() )
-                  oss << " " << arg.arguments;
+                  usage += " " + arg.arguments;
             }
             else if ( !arg.arguments.empty() )
-               oss << arg.arguments;
+               usage += arg.arguments;
             if ( addBracket )
-               oss << "]";
-            writer.write( oss.str() );
+               usage += "]";
+            writer.write( usage );
          }
       }
    }
 }
 
-ARGUMENTUM_INLINE void HelpFormatter::format( const ParserDefinition& parserDef, std::ostream& out )
+ARGUMENTUM_INLINE void HelpFormatter::format( const ParserDefinition& parserDef, IOutputSink& out )
 {
    const auto& config = parserDef.getConfig();
    ArgumentDescriber describer;
    auto args = describer.describe_arguments( parserDef );
 
+   // Reserve the space for the help of the arguments, their names in the
+   // usage and in the indented list.
    Writer writer( out, mTextWidth );
+   size_t estimatedSize = config.description().size() + config.epilog().size() + mTextWidth;
+   for ( auto& arg : args )
+      estimatedSize += arg.help.size() + mMaxDescriptionIndent + mTextWidth / 2;
+   writer.reserve( estimatedSize );
+
    writer.write( "usage: " );
    if ( !config.usage().empty() )
       writer.write( config.usage() );
@@ -185,6 +189,8 @@ ARGUMENTUM_INLINE void HelpFormatter::format( const ParserDefinition& parserDef,
       writer.write( config.epilog() );
       writer.startParagraph();
    }
+
+   writer.flush();
 }
 
 }   // namespace argumentum
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "outputsink.h"
+
 #include <string>
 #include <vector>
 
@@ -43,7 +45,18 @@ struct ArgumentHelpResult
 class IFormatHelp
 {
 public:
-   virtual void format( const ParserDefinition& parserDef, std::ostream& out ) = 0;
+   virtual ~IFormatHelp() = default;
+
+   // Format the help of the parser and write it to @p out.
+   virtual void format( const ParserDefinition& parserDef, IOutputSink& out ) = 0;
+
+#ifndef ARGUMENTUM_SLIM
+   void format( const ParserDefinition& parserDef, std::ostream& out )
+   {
+      StreamOutputSink sink( out );
+      format( parserDef, sink );
+   }
+#endif
 };
 
 }   // namespace argumentum
@@ -0,0 +1,71 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "argumentstream.h"
+#include "parseresult.h"
+
+#include <memory>
+
+namespace argumentum {
+
+class argument_parser;
+class config_file;
+class Parser;
+
+// An incremental parser receives the input arguments in chunks.  The state of
+// the parse (the active option, the current positional parameter, the
+// selected command) is preserved between the chunks.  The parsed options are
+// validated when the parse is finished.
+//
+// The chunks do not need to outlive the call to feed().
+class incremental_parser
+{
+   friend class Parser;
+
+   argument_parser* mpArgParser = nullptr;
+   std::unique_ptr<ParseResultBuilder> mpResult;
+   std::unique_ptr<Parser> mpParser;
+   // The parameters were not defined correctly and the arguments are ignored.
+   // Used only without exceptions.
+   bool mHasDefinitionErrors = false;
+
+   class CloseTargetsOnUnwind;
+
+public:
+   // Start a new parse.  The values of all the options are reset.
+   explicit incremental_parser( argument_parser& argParser );
+   incremental_parser( incremental_parser&& other ) noexcept;
+   incremental_parser& operator=( incremental_parser&& other ) noexcept;
+   // A parse that was not finished closes the sink targets.
+   ~incremental_parser();
+
+   // Parse the next chunk of input arguments.
+   void feed( ArgumentStream& args );
+
+   // Parse the next chunk of input arguments.
+   template<typename TIter>
+   void feed( TIter ibegin, TIter iend )
+   {
+      auto args = IteratorArgumentStream( ibegin, iend );
+      feed( args );
+   }
+
+   // Read the values of the options from a configuration file.  The input
+   // arguments and the environment have precedence over the file and the file
+   // has precedence over the files fed before it.  The values are converted
+   // only from the source with the highest precedence.  The files should be
+   // fed before the arguments so that the options that append the values of
+   // all the sources receive them in the order of precedence.  The file must
+   // outlive the parse.
+   void feed( const config_file& file );
+
+   // Close the parse, validate the parsed options and return the result.
+   ParseResult finish();
+
+   // Returns true when finish() was already called.
+   bool finished() const;
+};
+
+}   // namespace argumentum
@@ -0,0 +1,131 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "argparser.h"
+#include "incrementalparser.h"
+#include "parser.h"
+
+#include <cassert>
+#include <exception>
+
+namespace argumentum {
+
+// Closes the sink targets when an exception leaves feed() or finish() so that
+// the consumers of the sinks are not blocked while the exception propagates.
+class incremental_parser::CloseTargetsOnUnwind
+{
+   Parser& mParser;
+   int mExceptionCount;
+
+public:
+   explicit CloseTargetsOnUnwind( Parser& parser )
+      : mParser( parser )
+      , mExceptionCount( std::uncaught_exceptions() )
+   {}
+
+   ~CloseTargetsOnUnwind()
+   {
+      if ( std::uncaught_exceptions() > mExceptionCount )
+         mParser.closeTargets();
+   }
+};
+
+ARGUMENTUM_INLINE incremental_parser::incremental_parser( argument_parser& argParser )
+   : mpArgParser( &argParser )
+{
+   argParser.verifyDefinedOptions();
+   argParser.resetOptionValues();
+
+   mpResult = std::make_unique<ParseResultBuilder>();
+   mpParser = std::make_unique<Parser>( argParser.mParserDef, *mpResult );
+
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   for ( auto& error : argParser.mParserDef.getDefinitionErrors() ) {
+      mpResult->addError( error, INVALID_DEFINITION );
+      mHasDefinitionErrors = true;
+   }
+#endif
+}
+
+ARGUMENTUM_INLINE incremental_parser::incremental_parser( incremental_parser&& other ) noexcept =
+      default;
+
+ARGUMENTUM_INLINE incremental_parser& incremental_parser::operator=(
+      incremental_parser&& other ) noexcept
+{
+   if ( this == &other )
+      return *this;
+
+   if ( mpParser )
+      mpParser->closeTargets();
+
+   mpArgParser = other.mpArgParser;
+   mpResult = std::move( other.mpResult );
+   mpParser = std::move( other.mpParser );
+   mHasDefinitionErrors = other.mHasDefinitionErrors;
+   return *this;
+}
+
+ARGUMENTUM_INLINE incremental_parser::~incremental_parser()
+{
+   if ( mpParser )
+      mpParser->closeTargets();
+}
+
+ARGUMENTUM_INLINE void incremental_parser::feed( ArgumentStream& args )
+{
+   assert( !finished() );
+   if ( !finished() && !mHasDefinitionErrors ) {
+      auto guard = CloseTargetsOnUnwind( *mpParser );
+      mpParser->feed( args );
+   }
+}
+
+ARGUMENTUM_INLINE void incremental_parser::feed( const config_file& file )
+{
+   assert( !finished() );
+   if ( !finished() && !mHasDefinitionErrors ) {
+      auto guard = CloseTargetsOnUnwind( *mpParser );
+      mpParser->feed( file );
+   }
+}
+
+ARGUMENTUM_INLINE ParseResult incremental_parser::finish()
+{
+   assert( !finished() );
+   if ( finished() )
+      return {};
+
+   {
+      auto guard = CloseTargetsOnUnwind( *mpParser );
+      mpParser->finish();
+   }
+   mpParser.reset();
+
+   auto& result = *mpResult;
+   if ( result.wasExitRequested() )
+      return std::move( result.getResult() );
+
+   if ( !mHasDefinitionErrors ) {
+      mpArgParser->assignDefaultValues( result );
+      mpArgParser->validateParsedOptions( result );
+   }
+
+   if ( mpArgParser->mTopLevel && result.hasArgumentProblems() ) {
+      result.signalErrorsShown();
+      auto res = std::move( result.getResult() );
+      mpArgParser->describe_errors( res );
+      return res;
+   }
+
+   return std::move( result.getResult() );
+}
+
+ARGUMENTUM_INLINE bool incremental_parser::finished() const
+{
+   return mpParser == nullptr;
+}
+
+}   // namespace argumentum
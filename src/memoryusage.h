@@ -0,0 +1,56 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <cstddef>
+
+namespace argumentum {
+
+// The memory used by the definition of an option.  The interned strings are
+// stored in the string pool of the parser and are not included.
+struct OptionMemoryUsage
+{
+   // The option record that is read while the arguments are parsed.
+   size_t hotBytes = 0;
+   // The description of the option: names, help, metavars, choices, actions.
+   size_t coldBytes = 0;
+   // The memory allocated by the strings and the containers of the description.
+   size_t heapBytes = 0;
+
+   size_t total() const
+   {
+      return hotBytes + coldBytes + heapBytes;
+   }
+
+   OptionMemoryUsage& operator+=( const OptionMemoryUsage& other )
+   {
+      hotBytes += other.hotBytes;
+      coldBytes += other.coldBytes;
+      heapBytes += other.heapBytes;
+      return *this;
+   }
+};
+
+// The memory used by the definitions of the options of a parser.  The
+// options of the commands are not included.
+struct ParserMemoryUsage
+{
+   size_t optionCount = 0;
+   // The sum of the memory used by the options.
+   OptionMemoryUsage options;
+   // The memory used by the pool of the interned strings.
+   size_t stringPoolBytes = 0;
+
+   size_t total() const
+   {
+      return options.total() + stringPoolBytes;
+   }
+
+   size_t perOption() const
+   {
+      return optionCount > 0 ? total() / optionCount : 0;
+   }
+};
+
+}   // namespace argumentum
@@ -0,0 +1,68 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+// The Levenshtein distance between a fixed pattern and other strings.  For
+// patterns with up to 64 characters the distance is computed with the
+// bit-parallel algorithm of Myers and Hyyrö which processes a column of the
+// distance matrix in a few word operations.  Longer patterns use a row of
+// the distance matrix.
+class EditDistance
+{
+   std::string mPattern;
+   std::array<uint64_t, 256> mPeq{};
+
+public:
+   explicit EditDistance( std::string_view pattern );
+
+   // Returns the distance between the pattern and @p text or `bound + 1` if
+   // the distance is greater than @p bound.  The computation stops as soon as
+   // the distance is known to exceed the bound.
+   size_t operator()( std::string_view text, size_t bound ) const;
+
+private:
+   size_t bitParallel( std::string_view text, size_t bound ) const;
+   size_t rowByRow( std::string_view text, size_t bound ) const;
+};
+
+// A BK-tree of names that finds the names within an edit distance of a
+// misspelled name.  The children of a node are keyed by their distance to
+// the node so the triangle inequality limits the search to the children
+// whose distance is close to the distance of the query.
+class NameSuggester
+{
+   struct Node
+   {
+      std::string name;
+      // (distance, node)
+      std::vector<std::pair<uint32_t, uint32_t>> children;
+      uint32_t maxChildDistance = 0;
+   };
+
+   std::vector<Node> mNodes;
+
+public:
+   // Add @p name to the tree.  Returns false if the name is already in the
+   // tree.
+   bool insert( std::string_view name );
+
+   // Returns at most @p limit names within the distance @p maxDistance of
+   // @p name ordered by the distance and by the name.
+   std::vector<std::string> suggest(
+         std::string_view name, size_t maxDistance, size_t limit ) const;
+
+   size_t size() const;
+   bool empty() const;
+   void clear();
+};
+
+}   // namespace argumentum
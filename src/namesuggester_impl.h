@@ -0,0 +1,178 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "namesuggester.h"
+
+#include <algorithm>
+
+namespace argumentum {
+
+ARGUMENTUM_INLINE EditDistance::EditDistance( std::string_view pattern )
+   : mPattern( pattern )
+{
+   if ( mPattern.size() <= 64 ) {
+      for ( size_t i = 0; i < mPattern.size(); ++i )
+         mPeq[static_cast<unsigned char>( mPattern[i] )] |= uint64_t( 1 ) << i;
+   }
+}
+
+ARGUMENTUM_INLINE size_t EditDistance::operator()( std::string_view text, size_t bound ) const
+{
+   auto lengthDiff = text.size() > mPattern.size() ? text.size() - mPattern.size()
+                                                   : mPattern.size() - text.size();
+   if ( lengthDiff > bound )
+      return bound + 1;
+   if ( mPattern.empty() )
+      return text.size();
+   if ( text.empty() )
+      return mPattern.size();
+
+   return mPattern.size() <= 64 ? bitParallel( text, bound ) : rowByRow( text, bound );
+}
+
+ARGUMENTUM_INLINE size_t EditDistance::bitParallel( std::string_view text, size_t bound ) const
+{
+   // Every bit of the vertical deltas Pv (+1) and Mv (-1) represents a row of
+   // the current column.  The score tracks the value in the last row.
+   auto size = mPattern.size();
+   auto last = uint64_t( 1 ) << ( size - 1 );
+   auto pv = size == 64 ? ~uint64_t( 0 ) : ( last << 1 ) - 1;
+   auto mv = uint64_t( 0 );
+   auto score = size;
+   auto remaining = text.size();
+
+   for ( auto ch : text ) {
+      auto eq = mPeq[static_cast<unsigned char>( ch )];
+      auto xv = eq | mv;
+      auto xh = ( ( ( eq & pv ) + pv ) ^ pv ) | eq;
+      auto ph = mv | ~( xh | pv );
+      auto mh = pv & xh;
+      if ( ph & last )
+         ++score;
+      else if ( mh & last )
+         --score;
+
+      // The first row of the matrix increases by one in every column.
+      ph = ( ph << 1 ) | 1;
+      mh <<= 1;
+      pv = mh | ~( xv | ph );
+      mv = ph & xv;
+
+      // The score can decrease by at most one per remaining character.
+      --remaining;
+      if ( score > remaining && score - remaining > bound )
+         return bound + 1;
+   }
+
+   return score;
+}
+
+ARGUMENTUM_INLINE size_t EditDistance::rowByRow( std::string_view text, size_t bound ) const
+{
+   std::vector<size_t> row( mPattern.size() + 1 );
+   for ( size_t i = 0; i < row.size(); ++i )
+      row[i] = i;
+
+   for ( size_t j = 0; j < text.size(); ++j ) {
+      auto diagonal = row[0];
+      row[0] = j + 1;
+      auto rowMin = row[0];
+      for ( size_t i = 1; i < row.size(); ++i ) {
+         auto above = row[i];
+         auto cost = mPattern[i - 1] == text[j] ? 0 : 1;
+         row[i] = std::min( { row[i - 1] + 1, above + 1, diagonal + cost } );
+         diagonal = above;
+         rowMin = std::min( rowMin, row[i] );
+      }
+      if ( rowMin > bound )
+         return bound + 1;
+   }
+
+   return std::min( row.back(), bound + 1 );
+}
+
+ARGUMENTUM_INLINE bool NameSuggester::insert( std::string_view name )
+{
+   if ( mNodes.empty() ) {
+      mNodes.push_back( { std::string( name ), {}, 0 } );
+      return true;
+   }
+
+   auto distance = EditDistance( name );
+   uint32_t node = 0;
+   while ( true ) {
+      auto d = uint32_t( distance( mNodes[node].name, SIZE_MAX - 1 ) );
+      if ( d == 0 )
+         return false;
+
+      auto& children = mNodes[node].children;
+      auto it = std::find_if(
+            children.begin(), children.end(), [d]( auto& child ) { return child.first == d; } );
+      if ( it != children.end() ) {
+         node = it->second;
+         continue;
+      }
+
+      auto child = uint32_t( mNodes.size() );
+      children.emplace_back( d, child );
+      mNodes[node].maxChildDistance = std::max( mNodes[node].maxChildDistance, d );
+      mNodes.push_back( { std::string( name ), {}, 0 } );
+      return true;
+   }
+}
+
+ARGUMENTUM_INLINE std::vector<std::string> NameSuggester::suggest(
+      std::string_view name, size_t maxDistance, size_t limit ) const
+{
+   std::vector<std::pair<size_t, const std::string*>> found;
+   if ( mNodes.empty() || limit == 0 )
+      return {};
+
+   auto distance = EditDistance( name );
+   std::vector<uint32_t> pending{ 0 };
+   while ( !pending.empty() ) {
+      auto& node = mNodes[pending.back()];
+      pending.pop_back();
+
+      // The distance is needed exactly only up to the point where it selects
+      // the children.
+      auto bound = maxDistance + node.maxChildDistance;
+      auto d = distance( node.name, bound );
+      if ( d <= maxDistance )
+         found.emplace_back( d, &node.name );
+      if ( d > bound )
+         continue;
+
+      for ( auto& [childDistance, child] : node.children )
+         if ( childDistance + maxDistance >= d && childDistance <= d + maxDistance )
+            pending.push_back( child );
+   }
+
+   std::sort( found.begin(), found.end(), []( auto& a, auto& b ) {
+      return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+   } );
+
+   std::vector<std::string> names;
+   for ( size_t i = 0; i < found.size() && i < limit; ++i )
+      names.push_back( *found[i].second );
+   return names;
+}
+
+ARGUMENTUM_INLINE size_t NameSuggester::size() const
+{
+   return mNodes.size();
+}
+
+ARGUMENTUM_INLINE bool NameSuggester::empty() const
+{
+   return mNodes.empty();
+}
+
+ARGUMENTUM_INLINE void NameSuggester::clear()
+{
+   mNodes.clear();
+}
+
+}   // namespace argumentum
@@ -0,0 +1,54 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+// A compressed prefix tree (radix tree) that maps names to integer values.
+// The edges are labelled with strings so a chain of nodes with a single child
+// is stored as one node.  The children of a node are sorted by the first
+// character of their labels, therefore the names with a given prefix are
+// visited in lexicographic order.
+class NameTrie
+{
+   struct Node
+   {
+      std::string label;
+      std::vector<uint32_t> children;
+      int value = -1;
+   };
+
+   std::vector<Node> mNodes;
+   size_t mSize = 0;
+
+public:
+   NameTrie();
+
+   // Add @p name with @p value to the trie.  Returns false if the name is
+   // already in the trie.
+   bool insert( std::string_view name, int value );
+
+   // Returns the value of @p name or -1 if the name is not in the trie.
+   int find( std::string_view name ) const;
+
+   // Returns the values of all the names that start with @p prefix in the
+   // lexicographic order of the names.  At most @p limit values are returned.
+   std::vector<int> findPrefixed( std::string_view prefix, size_t limit = SIZE_MAX ) const;
+
+   size_t size() const;
+   bool empty() const;
+   void clear();
+
+private:
+   int findChild( const Node& node, char first ) const;
+   // Returns the node where the names with @p prefix start or -1.
+   int findPrefixNode( std::string_view prefix ) const;
+};
+
+}   // namespace argumentum
@@ -0,0 +1,164 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "nametrie.h"
+
+#include <algorithm>
+
+namespace argumentum {
+
+namespace detail {
+ARGUMENTUM_INLINE size_t commonPrefixLength( std::string_view a, std::string_view b )
+{
+   auto res = std::mismatch( a.begin(), a.begin() + std::min( a.size(), b.size() ), b.begin() );
+   return res.first - a.begin();
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE NameTrie::NameTrie()
+{
+   mNodes.emplace_back();
+}
+
+ARGUMENTUM_INLINE bool NameTrie::insert( std::string_view name, int value )
+{
+   uint32_t node = 0;
+   auto rest = name;
+   while ( !rest.empty() ) {
+      auto ichild = findChild( mNodes[node], rest[0] );
+      if ( ichild < 0 ) {
+         auto leaf = uint32_t( mNodes.size() );
+         mNodes.emplace_back();
+         mNodes[leaf].label = std::string( rest );
+         mNodes[leaf].value = value;
+
+         auto& children = mNodes[node].children;
+         auto pos = std::lower_bound( children.begin(), children.end(), rest[0],
+               [this]( uint32_t child, char first ) { return mNodes[child].label[0] < first; } );
+         children.insert( pos, leaf );
+         ++mSize;
+         return true;
+      }
+
+      auto child = uint32_t( ichild );
+      auto common = detail::commonPrefixLength( mNodes[child].label, rest );
+      if ( common < mNodes[child].label.size() ) {
+         // Split the edge: the common part is moved to a new node that
+         // replaces the child.
+         auto middle = uint32_t( mNodes.size() );
+         mNodes.emplace_back();
+         mNodes[middle].label = mNodes[child].label.substr( 0, common );
+         mNodes[middle].children.push_back( child );
+         mNodes[child].label.erase( 0, common );
+
+         auto& children = mNodes[node].children;
+         *std::find( children.begin(), children.end(), child ) = middle;
+         child = middle;
+      }
+
+      node = child;
+      rest.remove_prefix( common );
+   }
+
+   if ( mNodes[node].value >= 0 || node == 0 )
+      return false;
+
+   mNodes[node].value = value;
+   ++mSize;
+   return true;
+}
+
+ARGUMENTUM_INLINE int NameTrie::find( std::string_view name ) const
+{
+   uint32_t node = 0;
+   auto rest = name;
+   while ( !rest.empty() ) {
+      auto child = findChild( mNodes[node], rest[0] );
+      if ( child < 0 )
+         return -1;
+
+      auto& label = mNodes[child].label;
+      if ( rest.substr( 0, label.size() ) != label )
+         return -1;
+
+      node = child;
+      rest.remove_prefix( label.size() );
+   }
+
+   return node == 0 ? -1 : mNodes[node].value;
+}
+
+ARGUMENTUM_INLINE std::vector<int> NameTrie::findPrefixed(
+      std::string_view prefix, size_t limit ) const
+{
+   std::vector<int> values;
+   auto start = findPrefixNode( prefix );
+   if ( start < 0 )
+      return values;
+
+   // Depth-first traversal in the order of the children.
+   std::vector<uint32_t> stack{ uint32_t( start ) };
+   while ( !stack.empty() && values.size() < limit ) {
+      auto& node = mNodes[stack.back()];
+      stack.pop_back();
+      if ( node.value >= 0 )
+         values.push_back( node.value );
+      stack.insert( stack.end(), node.children.rbegin(), node.children.rend() );
+   }
+
+   return values;
+}
+
+ARGUMENTUM_INLINE size_t NameTrie::size() const
+{
+   return mSize;
+}
+
+ARGUMENTUM_INLINE bool NameTrie::empty() const
+{
+   return mSize == 0;
+}
+
+ARGUMENTUM_INLINE void NameTrie::clear()
+{
+   mNodes.resize( 1 );
+   mNodes[0].children.clear();
+   mSize = 0;
+}
+
+ARGUMENTUM_INLINE int NameTrie::findChild( const Node& node, char first ) const
+{
+   auto& children = node.children;
+   auto it = std::lower_bound( children.begin(), children.end(), first,
+         [this]( uint32_t child, char ch ) { return mNodes[child].label[0] < ch; } );
+   if ( it == children.end() || mNodes[*it].label[0] != first )
+      return -1;
+   return int( *it );
+}
+
+ARGUMENTUM_INLINE int NameTrie::findPrefixNode( std::string_view prefix ) const
+{
+   uint32_t node = 0;
+   auto rest = prefix;
+   while ( !rest.empty() ) {
+      auto child = findChild( mNodes[node], rest[0] );
+      if ( child < 0 )
+         return -1;
+
+      auto& label = mNodes[child].label;
+      auto common = detail::commonPrefixLength( label, rest );
+      if ( common == rest.size() )
+         return child;
+      if ( common < label.size() )
+         return -1;
+
+      node = child;
+      rest.remove_prefix( common );
+   }
+
+   return int( node );
+}
+
+}   // namespace argumentum
@@ -3,16 +3,20 @@
 
 #pragma once
 
-#include <iostream>
+#include <cstdio>
+#include <string>
+#include <string_view>
 
 namespace argumentum {
 
 class Notifier
 {
 public:
+   // The warnings are written to stderr with a single write.
    static void warn( std::string_view text )
    {
-      std::cerr << "** " << text << "\n";
+      auto message = "** " + std::string( text ) + "\n";
+      std::fwrite( message.data(), 1, message.size(), stderr );
    }
 };
 
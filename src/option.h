@@ -3,43 +3,84 @@
 
 #pragma once
 
+#include "memoryusage.h"
+#include "parserconfig.h"
 #include "value.h"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace argumentum {
 
+class Option;
 class OptionGroup;
+class StringPool;
+
+// The state that a parser definition shares with its options.
+//
+// The parses of a parser are numbered.  The options and the values remember
+// the number of the parse in which they were last used and the state left by
+// an earlier parse is reset when they are used again.
+//
+// The options report the changes of their configuration so that the parser
+// definition can rebuild its indices before the next parse.
+struct DefinitionState
+{
+   uint64_t parseNumber = 1;
+   // The options that are reset on touch and were used in the current parse.
+   std::vector<Option*> touched;
+   // The options were added or configured after the indices were built.
+   bool isChanged = true;
+   // The names of the indexed options changed after they were indexed.
+   bool areNamesChanged = false;
+};
 
 class Option
 {
    friend class OptionFactory;
+   friend class DefinitionCache;
 
 public:
    enum Kind { singleValue, vectorValue };
 
 private:
+   // The data that is needed to define the option and to describe it in the
+   // help.  It is stored outside of the option so that the fields used by the
+   // parser share fewer cache lines.  The descriptive texts are interned in the
+   // string pool.
+   struct Description
+   {
+      std::vector<std::string_view> metavar;
+      std::string_view help;
+      std::string_view flagValue = "1";
+      std::vector<std::string_view> choices;
+      // The environment variable that provides the value when the option is
+      // not present in the input arguments.
+      std::string envName;
+      std::shared_ptr<OptionGroup> pGroup;
+      AssignAction assignAction;
+      AssignDefaultAction assignDefaultAction;
+      std::shared_ptr<StringPool> pStrings;
+      // The reset mode of the target when it differs from the parser's.
+      std::optional<EValueReset> valueReset;
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+      // The errors in the configuration of the option.
+      std::vector<std::string> definitionErrors;
+#endif
+   };
+
    std::shared_ptr<Value> mpValue;
-   AssignAction mAssignAction;
-   AssignDefaultAction mAssignDefaultAction;
+   std::unique_ptr<Description> mpDescription;
+   // The names are read when the options are looked up.
    std::string mShortName;
    std::string mLongName;
-   std::vector<std::string> mMetavar;
-   std::string mHelp;
-   std::string mFlagValue = "1";
-   std::vector<std::string> mChoices;
-   std::shared_ptr<OptionGroup> mpGroup;
    int mMinArgs = 0;
    int mMaxArgs = 0;
-   bool mIsRequired = false;
-   bool mIsVectorValue = false;
-
-   // The parameter of this option is forwarded.  The parameter is defined after a comma.
-   bool mIsForwarded = false;
 
    // The number of asignments through the option that is currently active in
    // the parser.
@@ -48,6 +89,34 @@ private:
    // The total number of assignments through this option.
    int mTotalAssignCount = 0;
 
+   // The dense index of the option in the validator of its parser.
+   int mIndex = -1;
+
+   // The state of the parser that owns the option and the number of the
+   // parse in which the assign counts were last changed.  The counts from an
+   // earlier parse are read as zero.
+   std::shared_ptr<DefinitionState> mpState;
+   uint64_t mEpoch = 0;
+
+   // The target is reset when the option is first used in a parse instead of
+   // when the parse starts.
+   bool mResetsOnTouch = false;
+
+   bool mIsRequired = false;
+   bool mIsVectorValue = false;
+
+   // The parameter of this option is forwarded.  The parameter is defined after a comma.
+   bool mIsForwarded = false;
+
+   // The values from all the value sources are appended instead of using only
+   // the values from the source with the highest precedence.
+   bool mAppendsSources = false;
+
+   // Copies of !choices.empty() and the presence of the assign action from the
+   // description for the parser.
+   bool mHasChoices = false;
+   bool mHasAssignAction = false;
+
 public:
    void setShortName( std::string_view name );
    void setLongName( std::string_view name );
@@ -63,6 +132,26 @@ public:
    void setAssignDefaultAction( AssignDefaultAction action );
    void setGroup( const std::shared_ptr<OptionGroup>& pGroup );
    void setForwarded( bool isForwarded = true );
+   void setEnvName( std::string_view name );
+   void setAppendsSources( bool appends );
+   void setDeferredConversion( unsigned threadCount );
+   void setValueReset( EValueReset reset );
+   std::optional<EValueReset> getValueReset() const;
+
+   // Set the state of the parser that owns the option.  Without it the
+   // option is always in the current parse.
+   void setDefinitionState( const std::shared_ptr<DefinitionState>& pState );
+   void setResetsOnTouch( bool resetsOnTouch );
+
+   // Store the descriptive texts of the option in @p pStrings.  The texts
+   // that were already set are moved to the pool.
+   void setStringPool( const std::shared_ptr<StringPool>& pStrings );
+
+   // Store an error in the configuration of the option.  The errors are
+   // stored only when the exceptions are disabled; otherwise they are thrown
+   // by the configuration methods.
+   void addDefinitionError( std::string_view message );
+   std::vector<std::string> getDefinitionErrors() const;
    bool isRequired() const;
    bool isPositional() const;
    bool isShortNumeric() const;
@@ -71,17 +160,38 @@ public:
    const std::string& getLongName() const;
    std::string getHelpName() const;
    bool hasName( std::string_view name ) const;
-   const std::string& getRawHelp() const;
+   std::string_view getRawHelp() const;
    std::vector<std::string> getMetavar() const;
-   void setValue( std::string_view value, Environment& env );
+
+   // Returns true if setMetavar( @p varnames ) would not change the metavars.
+   bool hasMetavar( const std::vector<std::string_view>& varnames ) const;
+   AssignStatus setValue( std::string_view value, Environment& env );
 
    /**
     * Called when an option was started but no values followed.
     */
-   void autoSetMissingValue( Environment& env );
+   AssignStatus autoSetMissingValue( Environment& env );
    void assignDefault();
    bool hasDefault() const;
    void resetValue();
+
+   /**
+    * Prepare the value of the option to receive @p count more arguments.  The
+    * count is limited by the number of arguments the option can still accept.
+    */
+   void reserveValues( size_t count );
+
+   /**
+    * Called when the parser has processed all the input arguments.  Converts
+    * the arguments that were stored because of deferred conversion and closes
+    * sink targets.
+    *
+    * @returns the positions of the arguments that could not be converted.
+    */
+   std::vector<size_t> finishAssignments();
+
+   // Close a sink target when the parse is abandoned.
+   void closeTarget();
    void onOptionStarted();
    bool acceptsAnyArguments() const;
    bool willAcceptArgument() const;
@@ -89,6 +199,9 @@ public:
    bool hasVectorValue() const;
    bool isForwarded() const;
 
+   // Returns false if the option only runs an action, eg. a help option.
+   bool hasTarget() const;
+
    /**
     * @returns true if the value was assigned through any option that shares
     * this option's value.
@@ -96,20 +209,47 @@ public:
    bool wasAssigned() const;
 
    bool wasAssignedThroughThisOption() const;
-   const std::string& getFlagValue() const;
+   void setIndex( int index );
+   int getIndex() const;
+   std::string_view getFlagValue() const;
+   const std::vector<std::string_view>& getChoices() const;
+   const std::string& getEnvName() const;
+   bool appendsSources() const;
+   int getAssignCount() const;
    std::tuple<int, int> getArgumentCounts() const;
-   std::shared_ptr<OptionGroup> getGroup() const;
+   const std::shared_ptr<OptionGroup>& getGroup() const;
+   OptionMemoryUsage getMemoryUsage() const;
 
    ValueId getValueId() const;
    TargetId getTargetId() const;
 
+   Option( const Option& other );
+   Option( Option&& other ) = default;
+   Option& operator=( const Option& other );
+   Option& operator=( Option&& other ) = default;
+
 private:
    Option( std::shared_ptr<Value>&& pValue, Kind kind )
       : mpValue( std::move( pValue ) )
+      , mpDescription( std::make_unique<Description>() )
       , mIsVectorValue( kind == Option::vectorValue )
    {
       assert( mpValue != nullptr );
    }
+
+   std::string_view intern( std::string_view text );
+   static std::string cleanVarName( std::string_view name );
+
+   // Notify the parser that owns the option that its indices must be rebuilt.
+   void markDefinitionChanged();
+
+   // Returns true if the assign counts were changed in the current parse.
+   bool isInCurrentEpoch() const;
+   int getCurrentAssignCount() const;
+
+   // Reset the assign counts and possibly the target if they were last
+   // changed in an earlier parse.
+   void enterCurrentEpoch();
 };
 
 }   // namespace argumentum
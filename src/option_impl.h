@@ -7,113 +7,250 @@
 
 #include "exceptions.h"
 #include "group.h"
+#include "stringpool.h"
 
 #include <cstdarg>
 
 namespace argumentum {
 
+ARGUMENTUM_INLINE Option::Option( const Option& other )
+   : mpValue( other.mpValue )
+   , mpDescription( std::make_unique<Description>( *other.mpDescription ) )
+   , mShortName( other.mShortName )
+   , mLongName( other.mLongName )
+   , mMinArgs( other.mMinArgs )
+   , mMaxArgs( other.mMaxArgs )
+   , mCurrentAssignCount( other.mCurrentAssignCount )
+   , mTotalAssignCount( other.mTotalAssignCount )
+   , mIndex( other.mIndex )
+   , mpState( other.mpState )
+   , mEpoch( other.mEpoch )
+   , mResetsOnTouch( other.mResetsOnTouch )
+   , mIsRequired( other.mIsRequired )
+   , mIsVectorValue( other.mIsVectorValue )
+   , mIsForwarded( other.mIsForwarded )
+   , mAppendsSources( other.mAppendsSources )
+   , mHasChoices( other.mHasChoices )
+   , mHasAssignAction( other.mHasAssignAction )
+{}
+
+ARGUMENTUM_INLINE Option& Option::operator=( const Option& other )
+{
+   if ( this != &other )
+      *this = Option( other );
+   return *this;
+}
+
+ARGUMENTUM_INLINE std::string_view Option::intern( std::string_view text )
+{
+   auto& pStrings = mpDescription->pStrings;
+   if ( !pStrings )
+      pStrings = std::make_shared<StringPool>();
+   return pStrings->intern( text );
+}
+
+ARGUMENTUM_INLINE void Option::setStringPool( const std::shared_ptr<StringPool>& pStrings )
+{
+   auto& desc = *mpDescription;
+   if ( desc.pStrings == pStrings )
+      return;
+
+   desc.pStrings = pStrings;
+   desc.help = intern( desc.help );
+   desc.flagValue = intern( desc.flagValue );
+   for ( auto& var : desc.metavar )
+      var = intern( var );
+   for ( auto& choice : desc.choices )
+      choice = intern( choice );
+}
+
+// The names of the options, but not of the positional parameters, are indexed
+// by the parser.
 ARGUMENTUM_INLINE void Option::setShortName( std::string_view name )
 {
+   markDefinitionChanged();
+   if ( mpState && !isPositional() )
+      mpState->areNamesChanged = true;
    mShortName = name;
 }
 
 ARGUMENTUM_INLINE void Option::setLongName( std::string_view name )
 {
+   markDefinitionChanged();
+   if ( mpState && !isPositional() )
+      mpState->areNamesChanged = true;
    mLongName = name;
 }
 
-ARGUMENTUM_INLINE void Option::setMetavar( const std::vector<std::string_view>& varnames )
+ARGUMENTUM_INLINE std::string Option::cleanVarName( std::string_view v )
 {
-   auto cleanVarName( []( std::string_view v ) -> std::string {
-      size_t b = 0;
-      size_t e = v.size();
-      while ( b < e && ( std::isspace( v[b] ) || v[b] == '-' ) )
-         ++b;
-      while ( b < e && std::isspace( v[e - 1] ) )
-         --e;
-
-      if ( b >= e )
-         return {};
-
-      std::string res;
-      res.reserve( e - b );
-      std::transform( v.begin() + b, v.begin() + e, std::back_inserter( res ), []( char c ) {
-         return std::isspace( c ) ? '_' : c;
-      } );
-      return res;
+   size_t b = 0;
+   size_t e = v.size();
+   while ( b < e && ( std::isspace( v[b] ) || v[b] == '-' ) )
+      ++b;
+   while ( b < e && std::isspace( v[e - 1] ) )
+      --e;
+
+   if ( b >= e )
+      return {};
+
+   std::string res;
+   res.reserve( e - b );
+   std::transform( v.begin() + b, v.begin() + e, std::back_inserter( res ), []( char c ) {
+      return std::isspace( c ) ? '_' : c;
    } );
+   return res;
+}
 
-   mMetavar.clear();
+ARGUMENTUM_INLINE void Option::setMetavar( const std::vector<std::string_view>& varnames )
+{
+   markDefinitionChanged();
+   auto& metavar = mpDescription->metavar;
+   metavar.clear();
    for ( const auto& v : varnames ) {
       auto cv = cleanVarName( v );
       if ( !cv.empty() )
-         mMetavar.push_back( std::move( cv ) );
+         metavar.push_back( intern( cv ) );
+   }
+}
+
+ARGUMENTUM_INLINE bool Option::hasMetavar( const std::vector<std::string_view>& varnames ) const
+{
+   auto& metavar = mpDescription->metavar;
+   auto it = metavar.begin();
+   for ( const auto& v : varnames ) {
+      auto cv = cleanVarName( v );
+      if ( cv.empty() )
+         continue;
+      if ( it == metavar.end() || *it != cv )
+         return false;
+      ++it;
    }
+   return it == metavar.end();
 }
 
 ARGUMENTUM_INLINE void Option::setHelp( std::string_view help )
 {
-   mHelp = help;
+   markDefinitionChanged();
+   mpDescription->help = intern( help );
 }
 
 ARGUMENTUM_INLINE void Option::setNArgs( int count )
 {
+   markDefinitionChanged();
    mMinArgs = std::max( 0, count );
    mMaxArgs = mMinArgs;
 }
 
 ARGUMENTUM_INLINE void Option::setMinArgs( int count )
 {
+   markDefinitionChanged();
    mMinArgs = std::max( 0, count );
    mMaxArgs = -1;
 }
 
 ARGUMENTUM_INLINE void Option::setMaxArgs( int count )
 {
+   markDefinitionChanged();
    mMinArgs = 0;
    mMaxArgs = std::max( 0, count );
 }
 
 ARGUMENTUM_INLINE void Option::setRequired( bool isRequired )
 {
+   markDefinitionChanged();
    mIsRequired = isRequired;
 }
 
 ARGUMENTUM_INLINE void Option::setFlagValue( std::string_view value )
 {
-   mFlagValue = value;
+   markDefinitionChanged();
+   mpDescription->flagValue = intern( value );
 }
 
 ARGUMENTUM_INLINE void Option::setChoices( const std::vector<std::string>& choices )
 {
-   mChoices = choices;
+   markDefinitionChanged();
+   auto& pooled = mpDescription->choices;
+   pooled.clear();
+   pooled.reserve( choices.size() );
+   for ( auto& choice : choices )
+      pooled.push_back( intern( choice ) );
+   mHasChoices = !pooled.empty();
 }
 
 ARGUMENTUM_INLINE void Option::setAction( AssignAction action )
 {
-   mAssignAction = action;
+   markDefinitionChanged();
+   mpDescription->assignAction = std::move( action );
+   mHasAssignAction = mpDescription->assignAction != nullptr;
 }
 
 ARGUMENTUM_INLINE void Option::setAssignDefaultAction( AssignDefaultAction action )
 {
-   mAssignDefaultAction = action;
+   markDefinitionChanged();
+   mpDescription->assignDefaultAction = std::move( action );
 }
 
 ARGUMENTUM_INLINE void Option::setGroup( const std::shared_ptr<OptionGroup>& pGroup )
 {
-   mpGroup = pGroup;
+   markDefinitionChanged();
+   mpDescription->pGroup = pGroup;
 }
 
 ARGUMENTUM_INLINE void Option::setForwarded( bool isForwarded )
 {
+   markDefinitionChanged();
    mIsForwarded = isForwarded;
 }
 
+ARGUMENTUM_INLINE void Option::setDeferredConversion( unsigned threadCount )
+{
+   markDefinitionChanged();
+   mpValue->setDeferred( threadCount );
+}
+
+ARGUMENTUM_INLINE void Option::setEnvName( std::string_view name )
+{
+   markDefinitionChanged();
+   mpDescription->envName = name;
+}
+
+ARGUMENTUM_INLINE void Option::setAppendsSources( bool appends )
+{
+   markDefinitionChanged();
+   mAppendsSources = appends;
+}
+
 ARGUMENTUM_INLINE bool Option::isForwarded() const
 {
    return mIsForwarded;
 }
 
+ARGUMENTUM_INLINE bool Option::hasTarget() const
+{
+   return VoidValue::value_cast( *mpValue ) == nullptr;
+}
+
+ARGUMENTUM_INLINE void Option::addDefinitionError( [[maybe_unused]] std::string_view message )
+{
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   // The same error may be found by multiple verifications.
+   auto& errors = mpDescription->definitionErrors;
+   if ( std::find( errors.begin(), errors.end(), message ) == errors.end() )
+      errors.emplace_back( message );
+#endif
+}
+
+ARGUMENTUM_INLINE std::vector<std::string> Option::getDefinitionErrors() const
+{
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   return mpDescription->definitionErrors;
+#else
+   return {};
+#endif
+}
+
 ARGUMENTUM_INLINE bool Option::isRequired() const
 {
    return mIsRequired;
@@ -146,12 +283,14 @@ ARGUMENTUM_INLINE const std::string& Option::getLongName() const
 
 ARGUMENTUM_INLINE std::string Option::getHelpName() const
 {
+   auto& desc = *mpDescription;
    if ( isPositional() ) {
-      // TODO: mMetavar should no longer be used as helpName since we do not
+      // TODO: metavar should no longer be used as helpName since we do not
       // know which name to choose.  Maybe help name should be set separately (.helpname).
-      const auto& name =
-            !mMetavar.empty() ? mMetavar[0] : ( !mLongName.empty() ? mLongName : mShortName );
-      return !name.empty() ? name : "ARG";
+      std::string_view name = !desc.metavar.empty()
+            ? desc.metavar[0]
+            : ( !mLongName.empty() ? mLongName : mShortName );
+      return !name.empty() ? std::string( name ) : "ARG";
    }
    return !mLongName.empty() ? mLongName : mShortName;
 }
@@ -161,15 +300,16 @@ ARGUMENTUM_INLINE bool Option::hasName( std::string_view name ) const
    return name == mShortName || name == mLongName;
 }
 
-ARGUMENTUM_INLINE const std::string& Option::getRawHelp() const
+ARGUMENTUM_INLINE std::string_view Option::getRawHelp() const
 {
-   return mHelp;
+   return mpDescription->help;
 }
 
 ARGUMENTUM_INLINE std::vector<std::string> Option::getMetavar() const
 {
-   if ( !mMetavar.empty() )
-      return mMetavar;
+   auto& metavars = mpDescription->metavar;
+   if ( !metavars.empty() )
+      return { metavars.begin(), metavars.end() };
 
    auto& name = getName();
    auto pos = name.find_first_not_of( "-" );
@@ -181,40 +321,47 @@ ARGUMENTUM_INLINE std::vector<std::string> Option::getMetavar() const
    return { metavar };
 }
 
-ARGUMENTUM_INLINE void Option::setValue( std::string_view value, Environment& env )
+ARGUMENTUM_INLINE AssignStatus Option::setValue( std::string_view value, Environment& env )
 {
+   enterCurrentEpoch();
    ++mCurrentAssignCount;
    ++mTotalAssignCount;
 
-   if ( !mChoices.empty() && std::none_of( mChoices.begin(), mChoices.end(), [&value]( auto v ) {
-           return v == value;
-        } ) ) {
-      mpValue->markBadArgument();
-      throw InvalidChoiceError( value );
+   if ( mHasChoices ) {
+      auto& choices = mpDescription->choices;
+      if ( std::find( choices.begin(), choices.end(), value ) == choices.end() ) {
+         mpValue->markBadArgument();
+         return { EConversionError::invalidChoice, {} };
+      }
    }
 
-   // If mAssignAction is not set, mpValue->setValue will try to use a default
-   // action.
-   mpValue->setValue( value, mAssignAction, env );
+   // If the assign action is not set, mpValue->setValue will try to use a
+   // default action.
+   static const AssignAction noAction;
+   return mpValue->setValue(
+         value, mHasAssignAction ? mpDescription->assignAction : noAction, env );
 }
 
-ARGUMENTUM_INLINE void Option::autoSetMissingValue( Environment& env )
+ARGUMENTUM_INLINE AssignStatus Option::autoSetMissingValue( Environment& env )
 {
+   enterCurrentEpoch();
    ++mCurrentAssignCount;
    ++mTotalAssignCount;
 
-   mpValue->setMissingValue( getFlagValue(), env );
+   return mpValue->setMissingValue( getFlagValue(), env );
 }
 
 ARGUMENTUM_INLINE void Option::assignDefault()
 {
-   if ( mAssignDefaultAction )
-      mpValue->setDefault( mAssignDefaultAction );
+   if ( mpDescription->assignDefaultAction ) {
+      enterCurrentEpoch();
+      mpValue->setDefault( mpDescription->assignDefaultAction );
+   }
 }
 
 ARGUMENTUM_INLINE bool Option::hasDefault() const
 {
-   return mAssignDefaultAction != nullptr;
+   return mpDescription->assignDefaultAction != nullptr;
 }
 
 ARGUMENTUM_INLINE void Option::resetValue()
@@ -224,8 +371,29 @@ ARGUMENTUM_INLINE void Option::resetValue()
    mpValue->reset();
 }
 
+ARGUMENTUM_INLINE void Option::reserveValues( size_t count )
+{
+   enterCurrentEpoch();
+   if ( mMaxArgs >= 0 )
+      count = std::min<size_t>( count, std::max( 0, mMaxArgs - mCurrentAssignCount ) );
+
+   if ( count > 1 )
+      mpValue->reserve( count );
+}
+
+ARGUMENTUM_INLINE std::vector<size_t> Option::finishAssignments()
+{
+   return mpValue->finishAssignments();
+}
+
+ARGUMENTUM_INLINE void Option::closeTarget()
+{
+   mpValue->closeTarget();
+}
+
 ARGUMENTUM_INLINE void Option::onOptionStarted()
 {
+   enterCurrentEpoch();
    mCurrentAssignCount = 0;
    mpValue->onOptionStarted();
 }
@@ -237,12 +405,12 @@ ARGUMENTUM_INLINE bool Option::acceptsAnyArguments() const
 
 ARGUMENTUM_INLINE bool Option::willAcceptArgument() const
 {
-   return mMaxArgs < 0 || mCurrentAssignCount < mMaxArgs;
+   return mMaxArgs < 0 || getCurrentAssignCount() < mMaxArgs;
 }
 
 ARGUMENTUM_INLINE bool Option::needsMoreArguments() const
 {
-   return mCurrentAssignCount < mMinArgs;
+   return getCurrentAssignCount() < mMinArgs;
 }
 
 ARGUMENTUM_INLINE bool Option::hasVectorValue() const
@@ -252,17 +420,100 @@ ARGUMENTUM_INLINE bool Option::hasVectorValue() const
 
 ARGUMENTUM_INLINE bool Option::wasAssigned() const
 {
+   if ( mpState && mpValue->getEpoch() != mpState->parseNumber )
+      return false;
    return mpValue->getAssignCount() > 0;
 }
 
 ARGUMENTUM_INLINE bool Option::wasAssignedThroughThisOption() const
 {
-   return mTotalAssignCount > 0;
+   return isInCurrentEpoch() && mTotalAssignCount > 0;
 }
 
-ARGUMENTUM_INLINE const std::string& Option::getFlagValue() const
+ARGUMENTUM_INLINE void Option::setIndex( int index )
 {
-   return mFlagValue;
+   mIndex = index;
+}
+
+ARGUMENTUM_INLINE int Option::getIndex() const
+{
+   return mIndex;
+}
+
+ARGUMENTUM_INLINE std::string_view Option::getFlagValue() const
+{
+   return mpDescription->flagValue;
+}
+
+ARGUMENTUM_INLINE const std::vector<std::string_view>& Option::getChoices() const
+{
+   return mpDescription->choices;
+}
+
+ARGUMENTUM_INLINE const std::string& Option::getEnvName() const
+{
+   return mpDescription->envName;
+}
+
+ARGUMENTUM_INLINE bool Option::appendsSources() const
+{
+   return mAppendsSources;
+}
+
+ARGUMENTUM_INLINE int Option::getAssignCount() const
+{
+   return isInCurrentEpoch() ? mTotalAssignCount : 0;
+}
+
+ARGUMENTUM_INLINE void Option::setValueReset( EValueReset reset )
+{
+   markDefinitionChanged();
+   mpDescription->valueReset = reset;
+}
+
+ARGUMENTUM_INLINE std::optional<EValueReset> Option::getValueReset() const
+{
+   return mpDescription->valueReset;
+}
+
+ARGUMENTUM_INLINE void Option::setDefinitionState(
+      const std::shared_ptr<DefinitionState>& pState )
+{
+   mpState = pState;
+}
+
+ARGUMENTUM_INLINE void Option::setResetsOnTouch( bool resetsOnTouch )
+{
+   mResetsOnTouch = resetsOnTouch;
+}
+
+ARGUMENTUM_INLINE void Option::markDefinitionChanged()
+{
+   if ( mpState )
+      mpState->isChanged = true;
+}
+
+ARGUMENTUM_INLINE bool Option::isInCurrentEpoch() const
+{
+   return !mpState || mEpoch == mpState->parseNumber;
+}
+
+ARGUMENTUM_INLINE int Option::getCurrentAssignCount() const
+{
+   return isInCurrentEpoch() ? mCurrentAssignCount : 0;
+}
+
+ARGUMENTUM_INLINE void Option::enterCurrentEpoch()
+{
+   if ( isInCurrentEpoch() )
+      return;
+
+   mEpoch = mpState->parseNumber;
+   mCurrentAssignCount = 0;
+   mTotalAssignCount = 0;
+   mpValue->enterEpoch( mEpoch, mResetsOnTouch );
+   if ( mResetsOnTouch )
+      mpState->touched.push_back( this );
 }
 
 ARGUMENTUM_INLINE std::tuple<int, int> Option::getArgumentCounts() const
@@ -270,9 +521,32 @@ ARGUMENTUM_INLINE std::tuple<int, int> Option::getArgumentCounts() const
    return std::make_tuple( mMinArgs, mMaxArgs );
 }
 
-ARGUMENTUM_INLINE std::shared_ptr<OptionGroup> Option::getGroup() const
+ARGUMENTUM_INLINE const std::shared_ptr<OptionGroup>& Option::getGroup() const
 {
-   return mpGroup;
+   return mpDescription->pGroup;
+}
+
+ARGUMENTUM_INLINE OptionMemoryUsage Option::getMemoryUsage() const
+{
+   // The characters of a short string are stored in the string object.  The
+   // check assumes that the characters of a short string are stored inside
+   // the object, as in libstdc++ and libc++; with other implementations the
+   // heap bytes may be misreported.
+   auto heapBytes = []( const std::string& text ) -> size_t {
+      auto pData = reinterpret_cast<const char*>( text.data() );
+      auto pObject = reinterpret_cast<const char*>( &text );
+      auto isLocal = pData >= pObject && pData < pObject + sizeof( text );
+      return isLocal ? 0 : text.capacity() + 1;
+   };
+
+   auto& desc = *mpDescription;
+   OptionMemoryUsage usage;
+   usage.hotBytes = sizeof( Option );
+   usage.coldBytes = sizeof( Description );
+   usage.heapBytes = heapBytes( mShortName ) + heapBytes( mLongName )
+         + heapBytes( desc.envName ) + desc.metavar.capacity() * sizeof( std::string_view )
+         + desc.choices.capacity() * sizeof( std::string_view );
+   return usage;
 }
 
 ARGUMENTUM_INLINE ValueId Option::getValueId() const
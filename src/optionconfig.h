@@ -5,8 +5,12 @@
 
 #include "option.h"
 
+#include <algorithm>
+#include <tuple>
+
 namespace argumentum {
 
+class DefinitionCache;
 class ParameterConfig;
 
 /**
@@ -19,6 +23,16 @@ class OptionConfig
 private:
    std::shared_ptr<Option> mpOption;
    bool mCountWasSet = false;
+   // split() is implemented with an action so it can not be combined with
+   // action().
+   bool mActionWasSet = false;
+   bool mIsSplit = false;
+
+   // The metadata of the option was restored from @p mpCache so the methods
+   // that set the same metadata have no effect.  A method that sets a
+   // different value invalidates the cache and configures the option.
+   bool mIsCached = false;
+   std::shared_ptr<DefinitionCache> mpCache;
 
 protected:
    OptionConfig( const OptionConfig& ) = default;
@@ -26,9 +40,28 @@ protected:
    OptionConfig( const std::shared_ptr<Option>& pOption );
 
    Option& getOption() const;
+   bool isCached() const;
+   void dropCache();
+
+   // Returns true if the option has to be configured.  A cached option is
+   // configured only if @p isSameAsCached returns false.
+   template<typename TIsSame>
+   bool needsConfiguration( TIsSame&& isSameAsCached )
+   {
+      if ( !mIsCached )
+         return true;
+      if ( isSameAsCached() )
+         return false;
+      dropCache();
+      return true;
+   }
+
    void markCountWasSet();
    void ensureCountWasNotSet() const;
    void ensureCanBeForwarded() const;
+   void ensureHasVectorValue() const;
+   bool canSetAction( bool isSplit );
+   void failDefinition( const char* message ) const;
 };
 
 template<typename TDerived>
@@ -42,13 +75,17 @@ public:
 public:
    this_t& setShortName( std::string_view name )
    {
-      getOption().setShortName( name );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.getShortName() == name; } ) )
+         option.setShortName( name );
       return *static_cast<this_t*>( this );
    }
 
    this_t& setLongName( std::string_view name )
    {
-      getOption().setLongName( name );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.getLongName() == name; } ) )
+         option.setLongName( name );
       return *static_cast<this_t*>( this );
    }
 
@@ -58,7 +95,7 @@ public:
    // @p varname a string or a vector of strings.
    this_t& metavar( std::string_view varname )
    {
-      getOption().setMetavar( { varname } );
+      return metavar( std::vector<std::string_view>{ varname } );
       return *static_cast<this_t*>( this );
    }
 
@@ -68,7 +105,9 @@ public:
    // @p varname a string or a vector of strings.
    this_t& metavar( const std::vector<std::string_view>& varnames )
    {
-      getOption().setMetavar( varnames );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.hasMetavar( varnames ); } ) )
+         option.setMetavar( varnames );
       return *static_cast<this_t*>( this );
    }
 
@@ -76,7 +115,9 @@ public:
    // generated help.
    this_t& help( std::string_view help )
    {
-      getOption().setHelp( help );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.getRawHelp() == help; } ) )
+         option.setHelp( help );
       return *static_cast<this_t*>( this );
    }
 
@@ -84,7 +125,10 @@ public:
    this_t& nargs( int count )
    {
       ensureCountWasNotSet();
-      getOption().setNArgs( count );
+      auto& option = getOption();
+      auto n = std::max( 0, count );
+      if ( needsConfiguration( [&] { return option.getArgumentCounts() == std::tuple{ n, n }; } ) )
+         option.setNArgs( count );
       markCountWasSet();
       return *static_cast<this_t*>( this );
    }
@@ -93,7 +137,10 @@ public:
    this_t& minargs( int count )
    {
       ensureCountWasNotSet();
-      getOption().setMinArgs( count );
+      auto& option = getOption();
+      auto n = std::max( 0, count );
+      if ( needsConfiguration( [&] { return option.getArgumentCounts() == std::tuple{ n, -1 }; } ) )
+         option.setMinArgs( count );
       markCountWasSet();
       return *static_cast<this_t*>( this );
    }
@@ -102,7 +149,10 @@ public:
    this_t& maxargs( int count )
    {
       ensureCountWasNotSet();
-      getOption().setMaxArgs( count );
+      auto& option = getOption();
+      auto n = std::max( 0, count );
+      if ( needsConfiguration( [&] { return option.getArgumentCounts() == std::tuple{ 0, n }; } ) )
+         option.setMaxArgs( count );
       markCountWasSet();
       return *static_cast<this_t*>( this );
    }
@@ -110,7 +160,9 @@ public:
    // Set to true if the option must be present in the input arguments.
    this_t& required( bool isRequired = true )
    {
-      getOption().setRequired( isRequired );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.isRequired() == isRequired; } ) )
+         option.setRequired( isRequired );
       return *static_cast<this_t*>( this );
    }
 
@@ -118,14 +170,22 @@ public:
    // if this is a flag option and action is not set.
    this_t& flagValue( std::string_view value )
    {
-      getOption().setFlagValue( value );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.getFlagValue() == value; } ) )
+         option.setFlagValue( value );
       return *static_cast<this_t*>( this );
    }
 
    // Define the values accepted by an option.
    this_t& choices( const std::vector<std::string>& choices )
    {
-      getOption().setChoices( choices );
+      auto& option = getOption();
+      auto isSame = [&] {
+         auto& current = option.getChoices();
+         return std::equal( current.begin(), current.end(), choices.begin(), choices.end() );
+      };
+      if ( needsConfiguration( isSame ) )
+         option.setChoices( choices );
       return *static_cast<this_t*>( this );
    }
 
@@ -143,8 +203,49 @@ public:
    //    --forward,--silent,--threads=3
    this_t& forward( bool isForwarded = true )
    {
-      ensureCanBeForwarded();
-      getOption().setForwarded( isForwarded );
+      auto& option = getOption();
+      if ( needsConfiguration( [&] { return option.isForwarded() == isForwarded; } ) ) {
+         ensureCanBeForwarded();
+         option.setForwarded( isForwarded );
+      }
+      return *static_cast<this_t*>( this );
+   }
+
+   // Read the value of the option from the environment variable @p name when
+   // the option is not present in the input arguments.  A flag is set if the
+   // variable is not empty, "0", "false", "no" or "off".
+   //
+   // The environment is not a part of the definition cache so this setting is
+   // always applied.
+   this_t& env( std::string_view name )
+   {
+      getOption().setEnvName( name );
+      return *static_cast<this_t*>( this );
+   }
+
+   // Append the values of the option from all the value sources (configuration
+   // files, environment, input arguments) in the order of precedence.  By
+   // default only the values from the source with the highest precedence are
+   // assigned.  The option must have a vector target.
+   //
+   // The value sources are not a part of the definition cache so this setting
+   // is always applied.
+   this_t& append_sources( bool append = true )
+   {
+      ensureHasVectorValue();
+      getOption().setAppendsSources( append );
+      return *static_cast<this_t*>( this );
+   }
+
+   // Set when the target of the option is reset.  It overrides
+   // ParserConfig::value_reset() for this option.  With EValueReset::onTouch
+   // the target keeps its value in the parses that do not use the option.
+   //
+   // The reset mode is not a part of the definition cache so this setting is
+   // always applied.
+   this_t& value_reset( EValueReset reset )
+   {
+      getOption().setValueReset( reset );
       return *static_cast<this_t*>( this );
    }
 
@@ -156,6 +257,24 @@ protected:
    {}
 };
 
+template<typename T>
+struct is_numeric_vector : std::false_type
+{};
+
+template<typename T>
+struct is_numeric_vector<std::vector<T>>
+   : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+{};
+
+template<typename T>
+struct is_parallel_vector : std::false_type
+{};
+
+template<typename T>
+struct is_parallel_vector<std::vector<T>>
+   : std::integral_constant<bool, !std::is_same<T, bool>::value>
+{};
+
 template<typename TTarget>
 class OptionConfigA final : public OptionConfigBaseT<OptionConfigA<TTarget>>
 {
@@ -176,11 +295,14 @@ public:
    // set the value of the target variable associated with the option.
    this_t& action( assign_action_t action )
    {
+      if ( !OptionConfig::canSetAction( false ) )
+         return *this;
+
       if ( action ) {
          auto wrapAction = [=]( Value& value, const std::string& argument, Environment& ) {
             auto pConverted = ConvertedValue<TTarget>::value_cast( value );
             if ( pConverted )
-               action( pConverted->mTarget, argument );
+               action( pConverted->target(), argument );
          };
          OptionConfig::getOption().setAction( wrapAction );
       }
@@ -195,11 +317,14 @@ public:
    // This version has access to the parsing environment.
    this_t& action( assign_action_env_t action )
    {
+      if ( !OptionConfig::canSetAction( false ) )
+         return *this;
+
       if ( action ) {
          auto wrapAction = [=]( Value& value, const std::string& argument, Environment& env ) {
             auto pConverted = ConvertedValue<TTarget>::value_cast( value );
             if ( pConverted )
-               action( pConverted->mTarget, argument, env );
+               action( pConverted->target(), argument, env );
          };
          OptionConfig::getOption().setAction( wrapAction );
       }
@@ -208,6 +333,55 @@ public:
       return *this;
    }
 
+   // Treat each argument of the option as a list of numbers delimited by @p
+   // delimiter and append the numbers to the target vector.  The elements are
+   // converted without creating intermediate strings.  A conversion error
+   // reports the position of the invalid element and no elements of the
+   // argument are appended.  An empty argument, eg. `--ids ""`, is an empty
+   // list.  Like for other options, `--ids=` is an option without an
+   // argument and reports a missing argument.
+   //
+   // The target must be a vector of integral or floating point values.  The
+   // elements are appended by an action so split() can not be combined with
+   // action().
+   this_t& split( char delimiter = ',' )
+   {
+      static_assert( is_numeric_vector<TTarget>::value,
+            "split() requires a vector of integral or floating point values." );
+
+      if ( !OptionConfig::canSetAction( true ) )
+         return *this;
+
+      auto wrapAction = [delimiter]( Value& value, const std::string& argument, Environment& ) {
+         auto pConverted = ConvertedValue<TTarget>::value_cast( value );
+         if ( pConverted ) {
+            auto failed = try_parse_list( argument, delimiter, pConverted->target() );
+            if ( failed )
+               value.failAssignment( EConversionError::invalidValue, failed );
+         }
+      };
+      OptionConfig::getOption().setAction( wrapAction );
+      return *this;
+   }
+
+   // Convert the arguments of the option after all the input arguments are
+   // parsed.  Large numbers of arguments are converted in chunks on @p
+   // threadCount threads (0: the number of hardware threads).  The order of
+   // the values is preserved.  A conversion error reports the position of the
+   // invalid value in the values of the option as '--name[index]'.
+   //
+   // The target must be a vector.  The deferred conversion is used only when
+   // the option has no action.  The conversion must not depend on shared
+   // mutable state.
+   this_t& parallel( unsigned threadCount = 0 )
+   {
+      static_assert( is_parallel_vector<TTarget>::value,
+            "parallel() requires a vector target with non-bool elements." );
+
+      OptionConfig::getOption().setDeferredConversion( threadCount );
+      return *this;
+   }
+
    // Define the value that will be assigned to the target if the option is
    // not present in arguments.  If multiple options that are configured with
    // default_value() have the same target, the result is undefined.
@@ -216,7 +390,7 @@ public:
       auto wrapDefault = [=]( Value& value ) {
          auto pConverted = ConvertedValue<TTarget>::value_cast( value );
          if ( pConverted )
-            pConverted->mTarget = defaultValue;
+            pConverted->target() = defaultValue;
       };
       OptionConfig::getOption().setAssignDefaultAction( wrapDefault );
       return *this;
@@ -230,7 +404,7 @@ public:
       auto wrapDefault = [=]( Value& value ) {
          auto pConverted = ConvertedValue<TTarget>::value_cast( value );
          if ( pConverted )
-            action( pConverted->mTarget );
+            action( pConverted->target() );
       };
       OptionConfig::getOption().setAssignDefaultAction( wrapDefault );
       return *this;
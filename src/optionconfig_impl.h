@@ -5,6 +5,9 @@
 
 #include "optionconfig.h"
 
+#include "definitioncache.h"
+#include "exceptions.h"
+
 #include <cassert>
 
 namespace argumentum {
@@ -14,7 +17,7 @@ ARGUMENTUM_INLINE OptionConfig::OptionConfig( const std::shared_ptr<Option>& pOp
 {
    assert( pOption );
    if ( !mpOption )
-      throw std::invalid_argument( "OptionConfig requires an option." );
+      throw_or_abort( std::invalid_argument( "OptionConfig requires an option." ) );
 }
 
 ARGUMENTUM_INLINE Option& OptionConfig::getOption() const
@@ -22,6 +25,20 @@ ARGUMENTUM_INLINE Option& OptionConfig::getOption() const
    return *mpOption;
 }
 
+ARGUMENTUM_INLINE bool OptionConfig::isCached() const
+{
+   return mIsCached;
+}
+
+// The option is configured differently than when the cache was written so the
+// cache is rewritten after the parameters are defined.
+ARGUMENTUM_INLINE void OptionConfig::dropCache()
+{
+   mIsCached = false;
+   if ( mpCache )
+      mpCache->invalidate();
+}
+
 ARGUMENTUM_INLINE void OptionConfig::markCountWasSet()
 {
    mCountWasSet = true;
@@ -30,13 +47,39 @@ ARGUMENTUM_INLINE void OptionConfig::markCountWasSet()
 ARGUMENTUM_INLINE void OptionConfig::ensureCountWasNotSet() const
 {
    if ( mCountWasSet )
-      throw std::invalid_argument( "Only one of nargs, minargs and maxargs can be used." );
+      failDefinition( "Only one of nargs, minargs and maxargs can be used." );
 }
 
 ARGUMENTUM_INLINE void OptionConfig::ensureCanBeForwarded() const
 {
    if ( !getOption().getShortName().empty() )
-      throw std::invalid_argument( "Only long options can be used for forwarding parameters." );
+      failDefinition( "Only long options can be used for forwarding parameters." );
+}
+
+ARGUMENTUM_INLINE void OptionConfig::ensureHasVectorValue() const
+{
+   if ( !getOption().hasVectorValue() )
+      failDefinition( "Only options with vector targets can append sources." );
+}
+
+// Returns false if the action can not be set because split() and action()
+// are combined.
+ARGUMENTUM_INLINE bool OptionConfig::canSetAction( bool isSplit )
+{
+   if ( mActionWasSet && mIsSplit != isSplit ) {
+      failDefinition( "split() can not be combined with action()." );
+      return false;
+   }
+   mActionWasSet = true;
+   mIsSplit = isSplit;
+   return true;
+}
+
+ARGUMENTUM_INLINE void OptionConfig::failDefinition( const char* message ) const
+{
+   throw_or_report( std::invalid_argument( message ), [this]( std::string_view message ) {
+      getOption().addDefinitionError( message );
+   } );
 }
 
 ARGUMENTUM_INLINE VoidOptionConfig::VoidOptionConfig( OptionConfig&& wrapped )
@@ -5,81 +5,126 @@
 
 #include "exceptions.h"
 #include "option.h"
+#include "structbinding.h"
 #include "value.h"
 
 #include <cassert>
-#include <map>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace argumentum {
 
 class OptionFactory
 {
-   std::map<TargetId, std::shared_ptr<Value>> mValueFromTargetId;
+   struct TargetIdHash
+   {
+      size_t operator()( const TargetId& id ) const
+      {
+         auto hash = std::hash<uintptr_t>{};
+         return hash( id.first ) ^ ( hash( id.second ) * 31 );
+      }
+   };
+
+   std::unordered_map<TargetId, std::shared_ptr<Value>, TargetIdHash> mValueFromTargetId;
 
 public:
+   // Reserve the space for the values of @p count more targets.
+   void reserve( size_t count )
+   {
+      mValueFromTargetId.reserve( mValueFromTargetId.size() + count );
+   }
+
    template<typename TTarget>
    Option createOption( TTarget& value )
    {
-      std::shared_ptr<Value> pValue;
       if constexpr ( std::is_base_of<Value, TTarget>::value ) {
-         pValue = std::make_shared<TTarget>( value );
+         auto pValue = std::make_shared<TTarget>( value );
+         return createOptionForValue( getValueForKnownTarget( pValue ), &value );
       }
       else {
-         using wrap_type = ConvertedValue<TTarget>;
-         pValue = std::make_shared<wrap_type>( value );
+         auto pValue = std::make_shared<ConvertedValue<TTarget>>( value );
+         return createOptionForValue( getValueForKnownTarget( pValue ), &value );
       }
-
-      return Option( getValueForKnownTarget( pValue ), Option::singleValue );
    }
 
    template<typename TTarget>
    Option createOption( std::vector<TTarget>& value )
    {
-      std::shared_ptr<Value> pValue;
-      using val_vector = std::vector<TTarget>;
       if constexpr ( std::is_base_of<Value, TTarget>::value ) {
-         throw UnsupportedTargetType( "Unsupported target type: vector<Value>." );
+         throw_or_abort( UnsupportedTargetType( "Unsupported target type: vector<Value>." ) );
       }
       else {
-         using wrap_type = ConvertedValue<val_vector>;
-         pValue = std::make_shared<wrap_type>( value );
-
-         auto option = Option( getValueForKnownTarget( pValue ), Option::vectorValue );
-         option.setMinArgs( 1 );
-         return option;
+         auto pValue = std::make_shared<ConvertedValue<std::vector<TTarget>>>( value );
+         return createOptionForValue( getValueForKnownTarget( pValue ), &value );
       }
    }
 
    template<typename TTarget>
    Option createOption( std::optional<std::vector<TTarget>>& value )
    {
-      std::shared_ptr<Value> pValue;
-      using val_vector = std::optional<std::vector<TTarget>>;
       if constexpr ( std::is_base_of<Value, TTarget>::value ) {
-         throw UnsupportedTargetType( "Unsupported target type: optional<vector<Value>>." );
+         throw_or_abort(
+               UnsupportedTargetType( "Unsupported target type: optional<vector<Value>>." ) );
       }
       else {
-         using wrap_type = ConvertedValue<val_vector>;
-         pValue = std::make_shared<wrap_type>( value );
-
-         auto option = Option( getValueForKnownTarget( pValue ), Option::vectorValue );
-         option.setMinArgs( 0 );
-         return option;
+         using val_vector = std::optional<std::vector<TTarget>>;
+         auto pValue = std::make_shared<ConvertedValue<val_vector>>( value );
+         return createOptionForValue( getValueForKnownTarget( pValue ), &value );
       }
    }
 
+   // The option stores its values in a member of the instance bound to the
+   // binding of @p member.
+   template<typename TStruct, typename TTarget>
+   Option createMemberOption( const MemberTarget<TStruct, TTarget>& member )
+   {
+      static_assert( !std::is_base_of<Value, TTarget>::value,
+            "A member of a bound struct can not be a Value." );
+
+      auto pValue = std::make_shared<MemberValue<TStruct, TTarget>>( member );
+      return createOptionForValue(
+            getValueForKnownTarget( pValue ), static_cast<TTarget*>( nullptr ) );
+   }
+
 private:
    std::shared_ptr<Value> getValueForKnownTarget( std::shared_ptr<Value> pValue )
    {
       assert( pValue );
-      auto iv = mValueFromTargetId.find( pValue->getTargetId() );
-      if ( iv != mValueFromTargetId.end() )
-         return iv->second;
+      auto [iv, isNew] = mValueFromTargetId.try_emplace( pValue->getTargetId(), pValue );
+      return isNew ? pValue : iv->second;
+   }
+
+   // The kind and the default argument counts of the option are selected by
+   // the type of the target.
+   template<typename TTarget>
+   static Option createOptionForValue( std::shared_ptr<Value>&& pValue, TTarget* )
+   {
+      if constexpr ( is_sink<TTarget>::value ) {
+         auto option = Option( std::move( pValue ), Option::vectorValue );
+         option.setMinArgs( 1 );
+         return option;
+      }
 
-      mValueFromTargetId[pValue->getTargetId()] = pValue;
-      return pValue;
+      return Option( std::move( pValue ), Option::singleValue );
+   }
+
+   template<typename TTarget>
+   static Option createOptionForValue( std::shared_ptr<Value>&& pValue, std::vector<TTarget>* )
+   {
+      auto option = Option( std::move( pValue ), Option::vectorValue );
+      option.setMinArgs( 1 );
+      return option;
+   }
+
+   template<typename TTarget>
+   static Option createOptionForValue(
+         std::shared_ptr<Value>&& pValue, std::optional<std::vector<TTarget>>* )
+   {
+      auto option = Option( std::move( pValue ), Option::vectorValue );
+      option.setMinArgs( 0 );
+      return option;
    }
 };
 
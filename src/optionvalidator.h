@@ -0,0 +1,94 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace argumentum {
+
+class Option;
+class OptionGroup;
+class ParseResultBuilder;
+
+// Validates the required options and the option groups after a parse.
+//
+// The options of a parser get dense indices when the definitions are
+// finalized: the named options first, then the positional parameters.  The
+// parser records the assignments in bitsets indexed by the options and the
+// validation combines the bitsets with the masks of the required options and
+// of the groups one 64-bit word at a time.  The validation does not allocate
+// unless it reports errors.
+//
+// The index is rebuilt when the definitions change.  The flags of the groups
+// are read when the options are validated.
+class OptionValidator
+{
+   using word_t = uint64_t;
+   static constexpr unsigned wordBits = 64;
+
+   // A word of the member mask of a group.
+   struct MaskedWord
+   {
+      uint32_t word;
+      word_t mask;
+   };
+
+   struct Group
+   {
+      const OptionGroup* pGroup;
+      // The range of the member mask of the group in mGroupWords.
+      uint32_t begin;
+      uint32_t end;
+   };
+
+   std::vector<Option*> mOptions;
+   size_t mNamedCount = 0;
+
+   // The next option in the ring of the options that share a value.  An
+   // option that does not share its value points to itself.
+   std::vector<uint32_t> mNextSharingValue;
+   std::vector<word_t> mRequired;
+   std::vector<Group> mGroups;
+   std::vector<MaskedWord> mGroupWords;
+   // The index of the group of each named option in mGroups.
+   static constexpr uint32_t noGroup = ~uint32_t( 0 );
+   std::vector<uint32_t> mGroupOfOption;
+   bool mHasRequired = false;
+
+   // The options whose values were assigned through any option that shares
+   // the value.
+   std::vector<word_t> mAssigned;
+   // The options through which the values were assigned.
+   std::vector<word_t> mAssignedThroughOption;
+
+public:
+   // Index the named options @p options and the positional parameters @p
+   // positional.
+   void build( const std::vector<std::shared_ptr<Option>>& options,
+         const std::vector<std::shared_ptr<Option>>& positional );
+
+   // Forget the recorded assignments.
+   void resetAssignments();
+
+   // Record the assignments of the value of @p option.
+   void markAssigned( const Option& option );
+
+   // Returns true if any option or positional parameter is required.
+   bool hasRequired() const;
+
+   // Returns true if @p option is in an exclusive group and a value was
+   // assigned to another option of the group.
+   bool wasExclusiveGroupAssignedByOther( const Option& option ) const;
+
+   void reportMissingOptions( ParseResultBuilder& result ) const;
+   void reportExclusiveViolations( ParseResultBuilder& result ) const;
+   void reportMissingGroups( ParseResultBuilder& result ) const;
+
+private:
+   static void setBit( std::vector<word_t>& bits, size_t index );
+};
+
+}   // namespace argumentum
@@ -0,0 +1,243 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "optionvalidator.h"
+
+#include "group.h"
+#include "option.h"
+#include "parseresult.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace argumentum {
+
+namespace detail {
+ARGUMENTUM_INLINE unsigned lowestBit( uint64_t word )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+   return unsigned( __builtin_ctzll( word ) );
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+   unsigned long index;
+   _BitScanForward64( &index, word );
+   return unsigned( index );
+#else
+   unsigned index = 0;
+   while ( ( word & 1 ) == 0 ) {
+      word >>= 1;
+      ++index;
+   }
+   return index;
+#endif
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE void OptionValidator::build( const std::vector<std::shared_ptr<Option>>& options,
+      const std::vector<std::shared_ptr<Option>>& positional )
+{
+   mNamedCount = options.size();
+
+   mOptions.clear();
+   for ( auto& pOption : options )
+      mOptions.push_back( pOption.get() );
+   for ( auto& pOption : positional )
+      mOptions.push_back( pOption.get() );
+
+   auto wordCount = ( mOptions.size() + wordBits - 1 ) / wordBits;
+   mRequired.assign( wordCount, 0 );
+   mAssigned.assign( wordCount, 0 );
+   mAssignedThroughOption.assign( wordCount, 0 );
+   mNextSharingValue.resize( mOptions.size() );
+   mHasRequired = false;
+
+   std::unordered_map<ValueId, uint32_t> lastWithValue;
+   std::vector<std::vector<uint32_t>> groupMembers;
+   std::unordered_map<const OptionGroup*, size_t> groupIndex;
+   mGroups.clear();
+   for ( uint32_t i = 0; i < mOptions.size(); ++i ) {
+      auto& option = *mOptions[i];
+      option.setIndex( int( i ) );
+      mHasRequired = mHasRequired || option.isRequired();
+
+      // Link the options that share a value into a ring.
+      auto [it, isNew] = lastWithValue.try_emplace( option.getValueId(), i );
+      if ( isNew )
+         mNextSharingValue[i] = i;
+      else {
+         auto first = mNextSharingValue[it->second];
+         mNextSharingValue[it->second] = i;
+         mNextSharingValue[i] = first;
+         it->second = i;
+      }
+
+      if ( i >= mNamedCount )
+         continue;
+
+      if ( option.isRequired() )
+         setBit( mRequired, i );
+
+      auto pGroup = option.getGroup().get();
+      if ( pGroup ) {
+         auto [ig, isNewGroup] = groupIndex.try_emplace( pGroup, mGroups.size() );
+         if ( isNewGroup ) {
+            mGroups.push_back( { pGroup, 0, 0 } );
+            groupMembers.emplace_back();
+         }
+         groupMembers[ig->second].push_back( i );
+      }
+   }
+
+   // The errors of the groups are reported in the order of their names.
+   std::vector<size_t> order( mGroups.size() );
+   for ( size_t i = 0; i < order.size(); ++i )
+      order[i] = i;
+   std::sort( order.begin(), order.end(), [&]( size_t a, size_t b ) {
+      return mGroups[a].pGroup->getName() < mGroups[b].pGroup->getName();
+   } );
+
+   auto groups = std::move( mGroups );
+   mGroups.clear();
+   mGroupWords.clear();
+   mGroupOfOption.assign( mNamedCount, noGroup );
+   for ( auto ig : order ) {
+      auto group = groups[ig];
+      group.begin = uint32_t( mGroupWords.size() );
+      for ( auto index : groupMembers[ig] ) {
+         mGroupOfOption[index] = uint32_t( mGroups.size() );
+         auto word = uint32_t( index / wordBits );
+         auto bit = word_t( 1 ) << ( index % wordBits );
+         if ( mGroupWords.size() > group.begin && mGroupWords.back().word == word )
+            mGroupWords.back().mask |= bit;
+         else
+            mGroupWords.push_back( { word, bit } );
+      }
+      group.end = uint32_t( mGroupWords.size() );
+      mGroups.push_back( group );
+   }
+}
+
+ARGUMENTUM_INLINE void OptionValidator::resetAssignments()
+{
+   std::fill( mAssigned.begin(), mAssigned.end(), 0 );
+   std::fill( mAssignedThroughOption.begin(), mAssignedThroughOption.end(), 0 );
+}
+
+ARGUMENTUM_INLINE void OptionValidator::markAssigned( const Option& option )
+{
+   auto index = option.getIndex();
+   if ( index < 0 || size_t( index ) >= mOptions.size() || mOptions[index] != &option )
+      return;
+
+   if ( option.wasAssignedThroughThisOption() )
+      setBit( mAssignedThroughOption, index );
+
+   if ( option.wasAssigned() ) {
+      auto i = uint32_t( index );
+      do {
+         setBit( mAssigned, i );
+         i = mNextSharingValue[i];
+      } while ( i != uint32_t( index ) );
+   }
+}
+
+ARGUMENTUM_INLINE bool OptionValidator::hasRequired() const
+{
+   return mHasRequired;
+}
+
+ARGUMENTUM_INLINE bool OptionValidator::wasExclusiveGroupAssignedByOther(
+      const Option& option ) const
+{
+   auto index = option.getIndex();
+   if ( index < 0 || size_t( index ) >= mNamedCount || mOptions[index] != &option )
+      return false;
+
+   auto ig = mGroupOfOption[index];
+   if ( ig == noGroup || !mGroups[ig].pGroup->isExclusive() )
+      return false;
+
+   auto& group = mGroups[ig];
+   auto ownWord = uint32_t( index / wordBits );
+   auto ownBit = word_t( 1 ) << ( index % wordBits );
+   for ( auto i = group.begin; i < group.end; ++i ) {
+      auto& word = mGroupWords[i];
+      auto mask = word.word == ownWord ? word.mask & ~ownBit : word.mask;
+      if ( ( mAssigned[word.word] & mask ) != 0 )
+         return true;
+   }
+   return false;
+}
+
+ARGUMENTUM_INLINE void OptionValidator::reportMissingOptions( ParseResultBuilder& result ) const
+{
+   for ( size_t w = 0; w < mRequired.size(); ++w ) {
+      auto missing = mRequired[w] & ~mAssigned[w];
+      for ( ; missing != 0; missing &= missing - 1 ) {
+         auto& option = *mOptions[w * wordBits + detail::lowestBit( missing )];
+         result.addError( option.getHelpName(), MISSING_OPTION );
+      }
+   }
+
+   for ( auto i = mNamedCount; i < mOptions.size(); ++i ) {
+      auto& option = *mOptions[i];
+      // A positional option must have enough arguments.
+      if ( option.needsMoreArguments() )
+         // If it is optional, it may have no arguments.
+         if ( option.isRequired() || option.wasAssigned() )
+            result.addError( option.getHelpName(), MISSING_ARGUMENT );
+   }
+}
+
+ARGUMENTUM_INLINE void OptionValidator::reportExclusiveViolations(
+      ParseResultBuilder& result ) const
+{
+   for ( auto& group : mGroups ) {
+      if ( !group.pGroup->isExclusive() )
+         continue;
+
+      // The index of the first option used in the group.
+      size_t first = mOptions.size();
+      bool isViolated = false;
+      for ( auto i = group.begin; i < group.end && !isViolated; ++i ) {
+         auto& word = mGroupWords[i];
+         auto used = mAssignedThroughOption[word.word] & word.mask;
+         if ( used == 0 )
+            continue;
+         if ( first < mOptions.size() || ( used & ( used - 1 ) ) != 0 )
+            isViolated = true;
+         if ( first == mOptions.size() )
+            first = word.word * wordBits + detail::lowestBit( used );
+      }
+
+      if ( isViolated )
+         result.addError( mOptions[first]->getHelpName(), EXCLUSIVE_OPTION );
+   }
+}
+
+ARGUMENTUM_INLINE void OptionValidator::reportMissingGroups( ParseResultBuilder& result ) const
+{
+   for ( auto& group : mGroups ) {
+      if ( !group.pGroup->isRequired() )
+         continue;
+
+      word_t used = 0;
+      for ( auto i = group.begin; i < group.end; ++i )
+         used |= mAssigned[mGroupWords[i].word] & mGroupWords[i].mask;
+
+      if ( used == 0 )
+         result.addError( group.pGroup->getName(), MISSING_OPTION_GROUP );
+   }
+}
+
+ARGUMENTUM_INLINE void OptionValidator::setBit( std::vector<word_t>& bits, size_t index )
+{
+   bits[index / wordBits] |= word_t( 1 ) << ( index % wordBits );
+}
+
+}   // namespace argumentum
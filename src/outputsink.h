@@ -0,0 +1,62 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+
+#ifndef ARGUMENTUM_SLIM
+#include <ostream>
+#endif
+
+namespace argumentum {
+
+// The destination of the text written by the parser: the help and the
+// descriptions of the errors.  The text is formatted before it is written to
+// the sink.
+class IOutputSink
+{
+public:
+   virtual ~IOutputSink() = default;
+   virtual void write( std::string_view text ) = 0;
+};
+
+// Writes the text to a C stream, eg. stdout.  This is the default output of
+// the slim build (ARGUMENTUM_SLIM) which does not use the standard stream
+// objects.
+class FileOutputSink : public IOutputSink
+{
+   std::FILE* mpFile;
+
+public:
+   explicit FileOutputSink( std::FILE* pFile )
+      : mpFile( pFile )
+   {}
+
+   void write( std::string_view text ) override
+   {
+      std::fwrite( text.data(), 1, text.size(), mpFile );
+   }
+};
+
+#ifndef ARGUMENTUM_SLIM
+// Writes the text to a standard stream.  The streams set with
+// ParserConfig::cout() are used through this sink.
+class StreamOutputSink : public IOutputSink
+{
+   std::ostream& mStream;
+
+public:
+   explicit StreamOutputSink( std::ostream& stream )
+      : mStream( stream )
+   {}
+
+   void write( std::string_view text ) override
+   {
+      mStream.write( text.data(), static_cast<std::streamsize>( text.size() ) );
+   }
+};
+#endif
+
+}   // namespace argumentum
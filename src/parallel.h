@@ -0,0 +1,101 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "exceptions.h"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace argumentum {
+
+namespace detail {
+// The number of threads used when the requested thread count is 0.
+unsigned getDefaultThreadCount();
+
+// Execute @p convertChunk for the chunks [0, chunkCount).  The chunks are
+// distributed between the calling thread and the threads of a pool that is
+// created on first use and reused by the following conversions.  With
+// ARGUMENTUM_NO_THREADS all the chunks are converted on the calling thread.
+// @p convertChunk must not throw.
+void runChunks( size_t chunkCount, const std::function<void( size_t )>& convertChunk );
+}   // namespace detail
+
+// Execute @p convert for the indices [0, count) in contiguous chunks on at most
+// @p threadCount threads.  If @p threadCount is 0 the number of hardware
+// threads is used.  Short ranges are converted on the calling thread.
+//
+// Returns the ordered indices for which @p convert returned false or threw
+// invalid_argument or out_of_range.  Other exceptions are rethrown on the
+// calling thread.
+template<typename F>
+std::vector<size_t> convert_in_parallel( size_t count, unsigned threadCount, F&& convert )
+{
+   const size_t minChunkSize = 4096;
+
+   if ( threadCount == 0 )
+      threadCount = detail::getDefaultThreadCount();
+
+   auto chunkCount = std::min<size_t>( threadCount, ( count + minChunkSize - 1 ) / minChunkSize );
+   chunkCount = std::max<size_t>( 1, chunkCount );
+   auto chunkSize = ( count + chunkCount - 1 ) / chunkCount;
+
+   std::vector<std::vector<size_t>> failed( chunkCount );
+
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   auto convertChunk = [&]( size_t chunk ) {
+      auto begin = chunk * chunkSize;
+      auto end = std::min( count, begin + chunkSize );
+      for ( auto i = begin; i < end; ++i )
+         if ( !convert( i ) )
+            failed[chunk].push_back( i );
+   };
+#else
+   std::vector<std::exception_ptr> exceptions( chunkCount );
+
+   auto convertChunk = [&]( size_t chunk ) {
+      auto begin = chunk * chunkSize;
+      auto end = std::min( count, begin + chunkSize );
+      try {
+         for ( auto i = begin; i < end; ++i ) {
+            try {
+               if ( !convert( i ) )
+                  failed[chunk].push_back( i );
+            }
+            catch ( const std::invalid_argument& ) {
+               failed[chunk].push_back( i );
+            }
+            catch ( const std::out_of_range& ) {
+               failed[chunk].push_back( i );
+            }
+         }
+      }
+      catch ( ... ) {
+         exceptions[chunk] = std::current_exception();
+      }
+   };
+#endif
+
+   if ( chunkCount == 1 )
+      convertChunk( 0 );
+   else
+      detail::runChunks( chunkCount, convertChunk );
+
+#ifndef ARGUMENTUM_NO_EXCEPTIONS
+   for ( auto& pException : exceptions )
+      if ( pException )
+         std::rethrow_exception( pException );
+#endif
+
+   std::vector<size_t> result;
+   for ( auto& chunkFailed : failed )
+      result.insert( result.end(), chunkFailed.begin(), chunkFailed.end() );
+
+   return result;
+}
+
+}   // namespace argumentum
@@ -0,0 +1,136 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "parallel.h"
+
+#ifndef ARGUMENTUM_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace argumentum {
+
+namespace detail {
+
+#ifndef ARGUMENTUM_NO_THREADS
+// The threads that convert the chunks of the deferred values.  The threads
+// are started when a conversion needs more threads than the pool has and
+// wait for the next conversion when they are idle.  The pool is shared by
+// all the parsers and converts the chunks of one conversion at a time.
+class WorkerPool
+{
+   std::mutex mMutex;
+   std::condition_variable mHasWork;
+   std::condition_variable mIsDone;
+   std::vector<std::thread> mWorkers;
+   const std::function<void( size_t )>* mpConvertChunk = nullptr;
+   size_t mNextChunk = 0;
+   size_t mChunkCount = 0;
+   size_t mPendingCount = 0;
+   bool mIsStopping = false;
+
+   // Serializes the conversions of the parsers on different threads.
+   std::mutex mRunMutex;
+
+public:
+   ~WorkerPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock( mMutex );
+         mIsStopping = true;
+      }
+      mHasWork.notify_all();
+      for ( auto& worker : mWorkers )
+         worker.join();
+   }
+
+   void run( size_t chunkCount, const std::function<void( size_t )>& convertChunk )
+   {
+      // A conversion that can not use the pool because another thread is
+      // using it runs on the calling thread.
+      std::unique_lock<std::mutex> runLock( mRunMutex, std::try_to_lock );
+      if ( !runLock ) {
+         for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+            convertChunk( chunk );
+         return;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock( mMutex );
+         // The calling thread converts chunks, too.
+         while ( mWorkers.size() + 1 < chunkCount )
+            mWorkers.emplace_back( [this] { work(); } );
+         mpConvertChunk = &convertChunk;
+         mNextChunk = 0;
+         mChunkCount = chunkCount;
+         mPendingCount = chunkCount;
+      }
+      mHasWork.notify_all();
+
+      std::unique_lock<std::mutex> lock( mMutex );
+      convertAvailableChunks( lock );
+      mIsDone.wait( lock, [this] { return mPendingCount == 0; } );
+      mpConvertChunk = nullptr;
+   }
+
+private:
+   void work()
+   {
+      std::unique_lock<std::mutex> lock( mMutex );
+      while ( true ) {
+         mHasWork.wait( lock, [this] { return mIsStopping || mNextChunk < mChunkCount; } );
+         if ( mIsStopping )
+            return;
+         convertAvailableChunks( lock );
+      }
+   }
+
+   // Convert the chunks that were not taken by other threads.  @p lock is
+   // released while a chunk is converted.
+   void convertAvailableChunks( std::unique_lock<std::mutex>& lock )
+   {
+      while ( mNextChunk < mChunkCount ) {
+         auto chunk = mNextChunk++;
+         auto& convertChunk = *mpConvertChunk;
+         lock.unlock();
+         convertChunk( chunk );
+         lock.lock();
+         if ( --mPendingCount == 0 )
+            mIsDone.notify_all();
+      }
+   }
+};
+
+ARGUMENTUM_INLINE WorkerPool& getWorkerPool()
+{
+   static WorkerPool pool;
+   return pool;
+}
+#endif
+
+ARGUMENTUM_INLINE unsigned getDefaultThreadCount()
+{
+#ifdef ARGUMENTUM_NO_THREADS
+   return 1;
+#else
+   return std::max( 1U, std::thread::hardware_concurrency() );
+#endif
+}
+
+ARGUMENTUM_INLINE void runChunks(
+      size_t chunkCount, const std::function<void( size_t )>& convertChunk )
+{
+#ifdef ARGUMENTUM_NO_THREADS
+   for ( size_t chunk = 0; chunk < chunkCount; ++chunk )
+      convertChunk( chunk );
+#else
+   getWorkerPool().run( chunkCount, convertChunk );
+#endif
+}
+
+}   // namespace detail
+
+}   // namespace argumentum
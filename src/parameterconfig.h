@@ -11,13 +11,31 @@
 #include "optionpack.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace argumentum {
 
 class argument_parser;
 class ParserDefinition;
 
+/**
+ * The description of a parameter that is added with
+ * ParameterConfig::add_parameters_bulk.  The names and the help are copied
+ * when the parameter is added.
+ */
+template<typename TTarget>
+struct ParameterDescriptor
+{
+   TTarget* target = nullptr;
+   std::string_view name;
+   std::string_view altName;
+   std::optional<int> nargs;
+   std::string_view help;
+};
+
 class ParameterConfig
 {
    friend class argument_parser;
@@ -58,6 +76,20 @@ public:
       return OptionConfigA<TTarget>( tryAddParameter( option, { name, altName } ) );
    }
 
+   /**
+    * Add an argument with names @p name and @p altName that stores the parsed
+    * parameter(s) in a member of the struct instance bound to a
+    * StructBinding.  The target is created with StructBinding::member(), eg.
+    * `add_parameter( binding.member( &Args::count ), "--count" )`.
+    */
+   template<typename TStruct, typename TTarget>
+   OptionConfigA<TTarget> add_parameter( MemberTarget<TStruct, TTarget> member,
+         const std::string& name = "", const std::string& altName = "" )
+   {
+      auto option = getOptionFactory().createMemberOption( member );
+      return OptionConfigA<TTarget>( tryAddParameter( option, { name, altName } ) );
+   }
+
    /**
     * Add an argument with names @p name and @p altName and store the reference
     * to @p target value that will receive the parsed parameter(s).  This is an
@@ -70,6 +102,44 @@ public:
       return add_parameter( target, name, altName );
    }
 
+   /**
+    * Add an argument that stores the parsed parameter(s) in a member of a
+    * bound struct.  This is an alias for `add_parameter`.
+    */
+   template<typename TStruct, typename TTarget>
+   OptionConfigA<TTarget> add( MemberTarget<TStruct, TTarget> member,
+         const std::string& name = "", const std::string& altName = "" )
+   {
+      return add_parameter( member, name, altName );
+   }
+
+   /**
+    * Add the @p count parameters described by the descriptors starting at
+    * @p pFirst.  The space for the parameters is reserved before they are
+    * added.  A parameter with a name that is already used is rejected in the
+    * same way as in add_parameter.
+    */
+   template<typename TTarget>
+   void add_parameters_bulk( const ParameterDescriptor<TTarget>* pFirst, size_t count )
+   {
+      reserveParameters( count );
+      for ( auto pDesc = pFirst; pDesc != pFirst + count; ++pDesc ) {
+         auto option = getOptionFactory().createOption( *pDesc->target );
+         auto config = OptionConfigA<TTarget>(
+               tryAddParameter( option, { pDesc->name, pDesc->altName } ) );
+         if ( pDesc->nargs )
+            config.nargs( *pDesc->nargs );
+         if ( !pDesc->help.empty() )
+            config.help( pDesc->help );
+      }
+   }
+
+   template<typename TTarget>
+   void add_parameters_bulk( const std::vector<ParameterDescriptor<TTarget>>& descriptors )
+   {
+      add_parameters_bulk( descriptors.data(), descriptors.size() );
+   }
+
    /**
     * Add the @p pOptions structure and call its add_parameters method to add
     * the arguments to the parser.  The pointer to @p pOptions is stored in the
@@ -82,7 +152,8 @@ public:
     * terminate the parser.
     *
     * The method will throw an invalid_argument exception if none of the option
-    * names --help and -h can be used.
+    * names --help and -h can be used.  Without exceptions the error is
+    * reported when the arguments are parsed.
     *
     * This method will be called from parse_args if neither it nor the method
     * add_help_option were called before parse_args.
@@ -115,12 +186,25 @@ private:
 
 private:
    OptionConfig tryAddParameter( Option& newOption, std::vector<std::string_view> names );
+   void reserveParameters( size_t count );
    OptionConfig addPositional( Option&& newOption, const std::vector<std::string_view>& names );
    OptionConfig addOption( Option&& newOption, const std::vector<std::string_view>& names );
-   void trySetNames( Option& option, const std::vector<std::string_view>& names ) const;
-   void ensureIsNewOption( const std::string& name );
+   OptionConfig addCachedOption( Option&& newOption );
+   bool trySetNames( Option& option, const std::vector<std::string_view>& names );
+   bool ensureIsNewOption( const std::string& name );
    CommandConfig tryAddCommand( Command& command );
-   void ensureIsNewCommand( const std::string& name );
+   bool ensureIsNewCommand( const std::string& name );
+
+   // Throw the definition error @p error.  Without exceptions the error is
+   // stored in the parser definition and reported by the next parse.
+   template<typename TError>
+   void failDefinition( const TError& error );
+
+   // Return the configuration of a parameter or a command that was not added
+   // to the parser because of a definition error.  The configuration can be
+   // used but it has no effect.
+   OptionConfig rejectParameter( Option&& option );
+   CommandConfig rejectCommand( Command&& command );
    std::shared_ptr<OptionGroup> addGroup( std::string name, bool isExclusive );
    OptionFactory& getOptionFactory();
 };
@@ -7,6 +7,7 @@
 
 #include "argparser.h"
 #include "command.h"
+#include "definitioncache.h"
 #include "exceptions.h"
 #include "group.h"
 
@@ -24,16 +25,31 @@ ARGUMENTUM_INLINE OptionFactory& ParameterConfig::getOptionFactory()
    return mParser.getOptionFactory();
 }
 
+ARGUMENTUM_INLINE void ParameterConfig::reserveParameters( size_t count )
+{
+   mParserDef.reserveOptions( count );
+   getOptionFactory().reserve( count );
+}
+
 ARGUMENTUM_INLINE CommandConfig ParameterConfig::add_command(
       std::shared_ptr<CommandOptions> pOptions )
 {
-   if ( !pOptions )
-      throw MissingCommandOptions( "<unknown>" );
+   if ( !pOptions ) {
+      failDefinition( MissingCommandOptions( "<unknown>" ) );
+      return rejectCommand( Command( "<unknown>", pOptions ) );
+   }
 
    auto command = Command( pOptions->getName(), pOptions );
    return tryAddCommand( command );
 }
 
+ARGUMENTUM_INLINE CommandConfig ParameterConfig::add_command(
+      const std::string& name, Command::options_factory_t factory )
+{
+   auto command = Command( name, factory );
+   return tryAddCommand( command );
+}
+
 ARGUMENTUM_INLINE void ParameterConfig::add_parameters( std::shared_ptr<Options> pOptions )
 {
    if ( pOptions )
@@ -56,26 +72,30 @@ ARGUMENTUM_INLINE VoidOptionConfig ParameterConfig::add_default_help_option()
    if ( !pLong )
       return add_help_option( longName );
 
-   throw std::invalid_argument( "The default help options are hidden by other options." );
+   failDefinition( std::invalid_argument( "The default help options are hidden by other options." ) );
+   auto value = VoidValue{};
+   return VoidOptionConfig( rejectParameter( getOptionFactory().createOption( value ) ) );
 }
 
 ARGUMENTUM_INLINE VoidOptionConfig ParameterConfig::add_help_option(
       const std::string& name, const std::string& altName )
 {
-   if ( ( !name.empty() && name[0] != '-' ) || ( !altName.empty() && altName[0] != '-' ) )
-      throw std::invalid_argument( "A help argument must be an option." );
-
    auto value = VoidValue{};
    auto option = getOptionFactory().createOption( value );
+   if ( ( !name.empty() && name[0] != '-' ) || ( !altName.empty() && altName[0] != '-' ) ) {
+      failDefinition( std::invalid_argument( "A help argument must be an option." ) );
+      return VoidOptionConfig( rejectParameter( std::move( option ) ) );
+   }
+
    auto optionConfig =   // (clf)
          VoidOptionConfig( tryAddParameter( option, { name, altName } ) )
                .help( "Display this help message and exit." )
                .action( []( const std::string& optionName, Environment& env ) {
                   auto pFormatter = env.get_help_formatter( optionName );
-                  auto pStream = env.get_output_stream();
+                  auto pSink = env.get_output_sink();
                   const auto& parserDef = env.get_parser_def();
 
-                  pFormatter->format( parserDef, *pStream );
+                  pFormatter->format( parserDef, *pSink );
                   env.notify_help_was_shown();
                   env.exit_parser();
                } );
@@ -94,7 +114,7 @@ ARGUMENTUM_INLINE GroupConfig ParameterConfig::add_group( const std::string& nam
    auto pGroup = mParserDef.findGroup( name );
    if ( pGroup ) {
       if ( pGroup->isExclusive() )
-         throw MixingGroupTypes( name );
+         failDefinition( MixingGroupTypes( name ) );
       mParserDef.mpActiveGroup = pGroup;
    }
    else
@@ -108,7 +128,7 @@ ARGUMENTUM_INLINE GroupConfig ParameterConfig::add_exclusive_group( const std::s
    auto pGroup = mParserDef.findGroup( name );
    if ( pGroup ) {
       if ( !pGroup->isExclusive() )
-         throw MixingGroupTypes( name );
+         failDefinition( MixingGroupTypes( name ) );
       mParserDef.mpActiveGroup = pGroup;
    }
    else
@@ -131,13 +151,17 @@ ARGUMENTUM_INLINE OptionConfig ParameterConfig::tryAddParameter(
    };
    names.erase( std::remove_if( names.begin(), names.end(), is_empty ), names.end() );
 
-   if ( names.empty() )
-      throw std::invalid_argument( "An argument must have a name." );
+   if ( names.empty() ) {
+      failDefinition( std::invalid_argument( "An argument must have a name." ) );
+      return rejectParameter( std::move( newOption ) );
+   }
 
    for ( auto& name : names )
       for ( auto ch : name )
-         if ( std::isspace( ch ) )
-            throw std::invalid_argument( "Argument names must not contain spaces." );
+         if ( std::isspace( ch ) ) {
+            failDefinition( std::invalid_argument( "Argument names must not contain spaces." ) );
+            return rejectParameter( std::move( newOption ) );
+         }
 
    auto has_dash = []( auto name ) {
       return name[0] == '-';
@@ -151,18 +175,27 @@ ARGUMENTUM_INLINE OptionConfig ParameterConfig::tryAddParameter(
       return std::none_of( names.begin(), names.end(), has_dash );
    };
 
+   newOption.setStringPool( mParserDef.getStringPool() );
+
+   if ( isPositional( names ) || isOption( names ) ) {
+      auto pCache = mParserDef.getDefinitionCache();
+      if ( pCache && pCache->bindOption( newOption, names, mParserDef ) )
+         return addCachedOption( std::move( newOption ) );
+   }
+
    if ( isPositional( names ) )
       return addPositional( std::move( newOption ), names );
    else if ( isOption( names ) )
       return addOption( std::move( newOption ), names );
 
-   throw std::invalid_argument( "The argument must be either positional or an option." );
+   failDefinition( std::invalid_argument( "The argument must be either positional or an option." ) );
+   return rejectParameter( std::move( newOption ) );
 }
 
 ARGUMENTUM_INLINE OptionConfig ParameterConfig::addPositional(
       Option&& newOption, const std::vector<std::string_view>& names )
 {
-   auto pOption = std::make_shared<Option>( std::move( newOption ) );
+   auto pOption = mParserDef.storeOption( std::move( newOption ) );
    auto& option = *pOption;
 
    option.setLongName( names.empty() ? "arg" : names[0] );
@@ -185,21 +218,37 @@ ARGUMENTUM_INLINE OptionConfig ParameterConfig::addPositional(
 ARGUMENTUM_INLINE OptionConfig ParameterConfig::addOption(
       Option&& newOption, const std::vector<std::string_view>& names )
 {
-   trySetNames( newOption, names );
-   ensureIsNewOption( newOption.getLongName() );
-   ensureIsNewOption( newOption.getShortName() );
+   if ( !trySetNames( newOption, names ) || !ensureIsNewOption( newOption.getLongName() )
+         || !ensureIsNewOption( newOption.getShortName() ) )
+      return rejectParameter( std::move( newOption ) );
 
-   auto pOption = std::make_shared<Option>( std::move( newOption ) );
+   auto pOption = mParserDef.storeOption( std::move( newOption ) );
 
    if ( mParserDef.mpActiveGroup )
       pOption->setGroup( mParserDef.mpActiveGroup );
 
-   mParserDef.mOptions.push_back( pOption );
+   mParserDef.addOption( pOption );
    return { pOption };
 }
 
-ARGUMENTUM_INLINE void ParameterConfig::trySetNames(
-      Option& option, const std::vector<std::string_view>& names ) const
+// The names and the metadata of a cached option were validated when the cache
+// was created.
+ARGUMENTUM_INLINE OptionConfig ParameterConfig::addCachedOption( Option&& newOption )
+{
+   auto pOption = mParserDef.storeOption( std::move( newOption ) );
+   if ( pOption->isPositional() )
+      mParserDef.mPositional.push_back( pOption );
+   else
+      mParserDef.addOption( pOption );
+
+   auto config = OptionConfig( pOption );
+   config.mIsCached = true;
+   config.mpCache = mParserDef.mpDefinitionCache;
+   return config;
+}
+
+ARGUMENTUM_INLINE bool ParameterConfig::trySetNames(
+      Option& option, const std::vector<std::string_view>& names )
 {
    for ( auto name : names ) {
       if ( name.empty() || name == "-" || name == "--" || name[0] != '-' )
@@ -208,56 +257,75 @@ ARGUMENTUM_INLINE void ParameterConfig::trySetNames(
       if ( name.substr( 0, 2 ) == "--" )
          option.setLongName( name );
       else if ( name.substr( 0, 1 ) == "-" ) {
-         if ( name.size() > 2 )
-            throw std::invalid_argument( "Short option name has too many characters." );
+         if ( name.size() > 2 ) {
+            failDefinition(
+                  std::invalid_argument( "Short option name has too many characters." ) );
+            return false;
+         }
          option.setShortName( name );
       }
    }
 
-   if ( option.getName().empty() )
-      throw std::invalid_argument( "An option must have a name." );
+   if ( option.getName().empty() ) {
+      failDefinition( std::invalid_argument( "An option must have a name." ) );
+      return false;
+   }
+   return true;
 }
 
-ARGUMENTUM_INLINE void ParameterConfig::ensureIsNewOption( const std::string& name )
+ARGUMENTUM_INLINE bool ParameterConfig::ensureIsNewOption( const std::string& name )
 {
    if ( name.empty() )
-      return;
+      return true;
 
    auto pOption = mParserDef.findOption( name );
    if ( pOption ) {
       auto groupName = pOption->getGroup() ? pOption->getGroup()->getName() : "";
-      throw DuplicateOption( groupName, name );
+      failDefinition( DuplicateOption( groupName, name ) );
+      return false;
    }
+   return true;
 }
 
 ARGUMENTUM_INLINE CommandConfig ParameterConfig::tryAddCommand( Command& command )
 {
+   auto reject = [&]( const char* message ) {
+      failDefinition( std::invalid_argument( message ) );
+      return rejectCommand( std::move( command ) );
+   };
+
    if ( command.getName().empty() )
-      throw std::invalid_argument( "A command must have a name." );
+      return reject( "A command must have a name." );
    if ( !command.hasOptions() && !command.hasFactory() )
-      throw std::invalid_argument( "A command must have an options factory." );
+      return reject( "A command must have an options factory." );
    if ( command.getName()[0] == '-' )
-      throw std::invalid_argument( "Command name must not start with a dash." );
+      return reject( "Command name must not start with a dash." );
 
-   ensureIsNewCommand( command.getName() );
+   auto pCache = mParserDef.getDefinitionCache();
+   if ( !pCache || !pCache->bindCommand( command.getName() ) )
+      if ( !ensureIsNewCommand( command.getName() ) )
+         return rejectCommand( std::move( command ) );
 
    auto pCommand = std::make_shared<Command>( std::move( command ) );
-   mParserDef.mCommands.push_back( pCommand );
+   mParserDef.addCommand( pCommand );
    return { pCommand };
 }
 
-ARGUMENTUM_INLINE void ParameterConfig::ensureIsNewCommand( const std::string& name )
+ARGUMENTUM_INLINE bool ParameterConfig::ensureIsNewCommand( const std::string& name )
 {
    auto pCommand = mParserDef.findCommand( name );
-   if ( pCommand )
-      throw DuplicateCommand( name );
+   if ( pCommand ) {
+      failDefinition( DuplicateCommand( name ) );
+      return false;
+   }
+   return true;
 }
 
 ARGUMENTUM_INLINE std::shared_ptr<OptionGroup> ParameterConfig::addGroup(
       std::string name, bool isExclusive )
 {
    if ( name.empty() )
-      throw std::invalid_argument( "A group must have a name." );
+      failDefinition( std::invalid_argument( "A group must have a name." ) );
 
    std::transform( name.begin(), name.end(), name.begin(), []( char ch ) {
       return char( tolower( ch ) );
@@ -269,4 +337,22 @@ ARGUMENTUM_INLINE std::shared_ptr<OptionGroup> ParameterConfig::addGroup(
    return pGroup;
 }
 
+template<typename TError>
+void ParameterConfig::failDefinition( const TError& error )
+{
+   throw_or_report( error, [this]( std::string_view message ) {
+      mParserDef.addDefinitionError( message );
+   } );
+}
+
+ARGUMENTUM_INLINE OptionConfig ParameterConfig::rejectParameter( Option&& option )
+{
+   return { mParserDef.storeOption( std::move( option ) ) };
+}
+
+ARGUMENTUM_INLINE CommandConfig ParameterConfig::rejectCommand( Command&& command )
+{
+   return { std::make_shared<Command>( std::move( command ) ) };
+}
+
 }   // namespace argumentum
@@ -3,20 +3,26 @@
 
 #pragma once
 
+#include "argumentstream.h"
+#include "configfile.h"
 #include "parserconfig.h"
 #include "parserdefinition.h"
 
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace argumentum {
 
 class Option;
 class Command;
+class argument_parser;
+class incremental_parser;
 class ParseResultBuilder;
-class ArgumentStream;
 enum class EArgumentType;
 
 class Parser
@@ -28,26 +34,123 @@ class Parser
    size_t mPosition = 0;
    // The active option will receive additional argument(s)
    Option* mpActiveOption = nullptr;
+   // The vector option that already reserved the space for the values in the
+   // current run of arguments.
+   Option* mpReservedOption = nullptr;
+   // The arguments that follow the current argument in the window of a
+   // contiguous argument stream.  Not set when the arguments are read with
+   // next().
+   std::optional<ArgumentWindow> mUpcoming;
+   // When a command is selected, the rest of the arguments are parsed by the
+   // command's parser.
+   std::unique_ptr<argument_parser> mpCommandParser;
+   std::unique_ptr<incremental_parser> mpCommandParse;
+
+   // The values of the options from the sources other than the input
+   // arguments are kept in layers until the parse is finished.  The layers
+   // of the configuration files have precedence in the order in which the
+   // files were fed.  The environment has precedence over the files and the
+   // input arguments have precedence over all the layers.  An option is
+   // assigned only the values from the layer with the highest precedence
+   // unless it appends the values of all the layers.
+   struct ValueLayer
+   {
+      // nullptr for the environment
+      const config_file* pFile;
+      unsigned rank;
+      // The range of the values of the layer in mLayerValues.
+      size_t begin;
+      size_t end;
+   };
+   struct LayerValue
+   {
+      // nullptr when the value was already assigned
+      Option* pOption;
+      // The name of the environment variable or the key in the file.
+      std::string_view key;
+      std::string_view value;
+      unsigned layer;
+      unsigned line;
+      bool hasValue;
+   };
+   // The sources of the values that were assigned in this parse.
+   struct AssignedSource
+   {
+      const Option* pOption;
+      // -1 for the input arguments
+      int layer;
+      std::string_view key;
+      unsigned count;
+   };
+   std::vector<ValueLayer> mLayers;
+   std::vector<LayerValue> mLayerValues;
+   // The indices of the unassigned layer values in the order of the
+   // precedence of their layers and the same indices grouped by option.
+   // Rebuilt only when a layer was added since they were built.
+   std::vector<size_t> mOrderedValues;
+   std::unordered_map<const Option*, std::vector<size_t>> mOptionValues;
+   size_t mIndexedLayerCount = 0;
+   std::vector<AssignedSource> mAssignedSources;
+   // The variables read from the environment when the parse started.
+   std::deque<std::string> mEnvironment;
+   // The section of the configuration files that holds the values of this
+   // parser.
+   std::string mConfigSection;
+   // The location of the values that are currently assigned if they do not
+   // come from the input arguments.
+   std::string mErrorSource;
 
 public:
    Parser( const ParserDefinition& argParser, ParseResultBuilder& result );
-   void parse( ArgumentStream& argStream );
+   ~Parser();
+
+   // Parse the next chunk of arguments.  The parse may continue with another
+   // chunk.
+   void feed( ArgumentStream& argStream );
+
+   // Read the values of the options from a configuration file.  The values
+   // are assigned in finish() if they are not set by the input arguments.
+   void feed( const config_file& file );
+
+   // Close the active option and finish the assignments after the last chunk.
+   void finish();
+
+   // Close the sink targets when the parse is abandoned before finish() so
+   // that their consumers are not blocked.
+   void closeTargets();
 
 private:
    void startOption( std::string_view name );
    bool optionWithNameExists( std::string_view name );
    bool haveActiveOption() const;
    void closeOption();
-   void addFreeArgument( std::string_view arg );
+   void addFreeArgument( std::string_view arg, ArgumentStream& argStream );
    void addError( std::string_view optionName, int errorCode );
    void setValue( Option& option, std::string_view value );
    void autoSetMissingValue( Option& option );
+   template<typename TAssign>
+   void assignAndReport( Option& option, TAssign&& assign );
+   void finishAssignments();
+   void readEnvironment();
+   void readConfigFile( const config_file& file );
+   void addLayer( const config_file* pFile, unsigned rank );
+   void indexLayerValues();
+   void assignLayerValues( const Option* pSelected );
+   bool assignLayerValue( const LayerValue& value );
+   void addArgumentSources();
+   void reportValueSources();
+   void reserveValues( Option& option, ArgumentStream& argStream );
+   size_t countUpcomingValues( ArgumentStream& argStream );
+   bool isValueLike( std::string_view arg );
 
-   void parse( ArgumentStream& argStream, unsigned depth );
-   void parseCommandArguments(
-         Command& command, ArgumentStream& argStream, ParseResultBuilder& result );
+   enum class EParseStep { next, stop, fail };
+   bool parse( ArgumentStream& argStream, unsigned depth );
+   EParseStep parseArgument(
+         std::string_view arg, EArgumentType type, ArgumentStream& argStream, unsigned depth );
+   void startCommand( Command& command );
+   bool forwardToCommand( ArgumentStream& argStream );
    void parseForwardedArguments( Option& option, std::string_view args );
-   void parseSubstream( std::string_view streamName, unsigned depth );
+   bool parseSubstream( std::string_view streamName, unsigned depth );
    EArgumentType getNextArgumentType( std::string_view arg );
 };
 
@@ -6,32 +6,352 @@
 #include "argparser.h"
 #include "argumentstream.h"
 #include "command.h"
+#include "incrementalparser.h"
 #include "option.h"
 #include "parser.h"
 #include "parseresult.h"
 
-#include <regex>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#ifndef _WIN32
+extern char** environ;
+#endif
 
 namespace argumentum {
 
 ARGUMENTUM_INLINE Parser::Parser( const ParserDefinition& parserDef, ParseResultBuilder& result )
    : mParserDef( parserDef )
    , mResult( result )
-{}
+{
+   if ( mParserDef.hasEnvironmentOptions() )
+      readEnvironment();
+}
 
-ARGUMENTUM_INLINE void Parser::parse( ArgumentStream& argStream )
+ARGUMENTUM_INLINE Parser::~Parser() = default;
+
+ARGUMENTUM_INLINE void Parser::feed( ArgumentStream& argStream )
 {
-   mResult.clear();
+   if ( forwardToCommand( argStream ) || mResult.wasExitRequested() )
+      return;
 
-   try {
-      parse( argStream, 0 );
-   }
-   catch ( const IncludeDepthExceeded& e ) {
-      mResult.addError( e.what(), INCLUDE_TOO_DEEP );
+   parse( argStream, 0 );
+}
+
+ARGUMENTUM_INLINE void Parser::feed( const config_file& file )
+{
+   readConfigFile( file );
+   if ( mpCommandParse )
+      mpCommandParse->feed( file );
+}
+
+ARGUMENTUM_INLINE void Parser::finish()
+{
+   if ( mpCommandParse ) {
+      mResult.addResult( mpCommandParse->finish() );
+      mpCommandParse.reset();
+      mpCommandParser.reset();
    }
 
    if ( haveActiveOption() )
       closeOption();
+
+   addArgumentSources();
+   assignLayerValues( nullptr );
+   finishAssignments();
+   reportValueSources();
+}
+
+ARGUMENTUM_INLINE void Parser::readEnvironment()
+{
+#ifdef _WIN32
+   auto ppEnv = _environ;
+#else
+   auto ppEnv = environ;
+#endif
+   if ( !ppEnv )
+      return;
+
+   // The environment has precedence over all the configuration files.
+   addLayer( nullptr, std::numeric_limits<unsigned>::max() );
+
+   // Every variable is looked up once in the hashed index of the names.
+   std::string name;
+   for ( ; *ppEnv; ++ppEnv ) {
+      auto var = std::string_view( *ppEnv );
+      auto eqpos = var.find( '=' );
+      if ( eqpos == std::string_view::npos || eqpos == 0 )
+         continue;
+
+      name.assign( var.substr( 0, eqpos ) );
+      auto pOption = mParserDef.findEnvironmentOption( name );
+      if ( pOption ) {
+         // The values are copied because the environment may change before
+         // the parse is finished.
+         auto& stored = mEnvironment.emplace_back( var );
+         auto storedVar = std::string_view( stored );
+         mLayerValues.push_back( { pOption, storedVar.substr( 0, eqpos ),
+               storedVar.substr( eqpos + 1 ), unsigned( mLayers.size() - 1 ), 0, true } );
+      }
+   }
+   mLayers.back().end = mLayerValues.size();
+}
+
+ARGUMENTUM_INLINE void Parser::addLayer( const config_file* pFile, unsigned rank )
+{
+   mLayers.push_back( { pFile, rank, mLayerValues.size(), mLayerValues.size() } );
+}
+
+ARGUMENTUM_INLINE void Parser::readConfigFile( const config_file& file )
+{
+   if ( mConfigSection.empty() ) {
+      for ( auto& item : file.invalid_entries() )
+         mResult.addError( ParseError( item.key, INVALID_CONFIG, {}, file.location( item.line ) ) );
+   }
+
+   // A file fed later has precedence over the files fed before it.
+   unsigned rank = 0;
+   for ( auto& layer : mLayers )
+      if ( layer.pFile )
+         ++rank;
+   addLayer( &file, rank );
+   auto layerIndex = unsigned( mLayers.size() - 1 );
+
+   unsigned reportedSectionLine = 0;
+   for ( auto& item : file.entries() ) {
+      // The section relative to the section of this parser.
+      auto section = item.section;
+      if ( !mConfigSection.empty() ) {
+         if ( section.substr( 0, mConfigSection.size() ) != mConfigSection )
+            continue;
+         section.remove_prefix( mConfigSection.size() );
+         if ( !section.empty() ) {
+            if ( section[0] != '.' )
+               continue;
+            section.remove_prefix( 1 );
+         }
+      }
+
+      // The values of commands are read by the parsers of the commands when
+      // the commands are selected.
+      std::shared_ptr<OptionGroup> pGroup;
+      if ( !section.empty() ) {
+         if ( mParserDef.findCommand( section.substr( 0, section.find( '.' ) ) ) )
+            continue;
+
+         if ( section.find( '.' ) == std::string_view::npos )
+            pGroup = mParserDef.findGroup( std::string( section ) );
+
+         if ( !pGroup ) {
+            if ( item.sectionLine != reportedSectionLine ) {
+               reportedSectionLine = item.sectionLine;
+               mResult.addError( ParseError( "[" + std::string( item.section ) + "]",
+                     UNKNOWN_OPTION, {}, file.location( item.sectionLine ) ) );
+            }
+            continue;
+         }
+      }
+
+      auto pOption = mParserDef.findLongOption( item.key );
+      if ( !pOption || ( pGroup && pOption->getGroup() != pGroup ) ) {
+         // The keys are suggested from the long names of the options.
+         std::vector<std::string> suggestions;
+         if ( !pOption ) {
+            for ( auto& name : mParserDef.suggestOptions( "--" + std::string( item.key ) ) )
+               if ( name.substr( 0, 2 ) == "--" )
+                  suggestions.push_back( name.substr( 2 ) );
+         }
+         mResult.addError( ParseError(
+               item.key, UNKNOWN_OPTION, std::move( suggestions ), file.location( item.line ) ) );
+         continue;
+      }
+
+      mLayerValues.push_back(
+            { pOption, item.key, item.value, layerIndex, item.line, item.hasValue } );
+   }
+   mLayers.back().end = mLayerValues.size();
+}
+
+namespace detail {
+ARGUMENTUM_INLINE bool equalsIgnoringCase( std::string_view text, std::string_view lower )
+{
+   return text.size() == lower.size()
+         && std::equal( text.begin(), text.end(), lower.begin(), []( char a, char b ) {
+               return std::tolower( static_cast<unsigned char>( a ) ) == b;
+            } );
+}
+
+ARGUMENTUM_INLINE bool isFlagValueSet( std::string_view value )
+{
+   return !( value.empty() || value == "0" || equalsIgnoringCase( value, "false" )
+         || equalsIgnoringCase( value, "no" ) || equalsIgnoringCase( value, "off" ) );
+}
+}   // namespace detail
+
+// Order the unassigned layer values by the precedence of their layers so
+// that the layers are not sorted every time the values are assigned.
+ARGUMENTUM_INLINE void Parser::indexLayerValues()
+{
+   std::vector<const ValueLayer*> layers;
+   for ( auto& layer : mLayers )
+      layers.push_back( &layer );
+   std::stable_sort( layers.begin(), layers.end(),
+         []( auto pa, auto pb ) { return pa->rank < pb->rank; } );
+
+   mOrderedValues.clear();
+   mOptionValues.clear();
+   for ( auto pLayer : layers ) {
+      for ( auto i = pLayer->begin; i < pLayer->end; ++i ) {
+         auto pOption = mLayerValues[i].pOption;
+         if ( pOption ) {
+            mOrderedValues.push_back( i );
+            mOptionValues[pOption].push_back( i );
+         }
+      }
+   }
+   mIndexedLayerCount = mLayers.size();
+}
+
+// Assign the values from the layers to the selected option or to all the
+// options when @p pSelected is nullptr.  The values of an option are
+// converted only from the layer with the highest precedence and a single
+// value option is converted only from the last value in the layer.
+ARGUMENTUM_INLINE void Parser::assignLayerValues( const Option* pSelected )
+{
+   if ( mLayerValues.empty() )
+      return;
+
+   if ( mIndexedLayerCount != mLayers.size() )
+      indexLayerValues();
+
+   auto* pIndices = &mOrderedValues;
+   if ( pSelected ) {
+      auto it = mOptionValues.find( pSelected );
+      if ( it == mOptionValues.end() )
+         return;
+      pIndices = &it->second;
+   }
+
+   auto forEachValue = [&]( auto&& fn ) {
+      for ( auto i : *pIndices ) {
+         auto& value = mLayerValues[i];
+         if ( value.pOption )
+            fn( value, mLayers[value.layer], i );
+      }
+   };
+
+   // The options that were assigned from the input arguments or through an
+   // exclusive group do not accept values from the layers.
+   struct Winner
+   {
+      unsigned rank;
+      size_t last;
+      bool isBlocked;
+   };
+   std::unordered_map<const Option*, Winner> winners;
+   forEachValue( [&]( const LayerValue& value, const ValueLayer& layer, size_t index ) {
+      auto& option = *value.pOption;
+      auto it = winners.find( &option );
+      if ( it == winners.end() ) {
+         auto isBlocked = ( !option.appendsSources() && option.wasAssigned() )
+               || mParserDef.getValidator().wasExclusiveGroupAssignedByOther( option );
+         it = winners.emplace( &option, Winner{ layer.rank, index, isBlocked } ).first;
+      }
+      it->second.rank = layer.rank;
+      it->second.last = index;
+   } );
+
+   std::map<std::pair<const Option*, unsigned>, size_t> sourceIndex;
+   forEachValue( [&]( LayerValue& value, const ValueLayer& layer, size_t index ) {
+      auto& option = *value.pOption;
+      auto& winner = winners[&option];
+      auto isAccepted = !winner.isBlocked
+            && ( option.appendsSources()
+                  || ( layer.rank == winner.rank
+                        && ( option.hasVectorValue() || index == winner.last ) ) );
+
+      if ( isAccepted && assignLayerValue( value ) ) {
+         auto key = std::make_pair( &option, value.layer );
+         auto it = sourceIndex.find( key );
+         if ( it != sourceIndex.end() )
+            ++mAssignedSources[it->second].count;
+         else {
+            sourceIndex.emplace( key, mAssignedSources.size() );
+            mAssignedSources.push_back( { &option, int( value.layer ), value.key, 1 } );
+         }
+      }
+      value.pOption = nullptr;
+   } );
+
+   if ( pSelected )
+      mOptionValues.erase( pSelected );
+   else {
+      mOrderedValues.clear();
+      mOptionValues.clear();
+   }
+   mErrorSource.clear();
+}
+
+ARGUMENTUM_INLINE bool Parser::assignLayerValue( const LayerValue& value )
+{
+   auto& option = *value.pOption;
+   auto pFile = mLayers[value.layer].pFile;
+   mErrorSource = pFile ? pFile->location( value.line ) : std::string( value.key );
+
+   option.onOptionStarted();
+   if ( !option.acceptsAnyArguments() ) {
+      if ( value.hasValue && !detail::isFlagValueSet( value.value ) )
+         return false;
+      setValue( option, option.getFlagValue() );
+   }
+   else if ( !value.hasValue ) {
+      addError( option.getHelpName(), MISSING_ARGUMENT );
+      return false;
+   }
+   else
+      setValue( option, value.value );
+   return true;
+}
+
+// The values assigned before the layers are assigned come from the input
+// arguments, except for the values of the options that append the values of
+// all the layers.
+ARGUMENTUM_INLINE void Parser::addArgumentSources()
+{
+   std::unordered_map<const Option*, unsigned> layerCounts;
+   for ( auto& source : mAssignedSources )
+      layerCounts[source.pOption] += source.count;
+
+   auto addSource = [&]( const Option& option ) {
+      auto count = unsigned( option.getAssignCount() );
+      auto it = layerCounts.find( &option );
+      if ( it != layerCounts.end() )
+         count -= std::min( count, it->second );
+      if ( count > 0 )
+         mAssignedSources.push_back( { &option, -1, {}, count } );
+   };
+
+   mParserDef.forEachActiveOption( addSource );
+}
+
+ARGUMENTUM_INLINE void Parser::reportValueSources()
+{
+   for ( auto& source : mAssignedSources ) {
+      auto& name = source.pOption->getName();
+      if ( source.layer < 0 )
+         mResult.addValueSource( { name, EValueSource::arguments, {}, source.count } );
+      else if ( auto pFile = mLayers[source.layer].pFile )
+         mResult.addValueSource( { name, EValueSource::config, pFile->path(), source.count } );
+      else {
+         mResult.addValueSource( { name, EValueSource::environment, std::string( source.key ),
+               source.count } );
+      }
+   }
+   mAssignedSources.clear();
 }
 
 enum class EArgumentType {
@@ -60,20 +380,59 @@ enum class EArgumentType {
    commandName
 };
 
-namespace {
+namespace detail {
+// Returns true if all the characters of @p text, and at least one, satisfy
+// @p isDigit.
+template<typename TPredicate>
+bool areAllDigits( std::string_view text, TPredicate isDigit )
+{
+   return !text.empty() && std::all_of( text.begin(), text.end(), isDigit );
+}
+
+// Returns true if @p text matches `D*\.?D+(X[-+]?D+)?` where D are the
+// digits accepted by @p isDigit and X are the characters in @p exponent.
+template<typename TPredicate>
+bool isMantissaWithExponent(
+      std::string_view text, TPredicate isDigit, std::string_view exponent )
+{
+   auto expos = text.find_first_of( exponent );
+   if ( expos != std::string_view::npos ) {
+      auto power = text.substr( expos + 1 );
+      if ( !power.empty() && ( power[0] == '-' || power[0] == '+' ) )
+         power.remove_prefix( 1 );
+      if ( !areAllDigits( power, isDigit ) )
+         return false;
+      text = text.substr( 0, expos );
+   }
+
+   auto dotpos = text.find( '.' );
+   if ( dotpos == std::string_view::npos )
+      return areAllDigits( text, isDigit );
+
+   auto whole = text.substr( 0, dotpos );
+   return ( whole.empty() || areAllDigits( whole, isDigit ) )
+         && areAllDigits( text.substr( dotpos + 1 ), isDigit );
+}
+
+// Returns true if @p arg is a binary, octal, decimal or hexadecimal number
+// in one of the forms accepted by the conversion functions.
 ARGUMENTUM_INLINE bool isNumberLike( std::string_view arg )
 {
-   static auto rxNumber = std::regex(
-         "^0b[01]+$"
-         "|"
-         "^0o[0-7]+$"
-         "|"
-         "^(0d)?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?$"
-         "|"
-         "^0x[0-9a-fA-F]*\\.?[0-9a-fA-F]+([pP][-+]?[0-9a-fA-F]+)?$" );
-   return std::regex_match( std::begin( arg ), std::end( arg ), rxNumber );
+   auto isDecimal = []( char ch ) { return ch >= '0' && ch <= '9'; };
+   auto prefix = arg.substr( 0, 2 );
+   if ( prefix == "0b" )
+      return areAllDigits( arg.substr( 2 ), []( char ch ) { return ch == '0' || ch == '1'; } );
+   if ( prefix == "0o" )
+      return areAllDigits( arg.substr( 2 ), []( char ch ) { return ch >= '0' && ch <= '7'; } );
+   if ( prefix == "0x" ) {
+      auto isHex = []( char ch ) { return std::isxdigit( static_cast<unsigned char>( ch ) ) != 0; };
+      return isMantissaWithExponent( arg.substr( 2 ), isHex, "pP" );
+   }
+   if ( prefix == "0d" )
+      arg.remove_prefix( 2 );
+   return isMantissaWithExponent( arg, isDecimal, "eE" );
 }
-}   // namespace
+}   // namespace detail
 
 ARGUMENTUM_INLINE bool Parser::optionWithNameExists( std::string_view name )
 {
@@ -106,7 +465,7 @@ ARGUMENTUM_INLINE EArgumentType Parser::getNextArgumentType( std::string_view ar
    const auto negativeMode = ENegativeMode::argumentum;
 
    if ( arg.substr( 0, 1 ) == "-" ) {
-      if ( isNumberLike( arg.substr( 1 ) ) ) {
+      if ( detail::isNumberLike( arg.substr( 1 ) ) ) {
          if constexpr ( negativeMode == ENegativeMode::argparse ) {
             if ( !mParserDef.hasNumericOptions() )
                return haveActiveOption() ? EArgumentType::optionValue : EArgumentType::freeArgument;
@@ -140,63 +499,113 @@ ARGUMENTUM_INLINE EArgumentType Parser::getNextArgumentType( std::string_view ar
    return EArgumentType::freeArgument;
 }
 
-ARGUMENTUM_INLINE void Parser::parse( ArgumentStream& argStream, unsigned depth )
+// The arguments of a contiguous stream are read from its windows.  The
+// position of the stream is moved only before the arguments that continue
+// with the stream (includes and commands) and at the end of a window.
+ARGUMENTUM_INLINE bool Parser::parse( ArgumentStream& argStream, unsigned depth )
 {
-   for ( auto optArg = argStream.next(); !!optArg; optArg = argStream.next() ) {
-      switch ( getNextArgumentType( *optArg ) ) {
-         case EArgumentType::include:
-            parseSubstream( optArg->substr( 1 ), depth );
-            continue;
-
-         case EArgumentType::endOfOptions:
-            mIgnoreOptions = true;
-            continue;
-
-         case EArgumentType::freeArgument:
-            addFreeArgument( *optArg );
-            continue;
+   mpReservedOption = nullptr;
+   while ( true ) {
+      auto window = argStream.window();
+      if ( window.empty() ) {
+         mUpcoming.reset();
+         auto optArg = argStream.next();
+         if ( !optArg )
+            return true;
+         auto step = parseArgument( *optArg, getNextArgumentType( *optArg ), argStream, depth );
+         if ( step != EParseStep::next )
+            return step == EParseStep::stop;
+         continue;
+      }
 
-         case EArgumentType::longOption:
-         case EArgumentType::shortOption:
-            startOption( *optArg );
-            break;
+      // The window is not valid after the stream is used by an argument.
+      size_t consumed = 0;
+      bool isStreamUsed = false;
+      while ( !isStreamUsed && consumed < window.size() ) {
+         auto arg = window[consumed++];
+         auto type = getNextArgumentType( arg );
+         isStreamUsed = type == EArgumentType::include || type == EArgumentType::commandName;
+         if ( isStreamUsed ) {
+            argStream.advance( consumed );
+            mUpcoming.reset();
+         }
+         else
+            mUpcoming = window.tail( consumed );
 
-         case EArgumentType::multiOption: {
-            auto arg_view = std::string_view( *optArg );
-            auto opt = std::string{ "--" };
-            for ( unsigned i = 1; i < arg_view.size(); ++i ) {
-               opt[1] = arg_view[i];
-               startOption( opt );
-            }
-            break;
+         auto step = parseArgument( arg, type, argStream, depth );
+         if ( step != EParseStep::next ) {
+            if ( !isStreamUsed )
+               argStream.advance( consumed );
+            return step == EParseStep::stop;
          }
+      }
 
-         case EArgumentType::optionValue:
-            assert( mpActiveOption != nullptr );
-            setValue( *mpActiveOption, *optArg );
-            if ( !mpActiveOption->willAcceptArgument() )
-               closeOption();
-            break;
+      if ( !isStreamUsed )
+         argStream.advance( consumed );
+   }
+}
 
-         case EArgumentType::commandName: {
-            auto pCommand = mParserDef.findCommand( *optArg );
-            if ( pCommand ) {
-               parseCommandArguments( *pCommand, argStream, mResult );
-               return;
-            }
-            break;
+ARGUMENTUM_INLINE Parser::EParseStep Parser::parseArgument(
+      std::string_view arg, EArgumentType type, ArgumentStream& argStream, unsigned depth )
+{
+   switch ( type ) {
+      case EArgumentType::include:
+         if ( !parseSubstream( arg.substr( 1 ), depth ) )
+            return EParseStep::fail;
+         if ( forwardToCommand( argStream ) )
+            return EParseStep::stop;
+         mpReservedOption = nullptr;
+         return EParseStep::next;
+
+      case EArgumentType::endOfOptions:
+         mIgnoreOptions = true;
+         return EParseStep::next;
+
+      case EArgumentType::freeArgument:
+         addFreeArgument( arg, argStream );
+         return EParseStep::next;
+
+      case EArgumentType::longOption:
+      case EArgumentType::shortOption:
+         startOption( arg );
+         break;
+
+      case EArgumentType::multiOption: {
+         auto opt = std::string{ "--" };
+         for ( unsigned i = 1; i < arg.size(); ++i ) {
+            opt[1] = arg[i];
+            startOption( opt );
          }
+         break;
       }
 
-      if ( mResult.wasExitRequested() )
-         return;
+      case EArgumentType::optionValue:
+         assert( mpActiveOption != nullptr );
+         reserveValues( *mpActiveOption, argStream );
+         setValue( *mpActiveOption, arg );
+         if ( !mpActiveOption->willAcceptArgument() )
+            closeOption();
+         break;
+
+      case EArgumentType::commandName: {
+         auto pCommand = mParserDef.findCommand( arg );
+         if ( pCommand ) {
+            startCommand( *pCommand );
+            forwardToCommand( argStream );
+            return EParseStep::stop;
+         }
+         break;
+      }
    }
+
+   return mResult.wasExitRequested() ? EParseStep::stop : EParseStep::next;
 }
 
 ARGUMENTUM_INLINE void Parser::startOption( std::string_view optionStr )
 {
    if ( haveActiveOption() )
       closeOption();
+   mpReservedOption = nullptr;
 
    std::string_view name;
    std::string_view arg;
@@ -223,9 +632,26 @@ ARGUMENTUM_INLINE void Parser::startOption( std::string_view optionStr )
    else
       name = optionStr;
 
-   auto pOption = mParserDef.findOption( name );
+   Option* pOption = nullptr;
+   if ( mParserDef.getConfig().allow_abbrev() && name.substr( 0, 2 ) == "--" ) {
+      std::vector<std::string> candidates;
+      pOption = mParserDef.findAbbreviatedOption( name, candidates );
+      if ( !candidates.empty() ) {
+         mResult.addError( ParseError( name, AMBIGUOUS_OPTION, std::move( candidates ) ) );
+         return;
+      }
+   }
+   else
+      pOption = mParserDef.findOption( name );
+
    if ( pOption ) {
       auto& option = *pOption;
+
+      // The values from the layers precede the values from the input
+      // arguments when the option appends the values of all the sources.
+      if ( option.appendsSources() && !option.wasAssignedThroughThisOption() )
+         assignLayerValues( pOption );
+
       option.onOptionStarted();
       if ( option.willAcceptArgument() )
          mpActiveOption = pOption;
@@ -240,7 +666,7 @@ ARGUMENTUM_INLINE void Parser::startOption( std::string_view optionStr )
       }
    }
    else
-      addError( name, UNKNOWN_OPTION );
+      mResult.addError( ParseError( name, UNKNOWN_OPTION, mParserDef.suggestOptions( name ) ) );
 }
 
 ARGUMENTUM_INLINE void Parser::parseForwardedArguments( Option& option, std::string_view args )
@@ -253,13 +679,13 @@ ARGUMENTUM_INLINE void Parser::parseForwardedArguments( Option& option, std::str
          setValue( option, str );
    } );
 
-   std::stringstream ssarg;
+   std::string arg;
    auto it = args.begin();
 
    // The parameter args is the part of the opition after the comma, so the
    // first comma of args is always escaped.
    if ( it != args.end() && *it == ',' ) {
-      ssarg << ',';
+      arg += ',';
       ++it;
    }
 
@@ -267,20 +693,20 @@ ARGUMENTUM_INLINE void Parser::parseForwardedArguments( Option& option, std::str
       if ( *it == ',' ) {
          auto inext = it + 1;
          if ( inext != args.end() && *inext == ',' ) {
-            ssarg << ',';
+            arg += ',';
             it = inext;
          }
          else {
-            addArg( ssarg.str() );
-            ssarg.str( "" );
+            addArg( arg );
+            arg.clear();
          }
          continue;
       }
 
-      ssarg << *it;
+      arg += *it;
    }
 
-   addArg( ssarg.str() );
+   addArg( arg );
 }
 
 ARGUMENTUM_INLINE bool Parser::haveActiveOption() const
@@ -300,94 +726,225 @@ ARGUMENTUM_INLINE void Parser::closeOption()
    mpActiveOption = nullptr;
 }
 
-ARGUMENTUM_INLINE void Parser::addFreeArgument( std::string_view arg )
+ARGUMENTUM_INLINE void Parser::addFreeArgument( std::string_view arg, ArgumentStream& argStream )
 {
    while ( mPosition < mParserDef.mPositional.size() ) {
       auto& option = *mParserDef.mPositional[mPosition];
       if ( option.willAcceptArgument() ) {
+         reserveValues( option, argStream );
          setValue( option, arg );
          return;
       }
       ++mPosition;
    }
 
-   mResult.addIgnored( arg );
+   // An argument similar to a command name is probably a misspelled command.
+   auto suggestions = mParserDef.suggestCommands( arg );
+   if ( !suggestions.empty() )
+      mResult.addError( ParseError( arg, UNKNOWN_COMMAND, std::move( suggestions ) ) );
+   else
+      mResult.addIgnored( arg );
 }
 
 ARGUMENTUM_INLINE void Parser::addError( std::string_view optionName, int errorCode )
 {
-   mResult.addError( optionName, errorCode );
+   if ( mErrorSource.empty() )
+      mResult.addError( optionName, errorCode );
+   else
+      mResult.addError( ParseError( optionName, errorCode, {}, mErrorSource ) );
 }
 
 ARGUMENTUM_INLINE void Parser::setValue( Option& option, std::string_view value )
 {
-   try {
-      auto env = Environment{ option, mResult, mParserDef };
-      option.setValue( value, env );
-   }
-   catch ( const InvalidChoiceError& ) {
-      addError( option.getHelpName(), INVALID_CHOICE );
-   }
-   catch ( const std::invalid_argument& ) {
-      addError( option.getHelpName(), CONVERSION_ERROR );
-   }
-   catch ( const std::out_of_range& ) {
-      addError( option.getHelpName(), CONVERSION_ERROR );
-   }
+   assignAndReport( option, [&]( Environment& env ) {
+      return option.setValue( value, env );
+   } );
 }
 
 ARGUMENTUM_INLINE void Parser::autoSetMissingValue( Option& option )
 {
+   assignAndReport( option, [&]( Environment& env ) {
+      return option.autoSetMissingValue( env );
+   } );
+}
+
+// The built-in conversions report their errors in the returned status.  The
+// conversions of the custom types and the actions may also throw.
+template<typename TAssign>
+void Parser::assignAndReport( Option& option, TAssign&& assign )
+{
+   auto env = Environment{ option, mResult, mParserDef };
+   AssignStatus status;
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   status = assign( env );
+#else
    try {
-      auto env = Environment{ option, mResult, mParserDef };
-      option.autoSetMissingValue( env );
+      status = assign( env );
+   }
+   catch ( const ListElementError& e ) {
+      status = { EConversionError::invalidValue, e.index() };
    }
    catch ( const InvalidChoiceError& ) {
-      addError( option.getHelpName(), INVALID_CHOICE );
+      status = { EConversionError::invalidChoice, {} };
    }
    catch ( const std::invalid_argument& ) {
-      addError( option.getHelpName(), CONVERSION_ERROR );
+      status = { EConversionError::invalidValue, {} };
    }
    catch ( const std::out_of_range& ) {
+      status = { EConversionError::outOfRange, {} };
+   }
+#endif
+   mParserDef.getValidator().markAssigned( option );
+
+   if ( status.error == EConversionError::invalidChoice )
+      addError( option.getHelpName(), INVALID_CHOICE );
+   else if ( status.element )
+      addError( option.getHelpName() + "[" + std::to_string( *status.element ) + "]",
+            CONVERSION_ERROR );
+   else if ( status.error != EConversionError::none )
       addError( option.getHelpName(), CONVERSION_ERROR );
+}
+
+ARGUMENTUM_INLINE void Parser::finishAssignments()
+{
+   auto convert = [this]( Option& option ) {
+      for ( auto index : option.finishAssignments() )
+         addError( option.getHelpName() + "[" + std::to_string( index ) + "]", CONVERSION_ERROR );
+   };
+
+   mParserDef.forEachActiveOption( convert );
+}
+
+ARGUMENTUM_INLINE void Parser::closeTargets()
+{
+   if ( mpCommandParse && !mpCommandParse->finished() )
+      mpCommandParse->mpParser->closeTargets();
+
+   mParserDef.forEachActiveOption( []( Option& option ) {
+      option.closeTarget();
+   } );
+}
+
+// The space for the values of a vector option is reserved once for each run of
+// values.  The values in the run are counted by peeking into the argument
+// stream.
+ARGUMENTUM_INLINE void Parser::reserveValues( Option& option, ArgumentStream& argStream )
+{
+   if ( !option.hasVectorValue() || mpReservedOption == &option )
+      return;
+
+   mpReservedOption = &option;
+   option.reserveValues( countUpcomingValues( argStream ) );
+}
+
+// Count the current argument and the arguments that follow it and look like
+// option values.  The count is an estimate: it may include command names and
+// it stops at the first include.  In a contiguous stream the count stops at
+// the end of the window.
+ARGUMENTUM_INLINE size_t Parser::countUpcomingValues( ArgumentStream& argStream )
+{
+   size_t count = 1;
+   if ( mUpcoming ) {
+      for ( auto arg : *mUpcoming ) {
+         if ( !isValueLike( arg ) )
+            break;
+         ++count;
+      }
+      return count;
    }
+
+   argStream.peek( [&]( std::string_view arg ) {
+      if ( !isValueLike( arg ) )
+         return ArgumentStream::peekDone;
+      ++count;
+      return ArgumentStream::peekNext;
+   } );
+
+   return count;
+}
+
+ARGUMENTUM_INLINE bool Parser::isValueLike( std::string_view arg )
+{
+   if ( mIgnoreOptions )
+      return true;
+
+   if ( arg.substr( 0, 1 ) == "@" )
+      return false;
+
+   if ( arg.size() > 1 && arg[0] == '-' )
+      return detail::isNumberLike( arg.substr( 1 ) );
+
+   return true;
 }
 
 // A parser for command's (sub)options is instantiated only when a command is
 // selected by an input argument.
-ARGUMENTUM_INLINE void Parser::parseCommandArguments(
-      Command& command, ArgumentStream& argStream, ParseResultBuilder& result )
+ARGUMENTUM_INLINE void Parser::startCommand( Command& command )
 {
-   auto parser = argument_parser::createSubParser();
+   mpCommandParser = std::make_unique<argument_parser>( argument_parser::createSubParser() );
+   auto& parser = *mpCommandParser;
    auto commandpath = mParserDef.getConfig().program() + " " + command.getName();
    parser.config().program( commandpath ).description( command.getHelp() );
+   parser.config().allow_abbrev( mParserDef.getConfig().allow_abbrev() );
+   parser.config().env_prefix( mParserDef.getConfig().env_prefix() );
+   parser.config().max_suggestions( mParserDef.getConfig().max_suggestions() );
 
-   auto pcout = mParserDef.getConfig().output_stream();
-   assert( pcout );
-   parser.config().cout( *pcout );
+   parser.config().inherit_output( mParserDef.getConfig() );
 
    auto pCmdOptions = command.getOptions();
    if ( pCmdOptions ) {
       parser.params().add_parameters( pCmdOptions );
-      result.addCommand( pCmdOptions );
+      mResult.addCommand( pCmdOptions );
    }
-   result.addResult( parser.parse_args( argStream ) );
+   else
+      mResult.addError( MissingCommandOptions( command.getName() ).what(), INVALID_DEFINITION );
+   mpCommandParse = std::make_unique<incremental_parser>( parser.begin_parse() );
+
+   // The values of the command in the configuration files are in the section
+   // named after the command.
+   auto& commandParser = *mpCommandParse->mpParser;
+   commandParser.mConfigSection =
+         mConfigSection.empty() ? command.getName() : mConfigSection + "." + command.getName();
+   for ( auto& layer : mLayers )
+      if ( layer.pFile )
+         mpCommandParse->feed( *layer.pFile );
 }
 
-ARGUMENTUM_INLINE void Parser::parseSubstream( std::string_view streamName, unsigned depth )
+// After a command is selected, all the remaining arguments belong to the
+// command.  Returns true if the arguments were parsed by the command's parser.
+ARGUMENTUM_INLINE bool Parser::forwardToCommand( ArgumentStream& argStream )
 {
-   if ( !mParserDef.getConfig().filesystem() )
+   if ( !mpCommandParse )
+      return false;
+
+   mpCommandParse->feed( argStream );
+   return true;
+}
+
+// Returns false if the parse must be stopped.
+ARGUMENTUM_INLINE bool Parser::parseSubstream( std::string_view streamName, unsigned depth )
+{
+   if ( !mParserDef.getConfig().filesystem() ) {
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+      mResult.addError( MissingFilesystem().what(), INVALID_DEFINITION );
+      return false;
+#else
       throw MissingFilesystem();
+#endif
+   }
 
-   if ( depth > mParserDef.getConfig().max_include_depth() )
-      throw IncludeDepthExceeded( std::string{ streamName } );
+   if ( depth > mParserDef.getConfig().max_include_depth() ) {
+      mResult.addError( streamName, INCLUDE_TOO_DEEP );
+      return false;
+   }
 
    auto pFilesystem = mParserDef.getConfig().filesystem();
    assert( pFilesystem );
 
    auto pSubstream = pFilesystem->open( std::string{ streamName } );
    if ( pSubstream )
-      parse( *pSubstream, depth + 1 );
+      return parse( *pSubstream, depth + 1 );
+   return true;
 }
 
 }   // namespace argumentum
@@ -4,9 +4,9 @@
 #pragma once
 
 #include "filesystem.h"
+#include "outputsink.h"
 
 #include <memory>
-#include <ostream>
 #include <string>
 #include <string_view>
 
@@ -14,6 +14,16 @@ namespace argumentum {
 
 class IFormatHelp;
 
+// When the targets of the options are reset to their initial state before
+// they receive the values of a parse.
+enum class EValueReset {
+   // All the targets are reset when a parse starts.
+   eager,
+   // A target is reset when its option is first used in a parse.  The targets
+   // of the options that are not used in a parse keep their values.
+   onTouch
+};
+
 class ParserConfig
 {
 public:
@@ -27,9 +37,18 @@ public:
       std::string mDescription;
       std::string mEpilog;
       unsigned mMaxIncludeDepth = 8;
+#ifndef ARGUMENTUM_SLIM
       std::ostream* mpOutStream = nullptr;
+#endif
+      std::shared_ptr<IOutputSink> mpOutSink;
       std::shared_ptr<IFormatHelp> mpHelpFormatter;
       std::shared_ptr<Filesystem> mpFilesystem;
+      std::string mDefinitionCachePath;
+      std::string mDefinitionSchema;
+      bool mAllowAbbrev = false;
+      std::string mEnvPrefix;
+      unsigned mMaxSuggestions = 3;
+      EValueReset mValueReset = EValueReset::eager;
 
    public:
       const std::string& program() const;
@@ -37,9 +56,21 @@ public:
       const std::string& description() const;
       const std::string& epilog() const;
       unsigned max_include_depth() const;
+#ifndef ARGUMENTUM_SLIM
+      // The stream set with cout(), std::cout if neither a stream nor a sink
+      // was set or nullptr if a sink was set with output_sink().
       std::ostream* output_stream() const;
+#endif
+      // The sink that receives the help and the descriptions of the errors.
+      IOutputSink* output_sink() const;
       std::shared_ptr<IFormatHelp> help_formatter( const std::string& helpOption ) const;
       std::shared_ptr<Filesystem> filesystem() const;
+      const std::string& definition_cache_path() const;
+      const std::string& definition_schema() const;
+      bool allow_abbrev() const;
+      const std::string& env_prefix() const;
+      unsigned max_suggestions() const;
+      EValueReset value_reset() const;
    };
 
 private:
@@ -62,9 +93,19 @@ public:
    // Set the epolog to be shown at the end of the generated help.
    ParserConfig& epilog( std::string_view epilog );
 
+#ifndef ARGUMENTUM_SLIM
    // Set the stream to which the parser will write messages.
    // NOTE: The @p stream must outlive the parser.
    ParserConfig& cout( std::ostream& stream );
+#endif
+
+   // Set the sink to which the parser will write messages.  The default sink
+   // writes to std::cout or, in the slim build, to stdout.
+   ParserConfig& output_sink( std::shared_ptr<IOutputSink> pSink );
+
+   // Used internally to write the messages of a command's parser to the
+   // output of the parent parser.
+   ParserConfig& inherit_output( const Data& parent );
 
    // Set the filesystem implementation that will be used to open files with
    // additional parameters parameters.  If the filesystem is not set the parser
@@ -73,6 +114,42 @@ public:
 
    // Set the help formatter that will format and display help.
    ParserConfig& help_formatter( std::shared_ptr<IFormatHelp> pFormatter );
+
+   // Store the metadata of the defined parameters in the binary file @p path
+   // and restore it from the file on later runs.  The cache is rebuilt when
+   // @p schema changes, when the cache does not match the defined
+   // parameters or when a cached parameter is configured differently.  The
+   // schema should change whenever the definition of the parameters changes,
+   // eg. it can be a build id; a removed configuration call, eg. `required()`,
+   // is detected only through the schema.
+   //
+   // NOTE: The cache must be configured before the parameters are defined.
+   ParserConfig& definition_cache( std::string_view path, std::string_view schema );
+
+   // Accept unambiguous prefixes of long option names, eg. `--verb` for
+   // `--verbose`.  An exact match always has precedence.  The setting is
+   // inherited by the parsers of commands.
+   ParserConfig& allow_abbrev( bool allow = true );
+
+   // Read the values of the long options that are not present in the input
+   // arguments from environment variables named @p prefix followed by the
+   // option name in upper case with dashes replaced by underscores, eg.
+   // `TOOL_LOG_LEVEL` for `--log-level` with the prefix `TOOL_`.  The names
+   // set with OptionConfig::env() have precedence.  The help options are not
+   // bound.  The setting is inherited by the parsers of commands.
+   ParserConfig& env_prefix( std::string_view prefix );
+
+   // Report at most @p count names similar to an unknown option or command
+   // in ParseError::candidates.  The default is 3; 0 disables the
+   // suggestions.  The setting is inherited by the parsers of commands.
+   ParserConfig& max_suggestions( unsigned count );
+
+   // Set when the targets of the options are reset.  With
+   // EValueReset::onTouch a repeated parse visits only the options that are
+   // used in the parse instead of all the defined options.  The default is
+   // EValueReset::eager.  An option can override the setting with
+   // OptionConfig::value_reset().
+   ParserConfig& value_reset( EValueReset reset );
 };
 
 }   // namespace argumentum
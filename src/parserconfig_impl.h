@@ -6,7 +6,9 @@
 #include "helpformatter.h"
 #include "parserconfig.h"
 
-#include <ostream>
+#ifndef ARGUMENTUM_SLIM
+#include <iostream>
+#endif
 #include <string>
 #include <string_view>
 
@@ -41,9 +43,30 @@ ARGUMENTUM_INLINE ParserConfig& ParserConfig::epilog( std::string_view epilog )
    return *this;
 }
 
+#ifndef ARGUMENTUM_SLIM
 ARGUMENTUM_INLINE ParserConfig& ParserConfig::cout( std::ostream& stream )
 {
    mData.mpOutStream = &stream;
+   mData.mpOutSink = std::make_shared<StreamOutputSink>( stream );
+   return *this;
+}
+#endif
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::output_sink( std::shared_ptr<IOutputSink> pSink )
+{
+#ifndef ARGUMENTUM_SLIM
+   mData.mpOutStream = nullptr;
+#endif
+   mData.mpOutSink = std::move( pSink );
+   return *this;
+}
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::inherit_output( const Data& parent )
+{
+#ifndef ARGUMENTUM_SLIM
+   mData.mpOutStream = parent.mpOutStream;
+#endif
+   mData.mpOutSink = parent.mpOutSink;
    return *this;
 }
 
@@ -60,6 +83,38 @@ ARGUMENTUM_INLINE ParserConfig& ParserConfig::help_formatter(
    return *this;
 }
 
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::definition_cache(
+      std::string_view path, std::string_view schema )
+{
+   mData.mDefinitionCachePath = path;
+   mData.mDefinitionSchema = schema;
+   return *this;
+}
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::allow_abbrev( bool allow )
+{
+   mData.mAllowAbbrev = allow;
+   return *this;
+}
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::env_prefix( std::string_view prefix )
+{
+   mData.mEnvPrefix = prefix;
+   return *this;
+}
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::max_suggestions( unsigned count )
+{
+   mData.mMaxSuggestions = count;
+   return *this;
+}
+
+ARGUMENTUM_INLINE ParserConfig& ParserConfig::value_reset( EValueReset reset )
+{
+   mData.mValueReset = reset;
+   return *this;
+}
+
 ARGUMENTUM_INLINE const std::string& ParserConfig::Data::program() const
 {
    return mProgram;
@@ -85,9 +140,26 @@ ARGUMENTUM_INLINE unsigned ParserConfig::Data::max_include_depth() const
    return mMaxIncludeDepth;
 }
 
+#ifndef ARGUMENTUM_SLIM
 ARGUMENTUM_INLINE std::ostream* ParserConfig::Data::output_stream() const
 {
-   return mpOutStream ? mpOutStream : &std::cout;
+   if ( mpOutStream )
+      return mpOutStream;
+   return mpOutSink ? nullptr : &std::cout;
+}
+#endif
+
+ARGUMENTUM_INLINE IOutputSink* ParserConfig::Data::output_sink() const
+{
+   if ( mpOutSink )
+      return mpOutSink.get();
+
+#ifdef ARGUMENTUM_SLIM
+   static FileOutputSink defaultSink( stdout );
+#else
+   static StreamOutputSink defaultSink( std::cout );
+#endif
+   return &defaultSink;
 }
 
 ARGUMENTUM_INLINE std::shared_ptr<IFormatHelp> ParserConfig::Data::help_formatter(
@@ -101,4 +173,34 @@ ARGUMENTUM_INLINE std::shared_ptr<Filesystem> ParserConfig::Data::filesystem() c
    return mpFilesystem ? mpFilesystem : std::make_shared<DefaultFilesystem>();
 }
 
+ARGUMENTUM_INLINE const std::string& ParserConfig::Data::definition_cache_path() const
+{
+   return mDefinitionCachePath;
+}
+
+ARGUMENTUM_INLINE const std::string& ParserConfig::Data::definition_schema() const
+{
+   return mDefinitionSchema;
+}
+
+ARGUMENTUM_INLINE bool ParserConfig::Data::allow_abbrev() const
+{
+   return mAllowAbbrev;
+}
+
+ARGUMENTUM_INLINE const std::string& ParserConfig::Data::env_prefix() const
+{
+   return mEnvPrefix;
+}
+
+ARGUMENTUM_INLINE unsigned ParserConfig::Data::max_suggestions() const
+{
+   return mMaxSuggestions;
+}
+
+ARGUMENTUM_INLINE EValueReset ParserConfig::Data::value_reset() const
+{
+   return mValueReset;
+}
+
 }   // namespace argumentum
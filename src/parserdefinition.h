@@ -3,10 +3,18 @@
 
 #pragma once
 
+#include "memoryusage.h"
+#include "namesuggester.h"
+#include "nametrie.h"
+#include "option.h"
+#include "optionvalidator.h"
 #include "parserconfig.h"
 
+#include <cstdint>
+#include <deque>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -16,6 +24,8 @@ namespace argumentum {
 class Option;
 class OptionGroup;
 class Command;
+class DefinitionCache;
+class StringPool;
 
 class ParserDefinition
 {
@@ -27,6 +37,64 @@ private:
    // set explicitly with OptionConfig::group().
    std::shared_ptr<OptionGroup> mpActiveGroup;
 
+   // The cache is loaded when it is first needed.
+   std::shared_ptr<DefinitionCache> mpDefinitionCache;
+
+   // The index of the long option names without the leading dashes.  It is
+   // used to resolve abbreviations and the keys of configuration files.  It
+   // is built when the definitions are complete.
+   NameTrie mLongNameIndex;
+   std::vector<Option*> mLongNameOptions;
+
+   // The options and the commands by the hashes of their names.  The names
+   // are compared when an entry is found so the index does not refer to the
+   // strings of the options.  The options are indexed again when they are
+   // renamed.
+   mutable std::unordered_multimap<size_t, Option*> mOptionNameIndex;
+   std::unordered_multimap<size_t, Command*> mCommandNameIndex;
+
+   // The options that read their values from environment variables.
+   std::unordered_map<std::string, Option*> mEnvironmentIndex;
+
+   // The names of the options and the commands for the suggestions for
+   // misspelled names.  They are built when the first suggestion is needed
+   // and rebuilt when options or commands are added.
+   mutable NameSuggester mOptionSuggester;
+   mutable NameSuggester mCommandSuggester;
+   mutable size_t mSuggestedOptionCount = 0;
+   mutable size_t mSuggestedCommandCount = 0;
+
+   // The options and the positional parameters are stored in the order of
+   // their definition so that the records read by the parser are dense in
+   // memory.  The index in the store is the id of the option.  The pointers in
+   // mOptions and mPositional share the ownership of the store.
+   std::shared_ptr<std::deque<Option>> mpOptionStore;
+
+   // The pool of the descriptive texts of the options.
+   std::shared_ptr<StringPool> mpStringPool;
+
+   // The errors in the definitions of the parameters that were not thrown
+   // because the exceptions are disabled.
+   std::vector<std::string> mDefinitionErrors;
+
+   // The assignments recorded by the parser that reads the definition and the
+   // masks that validate them.
+   mutable OptionValidator mValidator;
+
+   // The parses of this parser.  It is shared by the stored options.
+   std::shared_ptr<DefinitionState> mpState;
+
+   // The options whose targets are reset when a parse starts and the options
+   // with default values, in the order of definition.
+   std::vector<Option*> mEagerOptions;
+   std::vector<Option*> mDefaultOptions;
+
+   // The configuration of the parser when the indices were last built.  The
+   // indices are rebuilt when it changes or when the options are added or
+   // configured.
+   std::string mFinalizedEnvPrefix;
+   EValueReset mFinalizedValueReset = EValueReset::eager;
+
 public:
    ParserConfig mConfig;
    std::vector<std::shared_ptr<Command>> mCommands;
@@ -38,6 +106,22 @@ public:
 public:
    Option* findOption( std::string_view optionName ) const;
    Command* findCommand( std::string_view commandName ) const;
+
+   /**
+    * Add the option @p pOption and index its names.  The names must not be
+    * used by other options.
+    */
+   void addOption( const std::shared_ptr<Option>& pOption );
+
+   /**
+    * Add the command @p pCommand and index its name.
+    */
+   void addCommand( const std::shared_ptr<Command>& pCommand );
+
+   /**
+    * Reserve the space for @p count more options.
+    */
+   void reserveOptions( size_t count );
    std::shared_ptr<OptionGroup> findGroup( std::string name ) const;
 
    /**
@@ -49,6 +133,147 @@ public:
     * @Returns true if there are short options that include digits.
     */
    bool hasNumericOptions() const;
+
+   /**
+    * Get the definition cache configured in the parser configuration.
+    *
+    * @Returns nullptr if the parser does not use a definition cache.
+    */
+   DefinitionCache* getDefinitionCache();
+
+   /**
+    * Build the index of long option names.
+    */
+   void buildLongNameIndex();
+
+   /**
+    * Give the options dense indices for the validation of the parse.
+    */
+   void buildValidator();
+
+   /**
+    * Find the options that are reset when a parse starts and the options
+    * with default values.
+    */
+   void buildResetIndex();
+
+   /**
+    * @Returns true if the indices were built after the last change of the
+    * definitions.
+    */
+   bool isFinalized() const;
+   void markFinalized();
+
+   /**
+    * Start a new parse.  The options that are reset eagerly are reset now and
+    * the others when they are first used.
+    */
+   void startParse();
+
+   /**
+    * Call @p fn for every option that could receive a value in the current
+    * parse: the options that are reset eagerly and the options that are
+    * reset on touch and were used.
+    */
+   template<typename TFunction>
+   void forEachActiveOption( TFunction&& fn ) const
+   {
+      for ( auto pOption : mEagerOptions )
+         fn( *pOption );
+      if ( mpState ) {
+         // The touched list may grow while it is visited.
+         auto& touched = mpState->touched;
+         for ( size_t i = 0; i < touched.size(); ++i )
+            fn( *touched[i] );
+      }
+   }
+
+   const std::vector<Option*>& getDefaultOptions() const;
+
+   /**
+    * Get the validator that records the assignments of the options.
+    */
+   OptionValidator& getValidator() const;
+
+   /**
+    * Find the option with the long name @p name without the leading dashes.
+    * The lookup time depends only on the length of the name.
+    */
+   Option* findLongOption( std::string_view name ) const;
+
+   /**
+    * Find the option whose long name is @p prefix or the only option whose
+    * long name starts with @p prefix.  The lookup time depends only on the
+    * length of the prefix.
+    *
+    * @Returns nullptr if no option or more than one option matches.  In the
+    * latter case the names of the matching options are stored in
+    * @p candidates.
+    */
+   Option* findAbbreviatedOption(
+         std::string_view prefix, std::vector<std::string>& candidates ) const;
+
+   /**
+    * Build the index of the environment variables that provide the values of
+    * the options.
+    */
+   void buildEnvironmentIndex();
+
+   /**
+    * @Returns true if any option reads its value from the environment.
+    */
+   bool hasEnvironmentOptions() const;
+
+   /**
+    * Find the option that reads its value from the environment variable
+    * @p name.
+    */
+   Option* findEnvironmentOption( const std::string& name ) const;
+
+   /**
+    * Find the names of the options that are similar to the unknown option
+    * @p name.  At most ParserConfig::max_suggestions() names are returned,
+    * the most similar first.
+    */
+   std::vector<std::string> suggestOptions( std::string_view name ) const;
+
+   /**
+    * Find the names of the commands that are similar to the unknown command
+    * @p name.
+    */
+   std::vector<std::string> suggestCommands( std::string_view name ) const;
+
+   /**
+    * Store an error in the definition of the parameters.
+    */
+   void addDefinitionError( std::string_view message );
+
+   /**
+    * Get the errors in the definitions of the parameters and the options.
+    */
+   std::vector<std::string> getDefinitionErrors() const;
+
+   /**
+    * Move @p option to the option store.
+    *
+    * @Returns the pointer to the stored option.
+    */
+   std::shared_ptr<Option> storeOption( Option&& option );
+
+   /**
+    * Get the pool in which the options of this parser store their
+    * descriptive texts.
+    */
+   const std::shared_ptr<StringPool>& getStringPool();
+
+   /**
+    * Measure the memory used by the definitions of the options.
+    */
+   ParserMemoryUsage getMemoryUsage() const;
+
+private:
+   void indexOptionNames( Option& option ) const;
+   void reindexOptionNames() const;
 };
 
 }   // namespace argumentum
@@ -4,28 +4,84 @@
 #pragma once
 
 #include "command.h"
+#include "definitioncache.h"
 #include "option.h"
+#include "stringpool.h"
 
+#include <algorithm>
+#include <cctype>
+#include <functional>
 #include <string_view>
 
 namespace argumentum {
 
-ARGUMENTUM_INLINE Option* ParserDefinition::findOption( std::string_view optionName ) const
+namespace detail {
+template<typename TIndex>
+auto findInNameIndex( const TIndex& index, std::string_view name )
+      -> typename TIndex::mapped_type
 {
-   for ( auto& pOption : mOptions )
-      if ( pOption->hasName( optionName ) )
-         return pOption.get();
+   auto [first, last] = index.equal_range( std::hash<std::string_view>{}( name ) );
+   for ( auto it = first; it != last; ++it )
+      if ( it->second->hasName( name ) )
+         return it->second;
 
    return nullptr;
 }
+}   // namespace detail
+
+ARGUMENTUM_INLINE Option* ParserDefinition::findOption( std::string_view optionName ) const
+{
+   if ( mpState && mpState->areNamesChanged )
+      reindexOptionNames();
+   return detail::findInNameIndex( mOptionNameIndex, optionName );
+}
 
 ARGUMENTUM_INLINE Command* ParserDefinition::findCommand( std::string_view commandName ) const
 {
-   for ( auto& pCommand : mCommands )
-      if ( pCommand->hasName( commandName ) )
-         return pCommand.get();
+   return detail::findInNameIndex( mCommandNameIndex, commandName );
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::addOption( const std::shared_ptr<Option>& pOption )
+{
+   if ( mpState && mpState->areNamesChanged )
+      reindexOptionNames();
+   mOptions.push_back( pOption );
+   indexOptionNames( *pOption );
+}
 
-   return nullptr;
+ARGUMENTUM_INLINE void ParserDefinition::indexOptionNames( Option& option ) const
+{
+   auto hash = std::hash<std::string_view>{};
+   if ( !option.getShortName().empty() )
+      mOptionNameIndex.emplace( hash( option.getShortName() ), &option );
+   if ( !option.getLongName().empty() )
+      mOptionNameIndex.emplace( hash( option.getLongName() ), &option );
+}
+
+// An option was renamed after it was added.  The indices that depend on the
+// names are rebuilt.
+ARGUMENTUM_INLINE void ParserDefinition::reindexOptionNames() const
+{
+   mpState->areNamesChanged = false;
+   mOptionNameIndex.clear();
+   for ( auto& pOption : mOptions )
+      indexOptionNames( *pOption );
+   mOptionSuggester.clear();
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::addCommand( const std::shared_ptr<Command>& pCommand )
+{
+   mCommands.push_back( pCommand );
+   if ( mpState )
+      mpState->isChanged = true;
+   mCommandNameIndex.emplace(
+         std::hash<std::string_view>{}( pCommand->getName() ), pCommand.get() );
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::reserveOptions( size_t count )
+{
+   mOptions.reserve( mOptions.size() + count );
+   mOptionNameIndex.reserve( mOptionNameIndex.size() + 2 * count );
 }
 
 ARGUMENTUM_INLINE std::shared_ptr<OptionGroup> ParserDefinition::findGroup( std::string name ) const
@@ -53,4 +109,274 @@ ARGUMENTUM_INLINE bool ParserDefinition::hasNumericOptions() const
    return false;
 }
 
+ARGUMENTUM_INLINE DefinitionCache* ParserDefinition::getDefinitionCache()
+{
+   auto& config = getConfig();
+   if ( config.definition_cache_path().empty() )
+      return nullptr;
+
+   if ( !mpDefinitionCache )
+      mpDefinitionCache =
+            DefinitionCache::load( config.definition_cache_path(), config.definition_schema() );
+
+   return mpDefinitionCache.get();
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::buildLongNameIndex()
+{
+   mLongNameIndex.clear();
+   mLongNameOptions.clear();
+   for ( auto& pOption : mOptions ) {
+      auto name = std::string_view( pOption->getLongName() );
+      if ( name.size() <= 2 || name.substr( 0, 2 ) != "--" )
+         continue;
+      if ( mLongNameIndex.insert( name.substr( 2 ), int( mLongNameOptions.size() ) ) )
+         mLongNameOptions.push_back( pOption.get() );
+   }
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::buildValidator()
+{
+   mValidator.build( mOptions, mPositional );
+}
+
+ARGUMENTUM_INLINE OptionValidator& ParserDefinition::getValidator() const
+{
+   return mValidator;
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::buildResetIndex()
+{
+   mEagerOptions.clear();
+   mDefaultOptions.clear();
+   auto defaultReset = getConfig().value_reset();
+   auto addOption = [&]( Option& option ) {
+      auto reset = option.getValueReset().value_or( defaultReset );
+      option.setResetsOnTouch( reset == EValueReset::onTouch );
+      if ( reset == EValueReset::eager )
+         mEagerOptions.push_back( &option );
+      if ( option.hasDefault() )
+         mDefaultOptions.push_back( &option );
+   };
+
+   for ( auto& pOption : mOptions )
+      addOption( *pOption );
+   for ( auto& pOption : mPositional )
+      addOption( *pOption );
+}
+
+ARGUMENTUM_INLINE bool ParserDefinition::isFinalized() const
+{
+   auto& config = getConfig();
+   return mpState && !mpState->isChanged && mFinalizedEnvPrefix == config.env_prefix()
+         && mFinalizedValueReset == config.value_reset();
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::markFinalized()
+{
+   auto& config = getConfig();
+   if ( mpState )
+      mpState->isChanged = false;
+   mFinalizedEnvPrefix = config.env_prefix();
+   mFinalizedValueReset = config.value_reset();
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::startParse()
+{
+   if ( mpState ) {
+      ++mpState->parseNumber;
+      mpState->touched.clear();
+   }
+
+   for ( auto pOption : mEagerOptions )
+      pOption->resetValue();
+
+   mValidator.resetAssignments();
+}
+
+ARGUMENTUM_INLINE const std::vector<Option*>& ParserDefinition::getDefaultOptions() const
+{
+   return mDefaultOptions;
+}
+
+ARGUMENTUM_INLINE Option* ParserDefinition::findLongOption( std::string_view name ) const
+{
+   auto index = mLongNameIndex.find( name );
+   return index < 0 ? nullptr : mLongNameOptions[index];
+}
+
+ARGUMENTUM_INLINE Option* ParserDefinition::findAbbreviatedOption(
+      std::string_view prefix, std::vector<std::string>& candidates ) const
+{
+   if ( prefix.size() < 3 || prefix.substr( 0, 2 ) != "--" )
+      return nullptr;
+
+   prefix.remove_prefix( 2 );
+   auto exact = mLongNameIndex.find( prefix );
+   if ( exact >= 0 )
+      return mLongNameOptions[exact];
+
+   // Two matches are enough to detect an ambiguity.  All the matches are
+   // collected only for the error message.
+   auto matches = mLongNameIndex.findPrefixed( prefix, 2 );
+   if ( matches.size() == 1 )
+      return mLongNameOptions[matches[0]];
+
+   if ( matches.size() > 1 ) {
+      for ( auto index : mLongNameIndex.findPrefixed( prefix ) )
+         candidates.push_back( mLongNameOptions[index]->getLongName() );
+   }
+
+   return nullptr;
+}
+
+// The names set with OptionConfig::env() are indexed first so that they have
+// precedence over the names derived from the prefix.  The options without
+// targets, like the help options, only run actions and are not bound through
+// the prefix.
+ARGUMENTUM_INLINE void ParserDefinition::buildEnvironmentIndex()
+{
+   mEnvironmentIndex.clear();
+   for ( auto& pOption : mOptions ) {
+      auto& name = pOption->getEnvName();
+      if ( !name.empty() )
+         mEnvironmentIndex.emplace( name, pOption.get() );
+   }
+
+   auto& prefix = getConfig().env_prefix();
+   if ( prefix.empty() )
+      return;
+
+   for ( auto& pOption : mOptions ) {
+      auto& longName = pOption->getLongName();
+      if ( !pOption->getEnvName().empty() || longName.size() <= 2 || !pOption->hasTarget() )
+         continue;
+
+      auto name = prefix;
+      for ( auto ch : std::string_view( longName ).substr( 2 ) )
+         name += ch == '-' ? '_' : char( std::toupper( static_cast<unsigned char>( ch ) ) );
+      mEnvironmentIndex.emplace( name, pOption.get() );
+   }
+}
+
+ARGUMENTUM_INLINE bool ParserDefinition::hasEnvironmentOptions() const
+{
+   return !mEnvironmentIndex.empty();
+}
+
+ARGUMENTUM_INLINE Option* ParserDefinition::findEnvironmentOption( const std::string& name ) const
+{
+   auto it = mEnvironmentIndex.find( name );
+   return it == mEnvironmentIndex.end() ? nullptr : it->second;
+}
+
+namespace detail {
+// The suggestions are limited to the names that differ from @p name in
+// about a third of its characters, ignoring the leading dashes.  A swap of
+// two characters has the distance 2.
+ARGUMENTUM_INLINE size_t getSuggestionDistance( std::string_view name )
+{
+   auto start = name.find_first_not_of( '-' );
+   auto length = start == std::string_view::npos ? 0 : name.size() - start;
+   return length < 3 ? 0 : std::min<size_t>( ( length + 1 ) / 3, 3 );
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE std::vector<std::string> ParserDefinition::suggestOptions(
+      std::string_view name ) const
+{
+   auto maxDistance = detail::getSuggestionDistance( name );
+   if ( maxDistance == 0 || getConfig().max_suggestions() == 0 )
+      return {};
+
+   if ( mSuggestedOptionCount != mOptions.size() || mOptionSuggester.empty() ) {
+      mOptionSuggester.clear();
+      for ( auto& pOption : mOptions ) {
+         for ( auto& optionName : { pOption->getShortName(), pOption->getLongName() } )
+            if ( !optionName.empty() )
+               mOptionSuggester.insert( optionName );
+      }
+      mSuggestedOptionCount = mOptions.size();
+   }
+
+   return mOptionSuggester.suggest( name, maxDistance, getConfig().max_suggestions() );
+}
+
+ARGUMENTUM_INLINE std::vector<std::string> ParserDefinition::suggestCommands(
+      std::string_view name ) const
+{
+   auto maxDistance = detail::getSuggestionDistance( name );
+   if ( maxDistance == 0 || getConfig().max_suggestions() == 0 || mCommands.empty() )
+      return {};
+
+   if ( mSuggestedCommandCount != mCommands.size() ) {
+      mCommandSuggester.clear();
+      for ( auto& pCommand : mCommands )
+         mCommandSuggester.insert( pCommand->getName() );
+      mSuggestedCommandCount = mCommands.size();
+   }
+
+   return mCommandSuggester.suggest( name, maxDistance, getConfig().max_suggestions() );
+}
+
+ARGUMENTUM_INLINE void ParserDefinition::addDefinitionError( std::string_view message )
+{
+   mDefinitionErrors.emplace_back( message );
+}
+
+ARGUMENTUM_INLINE std::vector<std::string> ParserDefinition::getDefinitionErrors() const
+{
+   auto errors = mDefinitionErrors;
+   auto addOptionErrors = [&]( auto& options ) {
+      for ( auto& pOption : options )
+         for ( auto& error : pOption->getDefinitionErrors() )
+            errors.push_back( pOption->getName() + ": " + error );
+   };
+
+   addOptionErrors( mOptions );
+   addOptionErrors( mPositional );
+   return errors;
+}
+
+ARGUMENTUM_INLINE std::shared_ptr<Option> ParserDefinition::storeOption( Option&& option )
+{
+   if ( !mpOptionStore )
+      mpOptionStore = std::make_shared<std::deque<Option>>();
+
+   if ( !mpState )
+      mpState = std::make_shared<DefinitionState>();
+
+   mpOptionStore->push_back( std::move( option ) );
+   mpOptionStore->back().setDefinitionState( mpState );
+   mpState->isChanged = true;
+   return std::shared_ptr<Option>( mpOptionStore, &mpOptionStore->back() );
+}
+
+ARGUMENTUM_INLINE const std::shared_ptr<StringPool>& ParserDefinition::getStringPool()
+{
+   if ( !mpStringPool )
+      mpStringPool = std::make_shared<StringPool>();
+   return mpStringPool;
+}
+
+ARGUMENTUM_INLINE ParserMemoryUsage ParserDefinition::getMemoryUsage() const
+{
+   ParserMemoryUsage usage;
+   if ( mpOptionStore ) {
+      for ( auto& option : *mpOptionStore )
+         usage.options += option.getMemoryUsage();
+      usage.optionCount = mpOptionStore->size();
+   }
+
+   usage.options.heapBytes += ( mOptions.capacity() + mPositional.capacity() )
+         * sizeof( std::shared_ptr<Option> );
+   // The nodes of the name index hold a key, a value and a link.
+   usage.options.heapBytes += mOptionNameIndex.bucket_count() * sizeof( void* )
+         + mOptionNameIndex.size()
+               * ( sizeof( size_t ) + sizeof( Option* ) + sizeof( void* ) );
+   if ( mpStringPool )
+      usage.stringPoolBytes = mpStringPool->allocatedBytes();
+   return usage;
+}
+
 }   // namespace argumentum
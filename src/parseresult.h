@@ -4,6 +4,7 @@
 #pragma once
 
 #include "command.h"
+#include "outputsink.h"
 
 #include <string>
 #include <string_view>
@@ -36,29 +37,81 @@ enum EError {
    // The parser received invalid argv input.
    INVALID_ARGV,
    // The argument stream include depth was exceeded.
-   INCLUDE_TOO_DEEP
+   INCLUDE_TOO_DEEP,
+   // An abbreviated option matches more than one option.
+   AMBIGUOUS_OPTION,
+   // A line in a configuration file could not be parsed.
+   INVALID_CONFIG,
+   // A free argument is not a command but it is similar to a command name.
+   UNKNOWN_COMMAND,
+   // The parameters were not defined correctly.  Reported only when the
+   // exceptions are disabled.
+   INVALID_DEFINITION
 };
 
 struct ParseError
 {
    const std::string option;
    const int errorCode;
+   // The options that match an ambiguous abbreviation or the names that are
+   // similar to an unknown option or command.
+   const std::vector<std::string> candidates;
+   // The location of the value that caused the error if it was not an input
+   // argument, eg. 'file:line' for a value from a configuration file.
+   const std::string source;
    ParseError( std::string_view optionName, int code );
+   ParseError( std::string_view optionName, int code, std::vector<std::string> candidates,
+         std::string_view source = {} );
    ParseError( const ParseError& ) = default;
    ParseError( ParseError&& ) = default;
    ParseError& operator=( const ParseError& ) = default;
    ParseError& operator=( ParseError&& ) = default;
 
+   void describeError( IOutputSink& sink ) const;
+#ifndef ARGUMENTUM_SLIM
    void describeError( std::ostream& stream ) const;
+#endif
+
+private:
+   std::string formatError() const;
+   std::string formatSuggestions() const;
 };
 
+// The source of the values of an option.
+enum class EValueSource {
+   // The input arguments.
+   arguments,
+   // An environment variable.
+   environment,
+   // A configuration file.
+   config,
+   // The default value of the option.
+   defaultValue
+};
+
+struct ValueSource
+{
+   // The long name of the option or its short name if it has no long name.
+   std::string option;
+   EValueSource source;
+   // The name of the environment variable or the path of the configuration
+   // file.
+   std::string location;
+   // The number of values assigned from the source.  It is 0 for defaults.
+   unsigned count = 0;
+};
+
+class parse_task;
+
 class ParseResult
 {
    friend class ParseResultBuilder;
+   friend class parse_task;
 
 private:
    // The parse result must be checked. If it is not, the destructor will throw
-   // if no exception is currently being handled.
+   // if no exception is currently being handled.  Without exceptions it only
+   // writes a warning.
    struct RequireCheck
    {
       bool required = false;
@@ -83,6 +136,10 @@ public:
    std::vector<std::string> ignoredArguments;
    std::vector<ParseError> errors;
    std::vector<std::shared_ptr<CommandOptions>> commands;
+   // The sources that supplied the values of the options.  An option that
+   // appends the values of multiple sources has an entry for each source in
+   // the order of assignment.
+   std::vector<ValueSource> valueSources;
 
 public:
    ParseResult() = default;
@@ -97,6 +154,10 @@ public:
 
    std::shared_ptr<CommandOptions> findCommand( std::string_view name );
 
+   // The sources of the values of the option @p optionName.  The result is
+   // empty if the option was not assigned.
+   std::vector<ValueSource> value_sources( std::string_view optionName ) const;
+
 private:
    void clear();
 };
@@ -109,8 +170,10 @@ public:
    void clear();
    bool wasExitRequested() const;
    void addError( std::string_view optionName, int error );
+   void addError( ParseError&& error );
    void addIgnored( std::string_view arg );
    void addCommand( const std::shared_ptr<CommandOptions>& pCommand );
+   void addValueSource( ValueSource&& source );
    void requestExit();
    void signalHelpShown();
    void signalErrorsShown();
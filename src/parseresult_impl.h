@@ -14,46 +14,102 @@ ARGUMENTUM_INLINE ParseError::ParseError( std::string_view optionName, int code
    , errorCode( code )
 {}
 
+ARGUMENTUM_INLINE ParseError::ParseError( std::string_view optionName, int code,
+      std::vector<std::string> candidates_, std::string_view source_ )
+   : option( optionName )
+   , errorCode( code )
+   , candidates( std::move( candidates_ ) )
+   , source( source_ )
+{}
+
+ARGUMENTUM_INLINE void ParseError::describeError( IOutputSink& sink ) const
+{
+   sink.write( formatError() );
+}
+
+#ifndef ARGUMENTUM_SLIM
 ARGUMENTUM_INLINE void ParseError::describeError( std::ostream& stream ) const
 {
+   stream << formatError();
+}
+#endif
+
+ARGUMENTUM_INLINE std::string ParseError::formatError() const
+{
+   std::string text;
+   if ( !source.empty() )
+      text += source + ": ";
+
    switch ( errorCode ) {
       case UNKNOWN_OPTION:
-         stream << "Error: Unknown option: '" << option << "'\n";
+         text += "Error: Unknown option: '" + option + "'";
+         text += formatSuggestions();
          break;
       case EXCLUSIVE_OPTION:
-         stream << "Error: Only one option from an exclusive group can be set. '" << option
-                << "'\n";
+         text += "Error: Only one option from an exclusive group can be set. '" + option + "'\n";
          break;
       case MISSING_OPTION:
-         stream << "Error: A required option is missing: '" << option << "'\n";
+         text += "Error: A required option is missing: '" + option + "'\n";
          break;
       case MISSING_OPTION_GROUP:
-         stream << "Error: A required option from a group is missing: '" << option << "'\n";
+         text += "Error: A required option from a group is missing: '" + option + "'\n";
          break;
       case MISSING_ARGUMENT:
-         stream << "Error: An argument is missing: '" << option << "'\n";
+         text += "Error: An argument is missing: '" + option + "'\n";
          break;
       case CONVERSION_ERROR:
-         stream << "Error: The argument could not be converted: '" << option << "'\n";
+         text += "Error: The argument could not be converted: '" + option + "'\n";
          break;
       case INVALID_CHOICE:
-         stream << "Error: The value is not in the list of valid values: '" << option << "'\n";
+         text += "Error: The value is not in the list of valid values: '" + option + "'\n";
          break;
       case FLAG_PARAMETER:
-         stream << "Error: Flag options do not accep parameters: '" << option << "'\n";
+         text += "Error: Flag options do not accep parameters: '" + option + "'\n";
          break;
       case EXIT_REQUESTED:
          break;
       case ACTION_ERROR:
-         stream << "Error: " << option << "\n";
+         text += "Error: " + option + "\n";
          break;
       case INVALID_ARGV:
-         stream << "Error: Parser input is invalid.\n";
+         text += "Error: Parser input is invalid.\n";
          break;
       case INCLUDE_TOO_DEEP:
-         stream << "Include depth exceeded: '" << option << "'\n";
+         text += "Include depth exceeded: '" + option + "'\n";
+         break;
+      case AMBIGUOUS_OPTION:
+         text += "Error: Ambiguous option: '" + option + "' could match";
+         for ( size_t i = 0; i < candidates.size(); ++i )
+            text += ( i == 0 ? " " : ", " ) + candidates[i];
+         text += "\n";
+         break;
+      case INVALID_CONFIG:
+         text += "Error: Invalid configuration line: '" + option + "'\n";
+         break;
+      case UNKNOWN_COMMAND:
+         text += "Error: Unknown command: '" + option + "'";
+         text += formatSuggestions();
+         break;
+      case INVALID_DEFINITION:
+         text += "Error: Invalid parameter definition: " + option + "\n";
          break;
    }
+   return text;
+}
+
+ARGUMENTUM_INLINE std::string ParseError::formatSuggestions() const
+{
+   std::string text;
+   if ( !candidates.empty() ) {
+      text += ". Did you mean";
+      for ( size_t i = 0; i < candidates.size(); ++i ) {
+         text += i == 0 ? " " : ( i + 1 == candidates.size() ? " or " : ", " );
+         text += "'" + candidates[i] + "'";
+      }
+      text += "?";
+   }
+   text += "\n";
+   return text;
 }
 
 ARGUMENTUM_INLINE ParseResult::RequireCheck::RequireCheck( RequireCheck&& other )
@@ -76,10 +132,14 @@ ARGUMENTUM_INLINE ParseResult::RequireCheck::RequireCheck( bool require )
 ARGUMENTUM_INLINE ParseResult::RequireCheck::~RequireCheck() noexcept( false )
 {
    if ( required ) {
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+      Notifier::warn( "Unchecked Parse Result." );
+#else
       if ( !std::current_exception() )
          throw UncheckedParseResult();   // lgtm [cpp/throw-in-destructor]
       else
          Notifier::warn( "Unchecked Parse Result." );
+#endif
    }
 }
 
@@ -121,6 +181,7 @@ ARGUMENTUM_INLINE void ParseResult::clear()
 {
    ignoredArguments.clear();
    errors.clear();
+   valueSources.clear();
    mustCheck.clear();
    exitRequested = false;
 }
@@ -134,6 +195,16 @@ ARGUMENTUM_INLINE std::shared_ptr<CommandOptions> ParseResult::findCommand( std:
    return nullptr;
 }
 
+ARGUMENTUM_INLINE std::vector<ValueSource> ParseResult::value_sources(
+      std::string_view optionName ) const
+{
+   std::vector<ValueSource> sources;
+   for ( auto& source : valueSources )
+      if ( source.option == optionName )
+         sources.push_back( source );
+   return sources;
+}
+
 ARGUMENTUM_INLINE void ParseResultBuilder::clear()
 {
    mResult.clear();
@@ -150,6 +221,12 @@ ARGUMENTUM_INLINE void ParseResultBuilder::addError( std::string_view optionName
    mResult.mustCheck.activate();
 }
 
+ARGUMENTUM_INLINE void ParseResultBuilder::addError( ParseError&& error )
+{
+   mResult.errors.push_back( std::move( error ) );
+   mResult.mustCheck.activate();
+}
+
 ARGUMENTUM_INLINE void ParseResultBuilder::addIgnored( std::string_view arg )
 {
    mResult.ignoredArguments.emplace_back( arg );
@@ -161,6 +238,11 @@ ARGUMENTUM_INLINE void ParseResultBuilder::addCommand(
    mResult.commands.push_back( pCommand );
 }
 
+ARGUMENTUM_INLINE void ParseResultBuilder::addValueSource( ValueSource&& source )
+{
+   mResult.valueSources.push_back( std::move( source ) );
+}
+
 ARGUMENTUM_INLINE void ParseResultBuilder::requestExit()
 {
    mResult.exitRequested = true;
@@ -201,6 +283,9 @@ ARGUMENTUM_INLINE void ParseResultBuilder::addResult( ParseResult&& result )
 
    for ( auto&& arg : result.ignoredArguments )
       mResult.ignoredArguments.push_back( std::move( arg ) );
+
+   for ( auto&& source : result.valueSources )
+      mResult.valueSources.push_back( std::move( source ) );
 }
 
 }   // namespace argumentum
@@ -0,0 +1,167 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+namespace argumentum {
+
+// A target that passes each converted value to a callback as soon as the value
+// is parsed.  The values are not stored in the sink.
+//
+// Sink targets behave like vector targets: they accept one or more values by
+// default and the argument counts can be changed with nargs, minargs and
+// maxargs.
+template<typename T>
+class value_sink
+{
+public:
+   using value_type = T;
+   using consume_t = std::function<void( T&& value )>;
+   using close_t = std::function<void()>;
+
+private:
+   consume_t mConsume;
+   close_t mClose;
+   size_t mCount = 0;
+   bool mIsClosed = false;
+
+public:
+   // The function @p consume is called for every value.  The function @p
+   // onClose is called once when the parser has processed all input
+   // arguments or when the parse is abandoned.
+   value_sink( consume_t consume, close_t onClose = {} )
+      : mConsume( std::move( consume ) )
+      , mClose( std::move( onClose ) )
+   {}
+
+   void push( T&& value )
+   {
+      ++mCount;
+      if ( mConsume )
+         mConsume( std::move( value ) );
+   }
+
+   void close()
+   {
+      if ( mIsClosed )
+         return;
+      mIsClosed = true;
+      if ( mClose )
+         mClose();
+   }
+
+   // The number of values pushed since the last reset.
+   size_t count() const
+   {
+      return mCount;
+   }
+
+   void reset()
+   {
+      mCount = 0;
+      mIsClosed = false;
+   }
+};
+
+// A bounded queue that receives the converted values as soon as they are
+// parsed.  The values are consumed on a different thread with pop().  The
+// parser waits while the queue is full.
+//
+// The queue has a single producer, the parser, and is intended for a single
+// consumer.  It is closed when the parser has processed all input arguments
+// or when the parse is abandoned, eg. because of an exception, and reopened
+// when the parser starts a new parse.  The values of the previous parse that
+// were not popped yet stay in the queue and the values of the new parse are
+// appended after them.
+template<typename T>
+class queue_sink
+{
+public:
+   using value_type = T;
+
+private:
+   mutable std::mutex mMutex;
+   std::condition_variable mNotFull;
+   std::condition_variable mNotEmpty;
+   std::deque<T> mQueue;
+   size_t mCapacity;
+   size_t mCount = 0;
+   bool mIsClosed = false;
+
+public:
+   explicit queue_sink( size_t capacity )
+      : mCapacity( capacity > 0 ? capacity : 1 )
+   {}
+
+   // Add a value to the queue.  Wait while the queue is full.
+   void push( T&& value )
+   {
+      std::unique_lock<std::mutex> lock( mMutex );
+      mNotFull.wait( lock, [this] { return mQueue.size() < mCapacity; } );
+      mQueue.push_back( std::move( value ) );
+      ++mCount;
+      lock.unlock();
+      mNotEmpty.notify_one();
+   }
+
+   // Remove a value from the queue.  Wait while the queue is empty.  Returns
+   // nullopt when the queue is empty and closed.
+   std::optional<T> pop()
+   {
+      std::unique_lock<std::mutex> lock( mMutex );
+      mNotEmpty.wait( lock, [this] { return !mQueue.empty() || mIsClosed; } );
+      if ( mQueue.empty() )
+         return {};
+
+      auto value = std::move( mQueue.front() );
+      mQueue.pop_front();
+      lock.unlock();
+      mNotFull.notify_one();
+      return value;
+   }
+
+   void close()
+   {
+      {
+         std::lock_guard<std::mutex> lock( mMutex );
+         mIsClosed = true;
+      }
+      mNotEmpty.notify_all();
+   }
+
+   // The number of values pushed since the last reset.
+   size_t count() const
+   {
+      std::lock_guard<std::mutex> lock( mMutex );
+      return mCount;
+   }
+
+   // Reopen the queue for a new parse.  The queued values are kept.
+   void reset()
+   {
+      std::lock_guard<std::mutex> lock( mMutex );
+      mCount = 0;
+      mIsClosed = false;
+   }
+};
+
+template<typename T>
+struct is_sink : std::false_type
+{};
+
+template<typename T>
+struct is_sink<value_sink<T>> : std::true_type
+{};
+
+template<typename T>
+struct is_sink<queue_sink<T>> : std::true_type
+{};
+
+}   // namespace argumentum
@@ -0,0 +1,329 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+// The runtime of the parsers generated by argumentum-gen from a schema file.
+// The options, the name lookup table and the help text of a generated parser
+// are constexpr tables, so no work is done before parsing and the parse
+// allocates memory only for list values and errors.
+//
+// A generated parser supports a subset of the features of argument_parser:
+// long and short options, combined short flags, '--name=value', '--', typed
+// option values and positional parameters.
+
+#include "convert.h"
+#include "outputsink.h"
+#include "parseresult.h"
+
+#include <array>
+#include <cstdint>
+#ifndef ARGUMENTUM_SLIM
+#include <iostream>
+#endif
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argumentum {
+
+// The destination of the help of a generated parser.  The slim build
+// (ARGUMENTUM_SLIM) writes to a sink instead of a standard stream.
+#ifdef ARGUMENTUM_SLIM
+using static_output_t = IOutputSink;
+
+inline static_output_t* default_static_output()
+{
+   static FileOutputSink sink( stdout );
+   return &sink;
+}
+
+inline void write_static_output( static_output_t& out, std::string_view text )
+{
+   out.write( text );
+}
+#else
+using static_output_t = std::ostream;
+
+inline static_output_t* default_static_output()
+{
+   return &std::cout;
+}
+
+inline void write_static_output( static_output_t& out, std::string_view text )
+{
+   out << text;
+}
+#endif
+
+struct StaticOption
+{
+   std::string_view shortName;
+   std::string_view longName;
+   int minArgs;
+   // -1: unlimited
+   int maxArgs;
+   bool isRequired;
+   bool isPositional;
+   bool isHelp;
+
+   constexpr std::string_view getName() const
+   {
+      return longName.empty() ? shortName : longName;
+   }
+};
+
+struct StaticParseError
+{
+   std::string option;
+   int errorCode;
+};
+
+class static_parse_result
+{
+public:
+   std::vector<StaticParseError> errors;
+   std::vector<std::string_view> ignoredArguments;
+   bool helpWasShown = false;
+
+public:
+   explicit operator bool() const
+   {
+      return errors.empty() && ignoredArguments.empty() && !helpWasShown;
+   }
+};
+
+// The hash used by the perfect hash tables of the generated parsers.  The
+// generator searches for a seed that maps all the option names to distinct
+// slots.
+constexpr uint32_t static_name_hash( std::string_view name, uint32_t seed )
+{
+   // FNV-1a with a seeded offset basis
+   uint32_t hash = 2166136261u ^ ( seed * 16777619u );
+   for ( auto ch : name ) {
+      hash ^= static_cast<unsigned char>( ch );
+      hash *= 16777619u;
+   }
+   return hash ^ ( hash >> 15 );
+}
+
+// Typed assignment of a value to a field of a generated parser.
+template<typename T>
+bool static_assign( T& target, std::string_view value )
+{
+   if constexpr ( std::is_same_v<T, bool> ) {
+      target = true;
+      return true;
+   }
+   else if constexpr ( std::is_same_v<T, std::string_view> ) {
+      target = value;
+      return true;
+   }
+   else
+      return parse_number( value, target );
+}
+
+template<typename T>
+bool static_assign( std::optional<T>& target, std::string_view value )
+{
+   T converted{};
+   if ( !static_assign( converted, value ) )
+      return false;
+   target = converted;
+   return true;
+}
+
+template<typename T>
+bool static_assign( std::vector<T>& target, std::string_view value )
+{
+   T converted{};
+   if ( !static_assign( converted, value ) )
+      return false;
+   target.push_back( converted );
+   return true;
+}
+
+// The parse loop of a generated parser.  TSpec is generated from a schema.
+// It defines the tables `options`, `nameSlots`, `positional`, the constants
+// `hashSeed` and `help` and the function `assign( TValues&, index, value )`.
+template<typename TSpec, typename TValues>
+class StaticParser
+{
+   static constexpr size_t optionCount = TSpec::options.size();
+
+   TValues& mValues;
+   static_output_t* mpOut;
+   static_parse_result mResult;
+   std::array<int, optionCount> mCounts{};
+   int mActive = -1;
+   size_t mPosition = 0;
+   bool mIgnoreOptions = false;
+
+public:
+   StaticParser( TValues& values, static_output_t* pOut )
+      : mValues( values )
+      , mpOut( pOut )
+   {}
+
+   static int findOption( std::string_view name )
+   {
+      constexpr auto mask = TSpec::nameSlots.size() - 1;
+      auto index = TSpec::nameSlots[static_name_hash( name, TSpec::hashSeed ) & mask];
+      if ( index < 0 )
+         return -1;
+
+      auto& option = TSpec::options[index];
+      return ( name == option.longName || name == option.shortName ) ? index : -1;
+   }
+
+   static_parse_result parse( const char* const* ibegin, const char* const* iend )
+   {
+      for ( auto iarg = ibegin; iarg != iend && !mResult.helpWasShown; ++iarg ) {
+         auto arg = std::string_view( *iarg );
+         if ( !mIgnoreOptions && arg == "--" ) {
+            closeOption();
+            mIgnoreOptions = true;
+         }
+         else if ( isOption( arg ) )
+            startOptions( arg );
+         else if ( mActive >= 0 && acceptsMore( mActive ) )
+            setValue( mActive, arg );
+         else
+            addFreeArgument( arg );
+      }
+
+      if ( mResult.helpWasShown )
+         return std::move( mResult );
+
+      closeOption();
+      for ( size_t i = 0; i < optionCount; ++i ) {
+         auto& option = TSpec::options[i];
+         if ( !option.isPositional ) {
+            if ( option.isRequired && mCounts[i] == 0 )
+               addError( option.getName(), MISSING_OPTION );
+         }
+         else if ( mCounts[i] < option.minArgs && ( option.isRequired || mCounts[i] > 0 ) )
+            addError( option.getName(), MISSING_ARGUMENT );
+      }
+
+      return std::move( mResult );
+   }
+
+private:
+   bool acceptsMore( int index ) const
+   {
+      auto maxArgs = TSpec::options[index].maxArgs;
+      return maxArgs < 0 || mCounts[index] < maxArgs;
+   }
+
+   // A negative number is a value unless an option with the same name exists.
+   bool isOption( std::string_view arg ) const
+   {
+      if ( mIgnoreOptions || arg.size() < 2 || arg[0] != '-' )
+         return false;
+
+      auto isNumber = ( arg[1] >= '0' && arg[1] <= '9' ) || arg[1] == '.';
+      return !isNumber || findOption( arg ) >= 0;
+   }
+
+   void startOptions( std::string_view arg )
+   {
+      closeOption();
+      if ( arg[1] == '-' ) {
+         auto eqpos = arg.find( '=' );
+         auto name = arg.substr( 0, eqpos );
+         auto index = findOption( name );
+         if ( index < 0 )
+            addError( name, UNKNOWN_OPTION );
+         else if ( eqpos == std::string_view::npos )
+            startOption( index );
+         else if ( TSpec::options[index].maxArgs == 0 )
+            addError( name, FLAG_PARAMETER );
+         else {
+            startOption( index );
+            setValue( index, arg.substr( eqpos + 1 ) );
+         }
+         return;
+      }
+
+      // Combined short options.  Only the last one can receive values.
+      char name[] = "-?";
+      for ( size_t i = 1; i < arg.size() && !mResult.helpWasShown; ++i ) {
+         closeOption();
+         name[1] = arg[i];
+         auto index = findOption( name );
+         if ( index < 0 )
+            addError( name, UNKNOWN_OPTION );
+         else
+            startOption( index );
+      }
+   }
+
+   void startOption( int index )
+   {
+      auto& option = TSpec::options[index];
+      if ( option.isHelp ) {
+         if ( mpOut )
+            write_static_output( *mpOut, TSpec::help );
+         mResult.helpWasShown = true;
+         return;
+      }
+
+      if ( option.maxArgs == 0 ) {
+         TSpec::assign( mValues, index, "1" );
+         ++mCounts[index];
+      }
+      else
+         mActive = index;
+   }
+
+   void closeOption()
+   {
+      if ( mActive >= 0 && mCounts[mActive] < TSpec::options[mActive].minArgs )
+         addError( TSpec::options[mActive].getName(), MISSING_ARGUMENT );
+      mActive = -1;
+   }
+
+   void setValue( int index, std::string_view value )
+   {
+      ++mCounts[index];
+      if ( !TSpec::assign( mValues, index, value ) )
+         addError( TSpec::options[index].getName(), CONVERSION_ERROR );
+   }
+
+   void addError( std::string_view option, int errorCode )
+   {
+      mResult.errors.push_back( { std::string( option ), errorCode } );
+   }
+
+   void addFreeArgument( std::string_view arg )
+   {
+      closeOption();
+      for ( ; mPosition < TSpec::positional.size(); ++mPosition ) {
+         auto index = TSpec::positional[mPosition];
+         if ( acceptsMore( index ) ) {
+            setValue( index, arg );
+            return;
+         }
+      }
+
+      mResult.ignoredArguments.push_back( arg );
+   }
+};
+
+// Parse the arguments with the generated parser TSpec and store the values in
+// @p values.  String values are views into the input arguments.  The help is
+// written to @p pOut.
+template<typename TSpec, typename TValues>
+static_parse_result static_parse_args( TValues& values, int argc, const char* const* argv,
+      int skip_args = 1, static_output_t* pOut = default_static_output() )
+{
+   if ( !argv || argc <= skip_args )
+      return StaticParser<TSpec, TValues>( values, pOut ).parse( nullptr, nullptr );
+
+   return StaticParser<TSpec, TValues>( values, pOut )
+         .parse( argv + std::max( 0, skip_args ), argv + argc );
+}
+
+}   // namespace argumentum
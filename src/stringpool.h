@@ -0,0 +1,46 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace argumentum {
+
+// Stores the interned strings in large chunks.  Every distinct string is
+// stored once and the returned views stay valid for the lifetime of the pool.
+// The pool is used for the descriptive texts of the options (help, metavars,
+// choices) that are often repeated and never modified.
+class StringPool
+{
+   static constexpr size_t chunkSize = 8192;
+
+   std::vector<std::unique_ptr<char[]>> mChunks;
+   // The chunk that receives the small strings.
+   char* mpChunk = nullptr;
+   size_t mChunkUsed = 0;
+   size_t mAllocatedBytes = 0;
+   std::unordered_set<std::string_view> mStrings;
+
+public:
+   StringPool() = default;
+   StringPool( const StringPool& ) = delete;
+   StringPool& operator=( const StringPool& ) = delete;
+
+   // Returns the view of the pooled copy of @p text.
+   std::string_view intern( std::string_view text );
+
+   // The number of distinct strings in the pool.
+   size_t size() const;
+
+   // The memory allocated for the chunks and the index of the strings.
+   size_t allocatedBytes() const;
+
+private:
+   char* allocate( size_t size );
+};
+
+}   // namespace argumentum
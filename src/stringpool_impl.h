@@ -0,0 +1,64 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "stringpool.h"
+
+#include <cstring>
+
+namespace argumentum {
+
+ARGUMENTUM_INLINE std::string_view StringPool::intern( std::string_view text )
+{
+   if ( text.empty() )
+      return {};
+
+   auto it = mStrings.find( text );
+   if ( it != mStrings.end() )
+      return *it;
+
+   auto pData = allocate( text.size() );
+   std::memcpy( pData, text.data(), text.size() );
+   auto pooled = std::string_view( pData, text.size() );
+   mStrings.insert( pooled );
+   return pooled;
+}
+
+ARGUMENTUM_INLINE size_t StringPool::size() const
+{
+   return mStrings.size();
+}
+
+ARGUMENTUM_INLINE size_t StringPool::allocatedBytes() const
+{
+   // An estimate of the node based hash set: a node with the view and the
+   // next pointer per string and a bucket pointer per bucket.
+   auto indexBytes = mStrings.size() * ( sizeof( std::string_view ) + 2 * sizeof( void* ) )
+         + mStrings.bucket_count() * sizeof( void* );
+   return mAllocatedBytes + indexBytes;
+}
+
+ARGUMENTUM_INLINE char* StringPool::allocate( size_t size )
+{
+   // Large strings get their own chunk so that the current chunk can still be
+   // filled with small strings.
+   if ( size > chunkSize / 4 ) {
+      mChunks.push_back( std::make_unique<char[]>( size ) );
+      mAllocatedBytes += size;
+      return mChunks.back().get();
+   }
+
+   if ( !mpChunk || mChunkUsed + size > chunkSize ) {
+      mChunks.push_back( std::make_unique<char[]>( chunkSize ) );
+      mpChunk = mChunks.back().get();
+      mChunkUsed = 0;
+      mAllocatedBytes += chunkSize;
+   }
+
+   auto pData = mpChunk + mChunkUsed;
+   mChunkUsed += size;
+   return pData;
+}
+
+}   // namespace argumentum
@@ -0,0 +1,129 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+#include "value.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
+
+namespace argumentum {
+
+template<typename TStruct, typename TTarget>
+class MemberValue;
+
+template<typename TStruct, typename TTarget>
+struct MemberTarget;
+
+// Binds the parameters to the members of a struct through member pointers.
+// The instance that receives the values is selected with bind() before a
+// parse so the parameters are defined once and every parse can fill a
+// different instance.  The copies of a binding select the same instance.
+//
+// The members are not reset when a parse starts; the bound instance provides
+// the initial values.
+template<typename TStruct>
+class StructBinding
+{
+   template<typename, typename>
+   friend class MemberValue;
+
+   struct State
+   {
+      TStruct* pTarget = nullptr;
+      // The bytes of the bound member pointers.  The addresses of the keys
+      // identify the targets so that the options bound to the same member
+      // share a value.
+      std::deque<std::string> memberKeys;
+   };
+
+   std::shared_ptr<State> mpState = std::make_shared<State>();
+
+public:
+   // The target of a parameter that stores its values in @p pMember of the
+   // bound instance.  Pass it to ParameterConfig::add_parameter.
+   template<typename TTarget>
+   MemberTarget<TStruct, TTarget> member( TTarget TStruct::*pMember ) const
+   {
+      return { *this, pMember };
+   }
+
+   void bind( TStruct& target )
+   {
+      mpState->pTarget = &target;
+   }
+
+   void unbind()
+   {
+      mpState->pTarget = nullptr;
+   }
+
+   TStruct* target() const
+   {
+      return mpState->pTarget;
+   }
+
+private:
+   template<typename TTarget>
+   uintptr_t getMemberId( TTarget TStruct::*pMember ) const
+   {
+      std::string key( sizeof( pMember ), '\0' );
+      std::memcpy( key.data(), &pMember, sizeof( pMember ) );
+      auto& keys = mpState->memberKeys;
+      auto it = std::find( keys.begin(), keys.end(), key );
+      if ( it == keys.end() ) {
+         keys.push_back( std::move( key ) );
+         it = std::prev( keys.end() );
+      }
+      return reinterpret_cast<uintptr_t>( &*it );
+   }
+};
+
+template<typename TStruct, typename TTarget>
+struct MemberTarget
+{
+   StructBinding<TStruct> binding;
+   TTarget TStruct::*pMember;
+};
+
+// The value of a parameter that is stored in a member of the instance bound
+// to a StructBinding.  It is converted and configured like a value with a
+// TTarget variable as the target.
+template<typename TStruct, typename TTarget>
+class MemberValue : public ConvertedValue<TTarget>
+{
+   StructBinding<TStruct> mBinding;
+   TTarget TStruct::*mpMember;
+
+public:
+   MemberValue( const MemberTarget<TStruct, TTarget>& member )
+      : mBinding( member.binding )
+      , mpMember( member.pMember )
+   {}
+
+   TargetId getTargetId() const override
+   {
+      return std::make_pair( this->getValueTypeId(), mBinding.getMemberId( mpMember ) );
+   }
+
+protected:
+   TTarget& resolveTarget() override
+   {
+      auto pTarget = mBinding.target();
+      assert( pTarget != nullptr );
+      return pTarget->*mpMember;
+   }
+
+   void doReset() override
+   {
+      this->mCapacityHint = 0;
+   }
+};
+
+}   // namespace argumentum
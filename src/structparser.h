@@ -0,0 +1,112 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#pragma once
+
+// A parser that stores the values of the options in the members of a struct.
+// The options are bound to the members with member pointers when the parser is
+// defined and the instance that receives the values is passed to parse_args,
+// so the same parser can fill a new instance for every parse.
+//
+// The options are defined and parsed by an argument_parser through a
+// StructBinding, so they support all the features of argument_parser.  The
+// members are not reset before a parse: the options that are not present in
+// the input arguments leave their members unchanged.
+
+#include "argparser.h"
+#include "structbinding.h"
+
+#include <string>
+#include <vector>
+
+namespace argumentum {
+
+template<typename TStruct>
+class struct_parser
+{
+   argument_parser mParser;
+   StructBinding<TStruct> mBinding;
+
+public:
+   ParserConfig& config()
+   {
+      return mParser.config();
+   }
+
+   ParameterConfig params()
+   {
+      return mParser.params();
+   }
+
+   // The binding of the parsed struct.  Use it to bind the members in the
+   // Options added with ParameterConfig::add_parameters.
+   const StructBinding<TStruct>& binding() const
+   {
+      return mBinding;
+   }
+
+   /**
+    * Bind the parameter with names @p name and @p altName to the @p member of
+    * the parsed struct.
+    */
+   template<typename TTarget>
+   OptionConfigA<TTarget> add(
+         TTarget TStruct::*member, const std::string& name = "", const std::string& altName = "" )
+   {
+      return mParser.params().add_parameter( mBinding.member( member ), name, altName );
+   }
+
+   /**
+    * Parse the input arguments and store the values in the members of @p
+    * target.
+    */
+   ParseResult parse_args( TStruct& target, int argc, char** argv, int skip_args = 1 )
+   {
+      auto bound = BoundTarget( mBinding, target );
+      return mParser.parse_args( argc, argv, skip_args );
+   }
+
+   ParseResult parse_args(
+         TStruct& target, const std::vector<std::string>& args, int skip_args = 0 )
+   {
+      auto bound = BoundTarget( mBinding, target );
+      return mParser.parse_args( args, skip_args );
+   }
+
+   ParseResult parse_args( TStruct& target, ArgumentStream& args )
+   {
+      auto bound = BoundTarget( mBinding, target );
+      return mParser.parse_args( args );
+   }
+
+   std::vector<std::string> definition_errors() const
+   {
+      return mParser.definition_errors();
+   }
+
+   const argument_parser& parser() const
+   {
+      return mParser;
+   }
+
+private:
+   // Binds the target for the duration of a parse.
+   class BoundTarget
+   {
+      StructBinding<TStruct>& mBinding;
+
+   public:
+      BoundTarget( StructBinding<TStruct>& binding, TStruct& target )
+         : mBinding( binding )
+      {
+         mBinding.bind( target );
+      }
+
+      ~BoundTarget()
+      {
+         mBinding.unbind();
+      }
+   };
+};
+
+}   // namespace argumentum
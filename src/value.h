@@ -5,8 +5,13 @@
 
 #include "convert.h"
 #include "notifier.h"
+#include "parallel.h"
+#include "sink.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace argumentum {
@@ -37,13 +42,39 @@ using AssignAction =
  */
 using AssignDefaultAction = std::function<void( Value& target )>;
 
+// The result of an assignment of an argument to a value.
+struct AssignStatus
+{
+   EConversionError error = EConversionError::none;
+   // The position of the element of a delimited list that could not be
+   // converted.
+   std::optional<size_t> element;
+
+   explicit operator bool() const
+   {
+      return error == EConversionError::none;
+   }
+};
+
 class Value
 {
+   // The arguments that will be converted after all the arguments are parsed.
+   struct DeferredValues
+   {
+      unsigned threadCount = 0;
+      std::vector<std::string> values;
+   };
+
    int mAssignCount = 0;
+   // The number of the parse in which the assign count was last changed.
+   uint64_t mEpoch = 0;
    bool mHasErrors = false;
+   std::shared_ptr<DeferredValues> mpDeferred;
+   // The error reported by the action that is currently executed.
+   AssignStatus mStatus;
 
 public:
-   void setValue( std::string_view value, AssignAction action, Environment& env );
+   AssignStatus setValue( std::string_view value, AssignAction action, Environment& env );
    void setDefault( AssignDefaultAction action );
    /**
     * Called when an option expects 0 or more values, but none is given.
@@ -52,9 +83,43 @@ public:
     * - vector: add flagValue if empty.
     * - optional<vector>: set to empty vector if nullopt.
     */
-   void setMissingValue( std::string_view flagValue, Environment& env );
+   AssignStatus setMissingValue( std::string_view flagValue, Environment& env );
    void markBadArgument();
 
+   /**
+    * Called by an assign action when the argument can not be assigned.  The
+    * error is returned from setValue or setMissingValue.
+    */
+   void failAssignment( EConversionError error, std::optional<size_t> element = {} );
+
+   /**
+    * Store the arguments that would be converted with the default action and
+    * convert them later in finishAssignments() using @p threadCount threads.
+    */
+   void setDeferred( unsigned threadCount );
+
+   /**
+    * Called when the parser has processed all the input arguments.  Converts
+    * the stored arguments and notifies the target that no more values will be
+    * assigned.
+    *
+    * @returns the positions of the stored arguments that could not be
+    * converted.
+    */
+   std::vector<size_t> finishAssignments();
+
+   /**
+    * Notify the target that no more values will be assigned.  Called from
+    * finishAssignments() and when a parse is abandoned.
+    */
+   void closeTarget();
+
+   /**
+    * Prepare the target to receive @p count more values.  The count is only a
+    * hint, a value with a non-vector target ignores it.
+    */
+   void reserve( size_t count );
+
    /**
     * The count of assignments through all the options that share this value.
     */
@@ -63,14 +128,28 @@ public:
    void onOptionStarted();
    void reset();
 
+   /**
+    * Reset the assign count if it was last changed in a parse before @p epoch.
+    * The target is also reset when @p resetTarget is true.
+    */
+   void enterEpoch( uint64_t epoch, bool resetTarget );
+   uint64_t getEpoch() const;
+
    virtual ValueId getValueId() const;
    virtual ValueTypeId getValueTypeId() const = 0;
    virtual TargetId getTargetId() const;
 
 protected:
-   virtual AssignAction getDefaultAction() = 0;
+   // Convert the argument and assign it to the target without copying it.
+   // Used when the option has no assign action.  A conversion error is
+   // reported with failAssignment().
+   virtual void doAssign( std::string_view value ) = 0;
    virtual AssignAction getMissingValueAction() = 0;
    virtual void doReset();
+   virtual void doReserve( size_t count );
+   virtual std::vector<size_t> doConvertDeferred(
+         const std::vector<std::string>& values, unsigned threadCount );
+   virtual void doCloseTarget();
 };
 
 class VoidValue : public Value
@@ -80,10 +159,131 @@ public:
    static VoidValue* value_cast( Value& value );
 
 protected:
-   AssignAction getDefaultAction() override;
+   void doAssign( std::string_view value ) override;
    AssignAction getMissingValueAction() override;
 };
 
+// Check if an argument can be converted to TVal with
+// argumentum::from_string and which of the conversions are available.
+template<typename TVal>
+struct has_from_string
+{
+private:
+   typedef char YesType[1];
+   typedef char NoType[2];
+
+   template<typename C>
+   static YesType& test( decltype( C::convert( std::declval<const std::string&>() ) )* );
+   template<typename C>
+   static NoType& test( ... );
+
+   template<typename C>
+   static YesType& testTry( decltype( C::try_convert( std::declval<const std::string&>() ) )* );
+   template<typename C>
+   static NoType& testTry( ... );
+
+   template<typename C>
+   static YesType& testView( decltype( C::convert( std::declval<std::string_view>() ) )* );
+   template<typename C>
+   static NoType& testView( ... );
+
+   template<typename C>
+   static YesType& testViewTry(
+         decltype( C::try_convert( std::declval<std::string_view>() ) )* );
+   template<typename C>
+   static NoType& testViewTry( ... );
+
+   using converter_t = ::argumentum::from_string<TVal>;
+
+public:
+   enum {
+      has_view_convert = sizeof( testView<converter_t>( 0 ) ) == sizeof( YesType ),
+      has_view_try_convert = sizeof( testViewTry<converter_t>( 0 ) ) == sizeof( YesType ),
+      has_try_convert = sizeof( testTry<converter_t>( 0 ) ) == sizeof( YesType ),
+      value = has_view_convert || has_try_convert
+            || sizeof( test<converter_t>( 0 ) ) == sizeof( YesType )
+   };
+};
+
+// Check if std::string can be converted to TVal with constructors or
+// assignment operators.
+template<class TVal>
+struct can_convert   // (clf)
+   : std::integral_constant<bool,   // (clf)
+           std::is_constructible<std::string, TVal>::value   // (clf)
+                 || std::is_convertible<std::string, TVal>::value   // (clf)
+                 || std::is_assignable<TVal, std::string>::value   // (clf)
+           >
+{
+   template<typename T>
+   constexpr static bool has_from_string()
+   {
+      return true;
+   }
+};
+
+template<typename TVar, typename TVal>
+EConversionError assign_converted( TVar& var, ConversionResult<TVal>&& result )
+{
+   if ( result )
+      var = std::move( result.value );
+   return result.error;
+}
+
+template<typename TVar, typename TVal>
+EConversionError assign_converted( TVar& var, std::optional<TVal>&& result )
+{
+   if ( !result )
+      return EConversionError::invalidValue;
+   var = std::move( *result );
+   return EConversionError::none;
+}
+
+template<typename TVar, typename TVal>
+EConversionError assign_converted( TVar& var, TVal&& result )
+{
+   var = std::forward<TVal>( result );
+   return EConversionError::none;
+}
+
+// Convert an argument to the type of @p var with argumentum::from_string or
+// with the constructors and the assignment operators of the type.  @p var is
+// not modified when the conversion fails.
+template<typename TVar, std::enable_if_t<has_from_string<TVar>::value, int> = 0>
+EConversionError convert_value( TVar& var, std::string_view value )
+{
+   using converter_t = ::argumentum::from_string<TVar>;
+   if constexpr ( has_from_string<TVar>::has_view_convert )
+      return assign_converted( var, converter_t::convert( value ) );
+   else if constexpr ( has_from_string<TVar>::has_view_try_convert )
+      return assign_converted( var, converter_t::try_convert( value ) );
+   else if constexpr ( has_from_string<TVar>::has_try_convert )
+      return assign_converted( var, converter_t::try_convert( std::string{ value } ) );
+   else
+      return assign_converted( var, converter_t::convert( std::string{ value } ) );
+}
+
+template<typename TVar,
+      std::enable_if_t<!has_from_string<TVar>::value && can_convert<TVar>::value, int> = 0>
+EConversionError convert_value( TVar& var, std::string_view value )
+{
+   if constexpr ( std::is_constructible<TVar, std::string_view>::value )
+      var = TVar{ value };
+   else
+      var = TVar{ std::string{ value } };
+   return EConversionError::none;
+}
+
+template<typename TVar,
+      std::enable_if_t<!has_from_string<TVar>::value && !can_convert<TVar>::value
+                  && !is_sink<TVar>::value,
+            int> = 0>
+EConversionError convert_value( TVar&, std::string_view value )
+{
+   Notifier::warn( "Assignment is not implemented. ('" + std::string{ value } + "')" );
+   return EConversionError::none;
+}
+
 template<typename T>
 class OptionConfigA;
 
@@ -93,46 +293,17 @@ class ConvertedValue : public Value
    template<typename T>
    friend class ::argumentum::OptionConfigA;
 
-   // Check if std::string can be converted to TVal with argparse::from_string.
-   template<typename TVal>
-   struct has_from_string
-   {
-   private:
-      typedef char YesType[1];
-      typedef char NoType[2];
-
-      template<typename C>
-      static YesType& test( decltype( &C::convert ) );
-      template<typename C>
-      static NoType& test( ... );
-
-   public:
-      enum { value = sizeof( test<::argumentum::from_string<TVal>>( 0 ) ) == sizeof( YesType ) };
-   };
-
-   // Check if std::string can be converted to TVal with constructors or
-   // assignment operators.
-   template<class TVal>
-   struct can_convert   // (clf)
-      : std::integral_constant<bool,   // (clf)
-              std::is_constructible<std::string, TVal>::value   // (clf)
-                    || std::is_convertible<std::string, TVal>::value   // (clf)
-                    || std::is_assignable<TVal, std::string>::value   // (clf)
-              >
-   {
-      template<typename T>
-      constexpr static bool has_from_string()
-      {
-         return true;
-      }
-   };
-
 protected:
-   TTarget& mTarget;
+   // The target is null when it is resolved by resolveTarget(), eg. in a
+   // member of the struct that receives the values of a parse.
+   TTarget* mpTarget;
+
+   // The capacity of an optional<vector> target that is not engaged yet.
+   size_t mCapacityHint = 0;
 
 public:
    ConvertedValue( TTarget& value )
-      : mTarget( value )
+      : mpTarget( &value )
    {}
 
    ValueTypeId getValueTypeId() const override
@@ -142,7 +313,7 @@ public:
 
    TargetId getTargetId() const override
    {
-      return std::make_pair( getValueTypeId(), reinterpret_cast<uintptr_t>( &mTarget ) );
+      return std::make_pair( getValueTypeId(), reinterpret_cast<uintptr_t>( mpTarget ) );
    }
 
    static ValueTypeId valueTypeId()
@@ -160,106 +331,253 @@ public:
    }
 
 protected:
-   AssignAction getDefaultAction() override
+   ConvertedValue()
+      : mpTarget( nullptr )
+   {}
+
+   TTarget& target()
    {
-      return []( Value& value, const std::string& argument, Environment& ) {
-         auto pConverted = ConvertedValue<TTarget>::value_cast( value );
-         if ( pConverted )
-            pConverted->assign( pConverted->mTarget, argument );
-      };
+      return mpTarget ? *mpTarget : resolveTarget();
+   }
+
+   virtual TTarget& resolveTarget()
+   {
+      return *mpTarget;
+   }
+
+   void doAssign( std::string_view value ) override
+   {
+      auto error = assign( target(), value );
+      if ( error != EConversionError::none )
+         failAssignment( error );
    }
 
    AssignAction getMissingValueAction() override
    {
       return []( Value& value, const std::string& argument, Environment& ) {
          auto pConverted = ConvertedValue<TTarget>::value_cast( value );
-         if ( pConverted )
-            pConverted->assignMissing( pConverted->mTarget, argument );
+         if ( pConverted ) {
+            auto error = pConverted->assignMissing( pConverted->target(), argument );
+            if ( error != EConversionError::none )
+               value.failAssignment( error );
+         }
       };
    }
 
    void doReset() override
    {
-      mTarget = TTarget{};
+      resetTarget( target() );
+      mCapacityHint = 0;
+   }
+
+   void doCloseTarget() override
+   {
+      if constexpr ( is_sink<TTarget>::value )
+         target().close();
+   }
+
+   template<typename TVar, std::enable_if_t<!is_sink<TVar>::value, int> = 0>
+   void resetTarget( TVar& var )
+   {
+      var = TVar{};
+   }
+
+   // A sink is not replaced because it holds the consumer.
+   template<typename TVar, std::enable_if_t<is_sink<TVar>::value, int> = 0>
+   void resetTarget( TVar& var )
+   {
+      var.reset();
+   }
+
+   void doReserve( size_t count ) override
+   {
+      reserveTarget( target(), count );
    }
 
    template<typename TVar>
-   void assign( std::vector<TVar>& var, const std::string& value )
+   void reserveTarget( std::vector<TVar>& var, size_t count )
    {
-      TVar target;
-      assign( target, value );
-      var.emplace_back( std::move( target ) );
+      // Keep the geometric growth of the vector when the values arrive in
+      // multiple short runs.
+      auto required = var.size() + count;
+      if ( required > var.capacity() )
+         var.reserve( std::max( required, 2 * var.capacity() ) );
    }
 
    template<typename TVar>
-   void assignMissing( std::vector<TVar>& var, const std::string& value )
+   void reserveTarget( std::optional<std::vector<TVar>>& var, size_t count )
    {
-      if ( var.empty() ) {
-         TVar target;
-         assign( target, value );
-         var.emplace_back( std::move( target ) );
+      if ( var.has_value() )
+         reserveTarget( *var, count );
+      else
+         mCapacityHint = count;
+   }
+
+   template<typename TVar>
+   void reserveTarget( TVar&, size_t )
+   {}
+
+   std::vector<size_t> doConvertDeferred(
+         const std::vector<std::string>& values, unsigned threadCount ) override
+   {
+      return convertValues( target(), values, threadCount );
+   }
+
+   // The values are converted in place.  The elements that could not be
+   // converted are removed afterwards.  The returned positions are relative
+   // to the values of the option, including the values that were assigned
+   // before the deferred values.
+   template<typename TVar, std::enable_if_t<!std::is_same<TVar, bool>::value, int> = 0>
+   std::vector<size_t> convertValues(
+         std::vector<TVar>& var, const std::vector<std::string>& values, unsigned threadCount )
+   {
+      auto first = var.size();
+      var.resize( first + values.size() );
+      auto failed = convert_in_parallel( values.size(), threadCount, [&]( size_t i ) {
+         return assign( var[first + i], values[i] ) == EConversionError::none;
+      } );
+
+      if ( !failed.empty() ) {
+         auto ifailed = failed.begin();
+         auto itarget = var.begin() + first;
+         for ( size_t i = 0; i < values.size(); ++i ) {
+            if ( ifailed != failed.end() && *ifailed == i ) {
+               ++ifailed;
+               continue;
+            }
+            if ( itarget != var.begin() + first + i )
+               *itarget = std::move( var[first + i] );
+            ++itarget;
+         }
+         var.erase( itarget, var.end() );
+
+         for ( auto& index : failed )
+            index += first;
+      }
+
+      return failed;
+   }
+
+   // Sequential conversion for the other targets.
+   template<typename TVar>
+   std::vector<size_t> convertValues(
+         TVar& var, const std::vector<std::string>& values, unsigned /*threadCount*/ )
+   {
+      std::vector<size_t> failed;
+      for ( size_t i = 0; i < values.size(); ++i ) {
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+         if ( assign( var, values[i] ) != EConversionError::none )
+            failed.push_back( i );
+#else
+         try {
+            if ( assign( var, values[i] ) != EConversionError::none )
+               failed.push_back( i );
+         }
+         catch ( const std::invalid_argument& ) {
+            failed.push_back( i );
+         }
+         catch ( const std::out_of_range& ) {
+            failed.push_back( i );
+         }
+#endif
       }
+      return failed;
    }
 
+   // The assignments return the error of the conversion of the argument.  The
+   // target is not modified when the conversion fails.
    template<typename TVar>
-   void assign( std::optional<std::vector<TVar>>& var, const std::string& value )
+   EConversionError assign( std::vector<TVar>& var, std::string_view value )
    {
       TVar target;
-      assign( target, value );
-      if ( !var.has_value() )
-         var = std::vector<TVar>{};
-      std::cout << value << "\n";
-      var->emplace_back( std::move( target ) );
+      auto error = assign( target, value );
+      if ( error == EConversionError::none )
+         var.emplace_back( std::move( target ) );
+      return error;
    }
 
    template<typename TVar>
-   void assignMissing( std::optional<std::vector<TVar>>& var, const std::string& /*value*/ )
+   EConversionError assignMissing( std::vector<TVar>& var, std::string_view value )
    {
-      if ( !var.has_value() )
-         var = std::vector<TVar>{};
+      if ( var.empty() )
+         return assign( var, value );
+      return EConversionError::none;
    }
 
    template<typename TVar>
-   void assign( std::optional<TVar>& var, const std::string& value )
+   EConversionError assign( std::optional<std::vector<TVar>>& var, std::string_view value )
    {
       TVar target;
-      assign( target, value );
-      var = std::move( target );
+      auto error = assign( target, value );
+      if ( error != EConversionError::none )
+         return error;
+
+      if ( !var.has_value() ) {
+         var = std::vector<TVar>{};
+         var->reserve( mCapacityHint );
+         mCapacityHint = 0;
+      }
+      var->emplace_back( std::move( target ) );
+      return error;
    }
 
    template<typename TVar>
-   void assignMissing( std::optional<TVar>& var, const std::string& /*value*/ )
+   EConversionError assignMissing(
+         std::optional<std::vector<TVar>>& var, std::string_view /*value*/ )
    {
       if ( !var.has_value() )
-         var = TVar{};
+         var = std::vector<TVar>{};
+      return EConversionError::none;
    }
 
-   template<typename TVar, std::enable_if_t<has_from_string<TVar>::value, int> = 0>
-   void assign( TVar& var, const std::string& value )
+   template<typename TVar, std::enable_if_t<is_sink<TVar>::value, int> = 0>
+   EConversionError assign( TVar& var, std::string_view value )
    {
-      var = ::argumentum::from_string<TVar>::convert( value );
+      typename TVar::value_type target;
+      auto error = assign( target, value );
+      if ( error == EConversionError::none )
+         var.push( std::move( target ) );
+      return error;
    }
 
-   template<typename TVar,
-         std::enable_if_t<!has_from_string<TVar>::value && can_convert<TVar>::value, int> = 0>
-   void assign( TVar& var, const std::string& value )
+   template<typename TVar, std::enable_if_t<is_sink<TVar>::value, int> = 0>
+   EConversionError assignMissing( TVar& var, std::string_view value )
    {
-      var = TVar{ value };
+      if ( var.count() == 0 )
+         return assign( var, value );
+      return EConversionError::none;
    }
 
-   template<typename TVar,
-         std::enable_if_t<!has_from_string<TVar>::value && !can_convert<TVar>::value, int> = 0>
-   void assign( TVar&, const std::string& value )
+   template<typename TVar>
+   EConversionError assign( std::optional<TVar>& var, std::string_view value )
    {
-      Notifier::warn( "Assignment is not implemented. ('" + value + "')" );
+      TVar target;
+      auto error = assign( target, value );
+      if ( error == EConversionError::none )
+         var = std::move( target );
+      return error;
    }
 
    template<typename TVar>
-   void assignMissing( TVar& var, const std::string& value )
+   EConversionError assignMissing( std::optional<TVar>& var, std::string_view /*value*/ )
    {
-      if ( getAssignCount() == 0 )
-         assign( var, value );
+      if ( !var.has_value() )
+         var = TVar{};
+      return EConversionError::none;
+   }
+
+   template<typename TVar, std::enable_if_t<!is_sink<TVar>::value, int> = 0>
+   EConversionError assign( TVar& var, std::string_view value )
+   {
+      return convert_value( var, value );
    }
 
+   template<typename TVar, std::enable_if_t<!is_sink<TVar>::value, int> = 0>
+   EConversionError assignMissing( TVar& var, std::string_view value )
+   {
+      if ( getAssignCount() == 0 )
+         return assign( var, value );
+      return EConversionError::none;
+   }
 };
 }   // namespace argumentum
@@ -20,14 +20,21 @@ ARGUMENTUM_INLINE TargetId Value::getTargetId() const
    return std::make_pair( getValueTypeId(), 0 );
 }
 
-ARGUMENTUM_INLINE void Value::setValue(
+ARGUMENTUM_INLINE AssignStatus Value::setValue(
       std::string_view value, AssignAction action, Environment& env )
 {
    ++mAssignCount;
-   if ( action == nullptr )
-      action = getDefaultAction();
+   if ( action == nullptr && mpDeferred ) {
+      mpDeferred->values.emplace_back( value );
+      return {};
+   }
+
+   mStatus = {};
    if ( action )
       action( *this, std::string{ value }, env );
+   else
+      doAssign( value );
+   return std::move( mStatus );
 }
 
 ARGUMENTUM_INLINE void Value::setDefault( AssignDefaultAction action )
@@ -38,14 +45,23 @@ ARGUMENTUM_INLINE void Value::setDefault( AssignDefaultAction action )
    }
 }
 
-ARGUMENTUM_INLINE void Value::setMissingValue( std::string_view flagValue, Environment& env )
+ARGUMENTUM_INLINE AssignStatus Value::setMissingValue(
+      std::string_view flagValue, Environment& env )
 {
+   // The target will not be empty after the deferred values are converted.
+   if ( mpDeferred && !mpDeferred->values.empty() ) {
+      ++mAssignCount;
+      return {};
+   }
+
+   mStatus = {};
    auto action = getMissingValueAction();
    if ( action ) {
       ++mAssignCount;
       std::string fv{ flagValue };
       action( *this, fv, env );
    }
+   return std::move( mStatus );
 }
 
 ARGUMENTUM_INLINE void Value::markBadArgument()
@@ -54,6 +70,50 @@ ARGUMENTUM_INLINE void Value::markBadArgument()
    mHasErrors = true;
 }
 
+ARGUMENTUM_INLINE void Value::failAssignment(
+      EConversionError error, std::optional<size_t> element )
+{
+   mStatus.error = error;
+   mStatus.element = element;
+}
+
+ARGUMENTUM_INLINE void Value::reserve( size_t count )
+{
+   if ( mpDeferred ) {
+      auto& values = mpDeferred->values;
+      auto required = values.size() + count;
+      if ( required > values.capacity() )
+         values.reserve( std::max( required, 2 * values.capacity() ) );
+   }
+   else
+      doReserve( count );
+}
+
+ARGUMENTUM_INLINE void Value::setDeferred( unsigned threadCount )
+{
+   if ( !mpDeferred )
+      mpDeferred = std::make_shared<DeferredValues>();
+   mpDeferred->threadCount = threadCount;
+}
+
+ARGUMENTUM_INLINE std::vector<size_t> Value::finishAssignments()
+{
+   std::vector<size_t> failed;
+   if ( mpDeferred && !mpDeferred->values.empty() ) {
+      auto values = std::move( mpDeferred->values );
+      mpDeferred->values.clear();
+      failed = doConvertDeferred( values, mpDeferred->threadCount );
+   }
+
+   closeTarget();
+   return failed;
+}
+
+ARGUMENTUM_INLINE void Value::closeTarget()
+{
+   doCloseTarget();
+}
+
 ARGUMENTUM_INLINE int Value::getAssignCount() const
 {
    return mAssignCount;
@@ -66,12 +126,45 @@ ARGUMENTUM_INLINE void Value::reset()
 {
    mAssignCount = 0;
    mHasErrors = false;
+   if ( mpDeferred )
+      mpDeferred->values.clear();
    doReset();
 }
 
+ARGUMENTUM_INLINE void Value::enterEpoch( uint64_t epoch, bool resetTarget )
+{
+   if ( mEpoch == epoch )
+      return;
+
+   mEpoch = epoch;
+   if ( resetTarget )
+      reset();
+   else {
+      mAssignCount = 0;
+      mHasErrors = false;
+   }
+}
+
+ARGUMENTUM_INLINE uint64_t Value::getEpoch() const
+{
+   return mEpoch;
+}
+
 ARGUMENTUM_INLINE void Value::doReset()
 {}
 
+ARGUMENTUM_INLINE void Value::doReserve( size_t )
+{}
+
+ARGUMENTUM_INLINE std::vector<size_t> Value::doConvertDeferred(
+      const std::vector<std::string>&, unsigned )
+{
+   return {};
+}
+
+ARGUMENTUM_INLINE void Value::doCloseTarget()
+{}
+
 ARGUMENTUM_INLINE uintptr_t VoidValue::getValueTypeId() const
 {
    return 0;
@@ -85,10 +178,8 @@ ARGUMENTUM_INLINE VoidValue* VoidValue::value_cast( Value& value )
    return static_cast<VoidValue*>( &value );
 }
 
-ARGUMENTUM_INLINE AssignAction VoidValue::getDefaultAction()
-{
-   return {};
-}
+ARGUMENTUM_INLINE void VoidValue::doAssign( std::string_view )
+{}
 
 ARGUMENTUM_INLINE AssignAction VoidValue::getMissingValueAction()
 {
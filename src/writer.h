@@ -3,17 +3,27 @@
 
 #pragma once
 
-#include <ostream>
-#include <regex>
+#include "outputsink.h"
+
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace argumentum {
 
+// Formats the text into lines of limited width.  The formatted text is
+// rendered into a buffer that is written to the sink with a single write in
+// flush() or when the writer is destroyed.  The positions and widths are
+// measured in display columns of UTF-8 text.
 class Writer
 {
-   std::ostream& stream;
+#ifndef ARGUMENTUM_SLIM
+   std::optional<StreamOutputSink> streamSink;
+#endif
+   IOutputSink& sink;
+   std::string buffer;
    size_t position = 0;
    size_t lastWritePosition = 0;
    size_t width = 80;
@@ -21,21 +31,37 @@ class Writer
    std::string indent;
 
 public:
-   Writer( std::ostream& outStream, size_t widthBytes = 80 );
+   Writer( IOutputSink& outSink, size_t widthColumns = 80 );
+#ifndef ARGUMENTUM_SLIM
+   Writer( std::ostream& outStream, size_t widthColumns = 80 );
+#endif
+   ~Writer();
+   Writer( const Writer& ) = delete;
+   Writer& operator=( const Writer& ) = delete;
 
-   void setIndent( size_t indentBytes );
+   void setIndent( size_t indentColumns );
+   void reserve( size_t bytes );
    void write( std::string_view text );
    void startLine();
    void skipToColumnOrNewLine( size_t column );
    void startParagraph();
+   void flush();
    static std::vector<std::string_view> splitIntoWords( std::string_view text );
 
    // Paragraphs are delimited by two or more consecutive newlines intermixed
    // with other whitespace. The paragraph delimiters are returned as empty blocks.
    static std::vector<std::string_view> splitIntoParagraphs( std::string_view text );
 
+   // The number of columns that the UTF-8 encoded @p text occupies in a
+   // terminal.  Combining marks have no width and East Asian wide characters
+   // occupy two columns.
+   static size_t displayWidth( std::string_view text );
+
 private:
    void write_paragraph( std::string_view text );
+   // Find the first paragraph delimiter in @p text at or after @p start.
+   // Returns the begin and the end of the delimiter or npos if there is none.
+   static std::pair<size_t, size_t> findParagraphBreak( std::string_view text, size_t start );
 };
 
 }   // namespace argumentum
@@ -3,37 +3,101 @@
 
 #pragma once
 
+#include "writer.h"
+
+#include <cstdint>
+
 namespace argumentum {
 
-ARGUMENTUM_INLINE Writer::Writer( std::ostream& outStream, size_t widthBytes )
-   : stream( outStream )
-   , width( widthBytes )
-{}
+namespace detail {
+ARGUMENTUM_INLINE bool isWriterSpace( char ch )
+{
+   return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v' || ch == '\f' || ch == '\r';
+}
+
+// A subset of the Unicode tables used by wcwidth: the zero-width combining
+// marks and the wide East Asian characters and emoji.
+ARGUMENTUM_INLINE size_t codepointWidth( std::uint32_t cp )
+{
+   if ( ( cp >= 0x0300 && cp <= 0x036F ) || ( cp >= 0x1AB0 && cp <= 0x1AFF )
+         || ( cp >= 0x1DC0 && cp <= 0x1DFF ) || ( cp >= 0x200B && cp <= 0x200F )
+         || ( cp >= 0x20D0 && cp <= 0x20FF ) || ( cp >= 0xFE00 && cp <= 0xFE0F )
+         || ( cp >= 0xFE20 && cp <= 0xFE2F ) )
+      return 0;
+
+   if ( ( cp >= 0x1100 && cp <= 0x115F ) || ( cp >= 0x2E80 && cp <= 0x303E )
+         || ( cp >= 0x3041 && cp <= 0x33FF ) || ( cp >= 0x3400 && cp <= 0x4DBF )
+         || ( cp >= 0x4E00 && cp <= 0x9FFF ) || ( cp >= 0xA000 && cp <= 0xA4CF )
+         || ( cp >= 0xAC00 && cp <= 0xD7A3 ) || ( cp >= 0xF900 && cp <= 0xFAFF )
+         || ( cp >= 0xFE30 && cp <= 0xFE4F ) || ( cp >= 0xFF00 && cp <= 0xFF60 )
+         || ( cp >= 0xFFE0 && cp <= 0xFFE6 ) || ( cp >= 0x1F300 && cp <= 0x1F64F )
+         || ( cp >= 0x1F900 && cp <= 0x1F9FF ) || ( cp >= 0x20000 && cp <= 0x3FFFD ) )
+      return 2;
+
+   return 1;
+}
+}   // namespace detail
+
+ARGUMENTUM_INLINE Writer::Writer( IOutputSink& outSink, size_t widthColumns )
+   : sink( outSink )
+   , width( widthColumns )
+{
+   buffer.reserve( 4096 );
+}
+
+#ifndef ARGUMENTUM_SLIM
+ARGUMENTUM_INLINE Writer::Writer( std::ostream& outStream, size_t widthColumns )
+   : streamSink( std::in_place, outStream )
+   , sink( *streamSink )
+   , width( widthColumns )
+{
+   buffer.reserve( 4096 );
+}
+#endif
+
+ARGUMENTUM_INLINE Writer::~Writer()
+{
+   flush();
+}
+
+ARGUMENTUM_INLINE void Writer::setIndent( size_t indentColumns )
+{
+   if ( indentColumns > width )
+      indentColumns = width;
+   indent = indentColumns == 0 ? "" : std::string( indentColumns, ' ' );
+}
 
-ARGUMENTUM_INLINE void Writer::setIndent( size_t indentBytes )
+ARGUMENTUM_INLINE void Writer::reserve( size_t bytes )
 {
-   if ( indentBytes > width )
-      indentBytes = width;
-   indent = indentBytes == 0 ? "" : std::string( indentBytes, ' ' );
+   buffer.reserve( buffer.size() + bytes );
 }
 
 ARGUMENTUM_INLINE void Writer::write( std::string_view text )
 {
-   auto blocks = splitIntoParagraphs( text );
-   for ( auto block : blocks ) {
-      if ( block.empty() )
-         startParagraph();
-      else {
-         write_paragraph( block );
+   size_t start = 0;
+   while ( start < text.size() ) {
+      auto [breakBegin, breakEnd] = findParagraphBreak( text, start );
+      if ( breakBegin == std::string_view::npos )
+         break;
+
+      if ( breakBegin > 0 ) {
+         write_paragraph( text.substr( start, breakBegin - start ) );
          startOfParagraph = false;
       }
+      startParagraph();
+      start = breakEnd;
+   }
+
+   if ( start < text.size() ) {
+      write_paragraph( text.substr( start ) );
+      startOfParagraph = false;
    }
 }
 
 ARGUMENTUM_INLINE void Writer::startLine()
 {
    if ( position > 0 )
-      stream << "\n";
+      buffer.push_back( '\n' );
    position = 0;
    lastWritePosition = 0;
    startOfParagraph = false;
@@ -44,7 +108,7 @@ ARGUMENTUM_INLINE void Writer::skipToColumnOrNewLine( size_t column )
    if ( column >= width || column < position )
       startLine();
    else if ( column > position ) {
-      stream << std::string( column - position, ' ' );
+      buffer.append( column - position, ' ' );
       position = column;
    }
    startOfParagraph = false;
@@ -54,22 +118,30 @@ ARGUMENTUM_INLINE void Writer::startParagraph()
 {
    if ( !startOfParagraph ) {
       startLine();
-      stream << "\n";
+      buffer.push_back( '\n' );
       startOfParagraph = true;
    }
 }
 
+ARGUMENTUM_INLINE void Writer::flush()
+{
+   if ( !buffer.empty() ) {
+      sink.write( buffer );
+      buffer.clear();
+   }
+}
+
 ARGUMENTUM_INLINE std::vector<std::string_view> Writer::splitIntoWords( std::string_view text )
 {
    std::vector<std::string_view> words;
 
    size_t pos = 0;
    while ( pos < text.size() ) {
-      while ( pos < text.size() && iswspace( text[pos] ) )
+      while ( pos < text.size() && detail::isWriterSpace( text[pos] ) )
          ++pos;
 
       size_t end = pos;
-      while ( end < text.size() && !iswspace( text[end] ) )
+      while ( end < text.size() && !detail::isWriterSpace( text[end] ) )
          ++end;
 
       if ( end > pos )
@@ -81,23 +153,47 @@ ARGUMENTUM_INLINE std::vector<std::string_view> Writer::splitIntoWords( std::str
    return words;
 }
 
+ARGUMENTUM_INLINE std::pair<size_t, size_t> Writer::findParagraphBreak(
+      std::string_view text, size_t start )
+{
+   // A delimiter matches `[ \t]*\n[ \t]*\n\s*`. It starts at the first
+   // newline that is followed by another newline with only spaces and tabs
+   // between them.
+   auto isBlank = []( char ch ) { return ch == ' ' || ch == '\t'; };
+
+   auto newline = text.find( '\n', start );
+   while ( newline != std::string_view::npos ) {
+      auto next = newline + 1;
+      while ( next < text.size() && isBlank( text[next] ) )
+         ++next;
+      if ( next < text.size() && text[next] == '\n' ) {
+         auto begin = newline;
+         while ( begin > start && isBlank( text[begin - 1] ) )
+            --begin;
+         auto end = next + 1;
+         while ( end < text.size() && detail::isWriterSpace( text[end] ) )
+            ++end;
+         return { begin, end };
+      }
+      newline = text.find( '\n', next );
+   }
+
+   return { std::string_view::npos, std::string_view::npos };
+}
+
 ARGUMENTUM_INLINE std::vector<std::string_view> Writer::splitIntoParagraphs( std::string_view text )
 {
-   auto rxParagraph = std::regex( "[ \t]*\n[ \t]*\n\\s*" );
    std::vector<std::string_view> paragraphs;
-
-   auto it = std::cregex_iterator( text.data(), text.data() + text.size(), rxParagraph );
-   auto iend = std::cregex_iterator();
    size_t lastPosition = 0;
-   for ( ; it != iend; ++it ) {
-      auto match = std::cmatch( *it );
-      if ( match.position() == 0 )
-         paragraphs.emplace_back();
-      else {
-         paragraphs.push_back( text.substr( lastPosition, match.position() - lastPosition ) );
-         paragraphs.emplace_back();
-      }
-      lastPosition = match.position() + match.length();
+   while ( lastPosition < text.size() ) {
+      auto [begin, end] = findParagraphBreak( text, lastPosition );
+      if ( begin == std::string_view::npos )
+         break;
+
+      if ( begin > 0 )
+         paragraphs.push_back( text.substr( lastPosition, begin - lastPosition ) );
+      paragraphs.emplace_back();
+      lastPosition = end;
    }
 
    if ( lastPosition < text.size() )
@@ -106,25 +202,75 @@ ARGUMENTUM_INLINE std::vector<std::string_view> Writer::splitIntoParagraphs( std
    return paragraphs;
 }
 
+ARGUMENTUM_INLINE size_t Writer::displayWidth( std::string_view text )
+{
+   size_t columns = 0;
+   size_t pos = 0;
+   while ( pos < text.size() ) {
+      auto lead = static_cast<unsigned char>( text[pos] );
+      if ( lead < 0x80 ) {
+         ++columns;
+         ++pos;
+         continue;
+      }
+
+      // Invalid sequences are counted as one column per byte.
+      size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+      std::uint32_t cp = length == 4 ? lead & 0x07u : length == 3 ? lead & 0x0Fu : lead & 0x1Fu;
+      size_t i = 1;
+      for ( ; i < length && pos + i < text.size(); ++i ) {
+         auto ch = static_cast<unsigned char>( text[pos + i] );
+         if ( ( ch & 0xC0 ) != 0x80 )
+            break;
+         cp = ( cp << 6 ) | ( ch & 0x3Fu );
+      }
+
+      if ( length == 1 || i < length ) {
+         ++columns;
+         ++pos;
+         continue;
+      }
+
+      columns += detail::codepointWidth( cp );
+      pos += length;
+   }
+
+   return columns;
+}
+
 ARGUMENTUM_INLINE void Writer::write_paragraph( std::string_view text )
 {
-   auto words = splitIntoWords( text );
-   for ( auto word : words ) {
-      auto newpos = position + ( position == 0 ? indent.size() : 1 ) + word.size();
+   size_t pos = 0;
+   while ( pos < text.size() ) {
+      while ( pos < text.size() && detail::isWriterSpace( text[pos] ) )
+         ++pos;
+
+      size_t end = pos;
+      while ( end < text.size() && !detail::isWriterSpace( text[end] ) )
+         ++end;
+
+      if ( end == pos )
+         break;
+
+      auto word = text.substr( pos, end - pos );
+      pos = end;
+
+      auto wordWidth = displayWidth( word );
+      auto newpos = position + ( position == 0 ? indent.size() : 1 ) + wordWidth;
       if ( newpos > width )
          startLine();
       else if ( position > 0 && position == lastWritePosition ) {
-         stream << " ";
+         buffer.push_back( ' ' );
          ++position;
       }
 
       if ( position == 0 && indent.size() > 0 ) {
-         stream << indent;
+         buffer.append( indent );
          position = indent.size();
       }
 
-      stream.write( word.data(), word.size() );
-      position += word.size();
+      buffer.append( word );
+      position += wordWidth;
       lastWritePosition = position;
    }
 }
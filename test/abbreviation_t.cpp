@@ -0,0 +1,117 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct AbbrevOptions
+{
+   bool verbose = false;
+   bool version = false;
+   std::optional<long> level;
+   std::optional<long> levelMax;
+
+   void define( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( verbose, "--verbose" );
+      params.add_parameter( version, "--version" );
+      params.add_parameter( level, "--level" ).nargs( 1 );
+      params.add_parameter( levelMax, "--level-max" ).nargs( 1 );
+   }
+};
+}   // namespace
+
+TEST( Abbreviation, shouldRejectAbbreviationsByDefault )
+{
+   AbbrevOptions opt;
+   auto parser = argument_parser{};
+   opt.define( parser );
+
+   auto res = parser.parse_args( { "--verb" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( UNKNOWN_OPTION, res.errors[0].errorCode );
+}
+
+TEST( Abbreviation, shouldAcceptUnambiguousPrefix )
+{
+   AbbrevOptions opt;
+   auto parser = argument_parser{};
+   parser.config().allow_abbrev();
+   opt.define( parser );
+
+   auto res = parser.parse_args( { "--verb", "--vers", "--level-m=5" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( opt.verbose );
+   EXPECT_TRUE( opt.version );
+   EXPECT_FALSE( opt.level.has_value() );
+   EXPECT_EQ( 5, opt.levelMax.value_or( 0 ) );
+}
+
+TEST( Abbreviation, shouldPreferExactMatch )
+{
+   AbbrevOptions opt;
+   auto parser = argument_parser{};
+   parser.config().allow_abbrev();
+   opt.define( parser );
+
+   auto res = parser.parse_args( { "--level", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, opt.level.value_or( 0 ) );
+   EXPECT_FALSE( opt.levelMax.has_value() );
+}
+
+TEST( Abbreviation, shouldReportAmbiguousPrefixWithCandidates )
+{
+   AbbrevOptions opt;
+   std::stringstream out;
+   auto parser = argument_parser{};
+   parser.config().allow_abbrev().cout( out );
+   opt.define( parser );
+
+   auto res = parser.parse_args( { "--ver" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( AMBIGUOUS_OPTION, res.errors[0].errorCode );
+   EXPECT_EQ( "--ver", res.errors[0].option );
+   EXPECT_TRUE( vector_eq( { "--verbose", "--version" }, res.errors[0].candidates ) );
+   EXPECT_NE( std::string::npos,
+         out.str().find( "Ambiguous option: '--ver' could match --verbose, --version" ) );
+}
+
+TEST( Abbreviation, shouldAbbreviateHelpAndCommandOptions )
+{
+   class Cmd : public CommandOptions
+   {
+   public:
+      std::optional<std::string> target;
+      using CommandOptions::CommandOptions;
+      void add_parameters( ParameterConfig& params ) override
+      {
+         params.add_parameter( target, "--target" ).nargs( 1 );
+      }
+   };
+
+   std::stringstream out;
+   auto parser = argument_parser{};
+   parser.config().allow_abbrev().cout( out );
+   auto pCmd = std::make_shared<Cmd>( "cmd" );
+   parser.params().add_command( pCmd );
+
+   auto res = parser.parse_args( { "cmd", "--tar", "x" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "x", pCmd->target.value_or( "" ) );
+
+   res = parser.parse_args( { "--he" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_TRUE( res.help_was_shown() );
+}
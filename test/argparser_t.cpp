@@ -247,6 +247,48 @@ TEST( ArgumentParserTest, shouldStorePositionalArgumentsInValues )
    EXPECT_TRUE( vector_eq( { "one", "two", "three" }, strings ) );
 }
 
+TEST( ArgumentParserTest, shouldReserveSpaceForAllPositionalValues )
+{
+   std::vector<std::string> strings;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( strings, "text" ).minargs( 0 );
+
+   std::vector<std::string> args;
+   for ( int i = 0; i < 100; ++i )
+      args.push_back( std::to_string( i ) );
+   auto res = parser.parse_args( args );
+
+   EXPECT_TRUE( res );
+   EXPECT_EQ( 100, strings.size() );
+   EXPECT_EQ( 100, strings.capacity() );
+}
+
+TEST( ArgumentParserTest, shouldReserveSpaceForOptionValuesUpToNextOption )
+{
+   std::vector<int> numbers;
+   std::optional<std::vector<int>> optNumbers;
+   bool flag = false;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "--numbers" ).maxargs( 3 );
+   params.add_parameter( optNumbers, "--optional" );
+   params.add_parameter( flag, "--flag" ).nargs( 0 );
+
+   auto res = parser.parse_args(
+         { "--numbers", "1", "2", "3", "4", "--optional", "5", "-6", "7", "--flag" } );
+
+   EXPECT_FALSE( res );
+   EXPECT_TRUE( vector_eq( { 1, 2, 3 }, numbers ) );
+   EXPECT_EQ( 3, numbers.capacity() );
+   ASSERT_TRUE( optNumbers.has_value() );
+   EXPECT_TRUE( vector_eq( { 5, -6, 7 }, *optNumbers ) );
+   EXPECT_EQ( 3, optNumbers->capacity() );
+   EXPECT_TRUE( flag );
+}
+
 TEST( ArgumentParserTest, shouldIgnoreOptionalPositionalArguments )
 {
    std::vector<std::string> text;
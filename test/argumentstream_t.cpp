@@ -4,6 +4,7 @@
 #include <argumentum/argparse.h>
 
 #include <gtest/gtest.h>
+#include <sstream>
 
 using namespace argumentum;
 
@@ -67,3 +68,77 @@ TEST( ArgumentStream, shouldCreateArgumentStreamFromStdStream )
    EXPECT_EQ( "two", res[1] );
    EXPECT_EQ( "three", res[2] );
 }
+
+TEST( ArgumentStream, shouldExposeIteratorArgumentsInWindow )
+{
+   std::vector<std::string> args{ "one", "two", "three" };
+
+   IteratorArgumentStream stream( args.begin(), args.end() );
+   EXPECT_EQ( "one", stream.next() );
+
+   auto window = stream.window();
+   ASSERT_EQ( 2, window.size() );
+   EXPECT_EQ( "two", window[0] );
+   EXPECT_EQ( "three", window[1] );
+
+   stream.advance( 1 );
+   EXPECT_EQ( "three", stream.next() );
+   EXPECT_TRUE( stream.window().empty() );
+   EXPECT_FALSE( stream.next().has_value() );
+}
+
+TEST( ArgumentStream, shouldReadContiguousArguments )
+{
+   std::vector<std::string_view> args{ "one", "two", "three" };
+   auto pArgs = args.data();
+
+   ContiguousArgumentStream stream( pArgs, pArgs + args.size() );
+   EXPECT_EQ( 3, stream.window().size() );
+   stream.advance( 2 );
+   EXPECT_EQ( pArgs + 2, stream.window().begin() );
+   stream.advance( 5 );
+   EXPECT_TRUE( stream.window().empty() );
+   EXPECT_FALSE( stream.next().has_value() );
+}
+
+// The arguments from a stream without windows are parsed like the arguments
+// from a contiguous stream.
+TEST( ArgumentStream, shouldParseStreamsWithAndWithoutWindows )
+{
+   std::vector<std::string> args{ "--items", "a", "-1", "b", "--count", "3" };
+   auto parse = [&]( ArgumentStream& stream ) {
+      std::vector<std::string> items;
+      long count = 0;
+      auto parser = argument_parser{};
+      auto params = parser.params();
+      params.add_parameter( items, "--items" ).minargs( 1 );
+      params.add_parameter( count, "--count" ).nargs( 1 );
+
+      auto res = parser.parse_args( stream );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_EQ( 3, count );
+      return items;
+   };
+
+   IteratorArgumentStream contiguous( args.begin(), args.end() );
+   std::stringstream text;
+   for ( auto& arg : args )
+      text << arg << "\n";
+   StdStreamArgumentStream lines( std::make_shared<std::stringstream>( text.str() ) );
+
+   auto expected = std::vector<std::string>{ "a", "-1", "b" };
+   EXPECT_EQ( expected, parse( contiguous ) );
+   EXPECT_EQ( expected, parse( lines ) );
+}
+
+TEST( ArgumentStream, shouldParseArgumentsFromArgv )
+{
+   std::vector<std::string> items;
+   auto parser = argument_parser{};
+   parser.params().add_parameter( items, "--items" ).minargs( 1 );
+
+   const char* argv[] = { "program", "--items", "a", "b" };
+   auto res = parser.parse_args( 4, const_cast<char**>( argv ) );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( ( std::vector<std::string>{ "a", "b" } ), items );
+}
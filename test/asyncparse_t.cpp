@@ -0,0 +1,281 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+#include <argumentum/asyncparse.h>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <poll.h>
+#include <sstream>
+#include <unistd.h>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+
+// A minimal single-threaded event loop that resumes the coroutines waiting on
+// file descriptors.
+class EventLoop
+{
+   std::map<int, std::coroutine_handle<>> mWaiting;
+
+public:
+   void waitReadable( int fd, std::coroutine_handle<> handle )
+   {
+      mWaiting[fd] = handle;
+   }
+
+   bool hasWaiting() const
+   {
+      return !mWaiting.empty();
+   }
+
+   void runOnce()
+   {
+      std::vector<pollfd> fds;
+      for ( auto& [fd, handle] : mWaiting )
+         fds.push_back( pollfd{ fd, POLLIN, 0 } );
+
+      if ( ::poll( fds.data(), fds.size(), 0 ) <= 0 )
+         return;
+
+      for ( auto& pfd : fds ) {
+         if ( pfd.revents == 0 )
+            continue;
+         auto handle = mWaiting[pfd.fd];
+         mWaiting.erase( pfd.fd );
+         handle.resume();
+      }
+   }
+};
+
+// Reads one argument per line from a non-blocking file descriptor.
+class PipeArgumentStream : public AsyncArgumentStream
+{
+   int mFd;
+   EventLoop& mLoop;
+   std::string mPending;
+
+public:
+   PipeArgumentStream( int fd, EventLoop& loop )
+      : mFd( fd )
+      , mLoop( loop )
+   {}
+
+   ~PipeArgumentStream()
+   {
+      ::close( mFd );
+   }
+
+   EReadResult read_batch( std::vector<std::string>& batch ) override
+   {
+      char buffer[256];
+      auto count = ::read( mFd, buffer, sizeof( buffer ) );
+      if ( count < 0 )
+         return wouldBlock;
+
+      if ( count == 0 ) {
+         if ( !mPending.empty() )
+            batch.push_back( std::exchange( mPending, {} ) );
+         return batch.empty() ? endOfStream : batchReady;
+      }
+
+      for ( auto pc = buffer; pc != buffer + count; ++pc ) {
+         if ( *pc == '\n' )
+            batch.push_back( std::exchange( mPending, {} ) );
+         else
+            mPending.push_back( *pc );
+      }
+
+      return batch.empty() ? wouldBlock : batchReady;
+   }
+
+   void wait_readable( std::coroutine_handle<> handle ) override
+   {
+      mLoop.waitReadable( mFd, handle );
+   }
+};
+
+// Returns all the arguments in one batch.
+class ReadyArgumentStream : public AsyncArgumentStream
+{
+   std::vector<std::string> mArgs;
+
+public:
+   ReadyArgumentStream( std::vector<std::string> args )
+      : mArgs( std::move( args ) )
+   {}
+
+   EReadResult read_batch( std::vector<std::string>& batch ) override
+   {
+      if ( mArgs.empty() )
+         return endOfStream;
+      batch.insert( batch.end(), mArgs.begin(), mArgs.end() );
+      mArgs.clear();
+      return batchReady;
+   }
+
+   void wait_readable( std::coroutine_handle<> ) override
+   {}
+};
+
+struct PipeParse
+{
+   int writeFd = -1;
+   std::string input;
+   std::vector<long> values;
+   std::optional<std::string> name;
+   argument_parser parser;
+   std::unique_ptr<PipeArgumentStream> pStream;
+   std::optional<parse_task> task;
+};
+
+}   // namespace
+
+TEST( AsyncParse, shouldParseArgumentsFromManyPipesOnOneThread )
+{
+   const int parseCount = 300;
+   EventLoop loop;
+   std::vector<std::unique_ptr<PipeParse>> parses;
+
+   for ( int i = 0; i < parseCount; ++i ) {
+      auto pParse = std::make_unique<PipeParse>();
+      int fds[2];
+      ASSERT_EQ( 0, ::pipe( fds ) );
+      ::fcntl( fds[0], F_SETFL, O_NONBLOCK );
+      pParse->writeFd = fds[1];
+      pParse->pStream = std::make_unique<PipeArgumentStream>( fds[0], loop );
+      pParse->input = "--name\nparse-" + std::to_string( i ) + "\n--values\n";
+      for ( int k = 0; k < 5; ++k )
+         pParse->input += std::to_string( i + k ) + "\n";
+
+      auto params = pParse->parser.params();
+      params.add_parameter( pParse->values, "--values" ).minargs( 1 );
+      params.add_parameter( pParse->name, "--name" ).nargs( 1 );
+
+      pParse->task.emplace( async_parse_args( pParse->parser, *pParse->pStream ) );
+      parses.push_back( std::move( pParse ) );
+   }
+
+   // All the parses are waiting for input.
+   for ( auto& pParse : parses )
+      EXPECT_FALSE( pParse->task->done() );
+
+   // Write the input in small chunks to all the pipes in turn so that every
+   // parse is suspended many times.
+   const size_t chunkSize = 3;
+   bool writing = true;
+   for ( size_t pos = 0; writing; pos += chunkSize ) {
+      writing = false;
+      for ( auto& pParse : parses ) {
+         if ( pParse->writeFd < 0 )
+            continue;
+         if ( pos < pParse->input.size() ) {
+            auto chunk = pParse->input.substr( pos, chunkSize );
+            ASSERT_EQ( ssize_t( chunk.size() ), ::write( pParse->writeFd, chunk.data(), chunk.size() ) );
+            writing = true;
+         }
+         else {
+            ::close( pParse->writeFd );
+            pParse->writeFd = -1;
+         }
+      }
+      loop.runOnce();
+   }
+
+   while ( loop.hasWaiting() )
+      loop.runOnce();
+
+   for ( int i = 0; i < parseCount; ++i ) {
+      auto& parse = *parses[i];
+      ASSERT_TRUE( parse.task->done() );
+      auto res = parse.task->result();
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_EQ( "parse-" + std::to_string( i ), parse.name.value_or( "" ) );
+      EXPECT_TRUE( vector_eq( { i, i + 1, i + 2, i + 3, i + 4 }, parse.values ) );
+   }
+}
+
+TEST( AsyncParse, shouldResumeAwaitingCoroutineWhenParseFinishes )
+{
+   EventLoop loop;
+   int fds[2];
+   ASSERT_EQ( 0, ::pipe( fds ) );
+   ::fcntl( fds[0], F_SETFL, O_NONBLOCK );
+   auto stream = PipeArgumentStream( fds[0], loop );
+
+   std::optional<std::string> name;
+   auto parser = argument_parser{};
+   parser.params().add_parameter( name, "--name" ).nargs( 1 );
+
+   struct Detached
+   {
+      struct promise_type
+      {
+         Detached get_return_object()
+         {
+            return {};
+         }
+         std::suspend_never initial_suspend() noexcept
+         {
+            return {};
+         }
+         std::suspend_never final_suspend() noexcept
+         {
+            return {};
+         }
+         void return_void()
+         {}
+         void unhandled_exception()
+         {
+            std::terminate();
+         }
+      };
+   };
+
+   bool checked = false;
+   auto runParse = [&]() -> Detached {
+      auto res = co_await async_parse_args( parser, stream );
+      checked = static_cast<bool>( res );
+   };
+   runParse();
+   EXPECT_FALSE( checked );
+
+   std::string input = "--name\nasync";
+   ASSERT_EQ( ssize_t( input.size() ), ::write( fds[1], input.data(), input.size() ) );
+   ::close( fds[1] );
+   while ( loop.hasWaiting() )
+      loop.runOnce();
+
+   EXPECT_TRUE( checked );
+   EXPECT_EQ( "async", name.value_or( "" ) );
+}
+
+TEST( AsyncParse, shouldRequireCheckOnlyForTakenResult )
+{
+   std::stringstream output;
+   std::optional<std::string> name;
+   auto parser = argument_parser{};
+   parser.config().cout( output );
+   parser.params().add_parameter( name, "--name" ).nargs( 1 );
+
+   // The failed result of an abandoned task is never seen by the user.
+   {
+      auto stream = ReadyArgumentStream( { "--name", "first", "--unknown" } );
+      auto task = async_parse_args( parser, stream );
+      EXPECT_TRUE( task.done() );
+   }
+   EXPECT_EQ( "first", name.value_or( "" ) );
+
+   auto stream = ReadyArgumentStream( { "--name", "second", "--unknown" } );
+   auto task = async_parse_args( parser, stream );
+   ASSERT_TRUE( task.done() );
+   EXPECT_THROW( task.result(), UncheckedParseResult );
+   EXPECT_EQ( "second", name.value_or( "" ) );
+}
@@ -90,6 +90,28 @@ TEST( ArgumentParserCommand, shouldHandleCommandsWithSubparsers )
    EXPECT_EQ( nullptr, pCmdTwo );
 }
 
+TEST( ArgumentParserCommand, shouldCreateCommandOptionsWithFactory )
+{
+   std::vector<std::string> created;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   auto factory = [&created]( std::string_view name ) {
+      created.emplace_back( name );
+      return std::make_shared<CmdOneOptions>( name );
+   };
+   params.add_command( "one", factory );
+   params.add_command( "two", factory );
+
+   auto res = parser.parse_args( { "two", "-s", "works" } );
+
+   EXPECT_TRUE( res.errors.empty() );
+   ASSERT_EQ( 1, created.size() );
+   EXPECT_EQ( "two", created[0] );
+   auto pCmdTwo = findCommand<CmdOneOptions>( res, "two" );
+   ASSERT_NE( nullptr, pCmdTwo );
+   EXPECT_EQ( "works", pCmdTwo->str.value_or( "" ) );
+}
+
 // Form: program --global-options command --command-options
 TEST( ArgumentParserCommand, shouldHandleGlobalOptionsWhenCommandsPresent )
 {
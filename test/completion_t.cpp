@@ -0,0 +1,146 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+
+namespace {
+class BuildOptions : public argumentum::CommandOptions
+{
+public:
+   std::optional<std::string> target;
+   std::optional<std::string> mode;
+   bool clean = false;
+   static int created;
+
+   BuildOptions( std::string_view name )
+      : CommandOptions( name )
+   {
+      ++created;
+   }
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( target, "--target", "-t" ).nargs( 1 ).help( "The target to build." );
+      params.add_parameter( mode, "--mode" ).nargs( 1 ).choices( { "debug", "release", "dev" } );
+      params.add_parameter( clean, "--clean" );
+   }
+};
+
+int BuildOptions::created = 0;
+
+struct CompletionFixture
+{
+   bool verbose = false;
+   std::optional<std::string> color;
+   std::optional<std::string> action;
+   argument_parser parser;
+
+   CompletionFixture()
+   {
+      auto params = parser.params();
+      params.add_parameter( verbose, "--verbose", "-v" ).help( "Print more.\nAnd more." );
+      params.add_parameter( color, "--color" ).nargs( 1 ).choices( { "auto", "always", "never" } );
+      params.add_parameter( action, "action" ).nargs( 1 ).required( false ).choices(
+            { "start", "stop" } );
+      params.add_command<BuildOptions>( "build" ).help( "Build a target." );
+      params.add_command<BuildOptions>( "bundle" ).help( "Bundle the targets." );
+   }
+};
+
+std::vector<std::string> values( const std::vector<completion_candidate>& candidates )
+{
+   std::vector<std::string> res;
+   for ( auto& c : candidates )
+      res.push_back( c.value );
+   return res;
+}
+
+using strings = std::vector<std::string>;
+}   // namespace
+
+TEST( Completion, shouldCompleteOptionNamesByPrefix )
+{
+   CompletionFixture fixture;
+   auto engine = completion_engine( fixture.parser );
+
+   EXPECT_EQ( strings( { "--verbose" } ), values( engine.complete( { "--v" }, 0 ) ) );
+   EXPECT_EQ( strings( { "--color", "--help", "--verbose", "-h", "-v" } ),
+         values( engine.complete( { "-" }, 0 ) ) );
+   EXPECT_TRUE( engine.complete( { "--x" }, 0 ).empty() );
+}
+
+TEST( Completion, shouldCompleteCommandsAndPositionalChoices )
+{
+   CompletionFixture fixture;
+   auto engine = completion_engine( fixture.parser );
+
+   EXPECT_EQ( strings( { "build", "bundle" } ), values( engine.complete( { "b" }, 0 ) ) );
+   EXPECT_EQ( strings( { "build", "bundle", "start", "stop" } ),
+         values( engine.complete( { "-v" }, 1 ) ) );
+   EXPECT_EQ( strings( { "stop" } ), values( engine.complete( { "sto" }, 0 ) ) );
+}
+
+TEST( Completion, shouldCompleteChoicesOfActiveOption )
+{
+   CompletionFixture fixture;
+   auto engine = completion_engine( fixture.parser );
+
+   EXPECT_EQ( strings( { "always", "auto" } ), values( engine.complete( { "--color", "a" }, 1 ) ) );
+   EXPECT_EQ(
+         strings( { "--color=never" } ), values( engine.complete( { "-v", "--color=n" }, 1 ) ) );
+
+   // The option needs a value so the commands are not offered.
+   EXPECT_EQ( strings( { "always", "auto", "never" } ),
+         values( engine.complete( { "--color" }, 1 ) ) );
+}
+
+TEST( Completion, shouldResolveCommandPathLazily )
+{
+   BuildOptions::created = 0;
+   CompletionFixture fixture;
+   auto engine = completion_engine( fixture.parser );
+
+   EXPECT_EQ( strings( { "--clean" } ), values( engine.complete( { "-v", "build", "--c" }, 2 ) ) );
+   EXPECT_EQ( strings( { "debug", "dev" } ),
+         values( engine.complete( { "build", "-t", "x", "--mode", "d" }, 4 ) ) );
+   EXPECT_EQ( 1, BuildOptions::created );
+
+   // The options of the parent parser are not completed in a command.
+   EXPECT_TRUE( engine.complete( { "build", "--v" }, 1 ).empty() );
+}
+
+TEST( Completion, shouldSplitCommandLine )
+{
+   CompletionFixture fixture;
+   auto engine = completion_engine( fixture.parser );
+
+   EXPECT_EQ( strings( { "--clean" } ), values( engine.complete_line( "prog 'build' --cl", 17 ) ) );
+   EXPECT_EQ( strings( { "build", "bundle", "start", "stop" } ),
+         values( engine.complete_line( "prog --verbose ", 15 ) ) );
+   EXPECT_EQ( strings( { "--verbose" } ), values( engine.complete_line( "prog --verb tail", 11 ) ) );
+}
+
+TEST( Completion, shouldWriteShellProtocols )
+{
+   std::vector<completion_candidate> candidates = {
+      { "--verbose", "Print more.\nAnd more.", completion_candidate::option },
+      { "a:b", "", completion_candidate::choice },
+   };
+
+   std::stringstream bash;
+   completion_engine::write_candidates( bash, candidates, ECompletionShell::bash );
+   EXPECT_EQ( "--verbose\na:b\n", bash.str() );
+
+   std::stringstream zsh;
+   completion_engine::write_candidates( zsh, candidates, ECompletionShell::zsh );
+   EXPECT_EQ( "--verbose:Print more.\na\\:b\n", zsh.str() );
+
+   std::stringstream fish;
+   completion_engine::write_candidates( fish, candidates, ECompletionShell::fish );
+   EXPECT_EQ( "--verbose\tPrint more.\na:b\n", fish.str() );
+}
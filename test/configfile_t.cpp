@@ -0,0 +1,247 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "testutil.h"
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+using namespace testutil;
+
+namespace {
+struct ConfigFile
+{
+   std::string path;
+   config_file file;
+
+   ConfigFile( const std::string& name, const std::string& content )
+      : path( "argumentum-" + name + ".ini" )
+   {
+      std::ofstream( path, std::ios::binary ) << content;
+      file.open( path );
+   }
+
+   ~ConfigFile()
+   {
+      file = config_file{};
+      std::remove( path.c_str() );
+   }
+};
+
+struct ConfigOptions
+{
+   std::string name;
+   long count = 0;
+   bool verbose = false;
+   std::vector<std::string> paths;
+   std::string color;
+
+   void add( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( name, "--name" ).nargs( 1 );
+      params.add_parameter( count, "--count" ).nargs( 1 );
+      params.add_parameter( verbose, "--verbose", "-v" );
+      params.add_parameter( paths, "--path" ).minargs( 1 );
+      params.add_group( "style" );
+      params.add_parameter( color, "--color" ).nargs( 1 );
+      params.end_group();
+   }
+};
+
+struct BuildOptions : public argumentum::CommandOptions
+{
+   std::string target;
+   std::string color;
+
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( target, "--target" ).nargs( 1 );
+      params.add_group( "style" );
+      params.add_parameter( color, "--color" ).nargs( 1 );
+   }
+};
+
+struct TestOptions : public argumentum::CommandOptions
+{
+   std::string target;
+
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( target, "--target" ).nargs( 1 );
+   }
+};
+
+ParseResult parse( argument_parser& parser, const config_file& file,
+      std::vector<std::string> args = {} )
+{
+   auto parse = parser.begin_parse();
+   parse.feed( file );
+   parse.feed( args.begin(), args.end() );
+   return parse.finish();
+}
+
+std::string describeErrors( ParseResult& result )
+{
+   std::stringstream strout;
+   for ( auto& error : result.errors )
+      strout << error.source << " " << error.option << " " << error.errorCode << "\n";
+   return strout.str();
+}
+}   // namespace
+
+TEST( ConfigFile, shouldIndexEntriesAndSkipComments )
+{
+   auto config = ConfigFile( "index",
+         "# comment\n"
+         "; comment\n"
+         "name = first\n"
+         "  count=3  \n"
+         "\n"
+         "[style]\n"
+         "color = \"dark red\"\n"
+         "verbose\r\n" );
+
+   auto& entries = config.file.entries();
+   ASSERT_EQ( 4, entries.size() );
+   EXPECT_EQ( "name", entries[0].key );
+   EXPECT_EQ( "first", entries[0].value );
+   EXPECT_EQ( 3, entries[0].line );
+   EXPECT_EQ( "count", entries[1].key );
+   EXPECT_EQ( "3", entries[1].value );
+   EXPECT_EQ( "style", entries[2].section );
+   EXPECT_EQ( 6, entries[2].sectionLine );
+   EXPECT_EQ( "dark red", entries[2].value );
+   EXPECT_EQ( "verbose", entries[3].key );
+   EXPECT_FALSE( entries[3].hasValue );
+   EXPECT_EQ( config.path + ":7", config.file.location( entries[2].line ) );
+}
+
+TEST( ConfigFile, shouldAssignValuesFromConfigFile )
+{
+   auto config = ConfigFile( "assign",
+         "name = first\n"
+         "count = 3\n"
+         "verbose\n"
+         "path = a\n"
+         "path = b\n"
+         "[style]\n"
+         "color = red\n" );
+
+   ConfigOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, config.file );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "first", opt.name );
+   EXPECT_EQ( 3, opt.count );
+   EXPECT_TRUE( opt.verbose );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, opt.paths ) );
+   EXPECT_EQ( "red", opt.color );
+}
+
+TEST( ConfigFile, shouldPreferInputArgumentsOverConfigFile )
+{
+   auto config = ConfigFile( "precedence",
+         "name = first\n"
+         "path = a\n"
+         "path = b\n"
+         "verbose = no\n" );
+
+   ConfigOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, config.file, { "--path", "c", "--count", "2" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "first", opt.name );
+   EXPECT_EQ( 2, opt.count );
+   EXPECT_FALSE( opt.verbose );
+   EXPECT_TRUE( vector_eq( { "c" }, opt.paths ) );
+}
+
+TEST( ConfigFile, shouldReadCommandValuesFromCommandSection )
+{
+   auto config = ConfigFile( "command",
+         "name = global\n"
+         "[build]\n"
+         "target = release\n"
+         "[build.style]\n"
+         "color = blue\n"
+         "[test]\n"
+         "target = unit\n" );
+
+   std::string name;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( name, "--name" ).nargs( 1 );
+   params.add_command<BuildOptions>( "build" );
+   params.add_command<TestOptions>( "test" );
+
+   auto res = parse( parser, config.file, { "build" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "global", name );
+
+   auto pBuild = findCommand<BuildOptions>( res, "build" );
+   ASSERT_NE( nullptr, pBuild );
+   EXPECT_EQ( "release", pBuild->target );
+   EXPECT_EQ( "blue", pBuild->color );
+   EXPECT_EQ( nullptr, findCommand<TestOptions>( res, "test" ) );
+}
+
+TEST( ConfigFile, shouldReportErrorsWithFileAndLine )
+{
+   auto config = ConfigFile( "errors",
+         "name = first\n"
+         "unknown = 1\n"
+         "count = many\n"
+         "this line is invalid\n"
+         "[nosuchsection]\n"
+         "name = second\n"
+         "color = red\n" );
+
+   ConfigOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, config.file );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+
+   auto prefix = config.path + ":";
+   EXPECT_EQ( prefix + "4 this line is invalid " + std::to_string( INVALID_CONFIG ) + "\n"
+               + prefix + "2 unknown " + std::to_string( UNKNOWN_OPTION ) + "\n"
+               + prefix + "5 [nosuchsection] " + std::to_string( UNKNOWN_OPTION ) + "\n"
+               + prefix + "3 --count " + std::to_string( CONVERSION_ERROR ) + "\n",
+         describeErrors( res ) );
+}
+
+TEST( ConfigFile, shouldRejectOptionsOutsideOfSectionGroup )
+{
+   auto config = ConfigFile( "group",
+         "[style]\n"
+         "name = first\n"
+         "color = red\n" );
+
+   ConfigOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, config.file );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_EQ( config.path + ":2 name " + std::to_string( UNKNOWN_OPTION ) + "\n",
+         describeErrors( res ) );
+   EXPECT_EQ( "", opt.name );
+   EXPECT_EQ( "red", opt.color );
+}
@@ -6,7 +6,10 @@
 #include <argumentum/argparse.h>
 
 #include <algorithm>
+#include <charconv>
 #include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
 
 using namespace argumentum;
 using namespace testing;
@@ -173,6 +176,108 @@ TEST( ArgumentParserConvertTest, shouldSupportVectorOfCustomTypesWith_from_strin
    EXPECT_EQ( "rotas", custom[1].reversed );
 }
 
+namespace {
+struct HexId_view_test
+{
+   unsigned long long id = 0;
+};
+
+enum class EColor_view_test { red, green };
+
+// Has both conversions; the one with string_view must be used.
+struct Tagged_view_test
+{
+   std::string value;
+   bool fromView = false;
+};
+}   // namespace
+
+namespace argumentum {
+template<>
+struct from_string<HexId_view_test>
+{
+   static std::optional<HexId_view_test> convert( std::string_view s )
+   {
+      HexId_view_test hexId;
+      auto [ptr, ec] = std::from_chars( s.data(), s.data() + s.size(), hexId.id, 16 );
+      if ( ec != std::errc{} || ptr != s.data() + s.size() )
+         return {};
+      return hexId;
+   }
+};
+
+template<>
+struct from_string<EColor_view_test>
+{
+   static ConversionResult<EColor_view_test> convert( std::string_view s )
+   {
+      if ( s == "red" )
+         return EColor_view_test::red;
+      if ( s == "green" )
+         return EColor_view_test::green;
+      return EConversionError::invalidValue;
+   }
+};
+
+template<>
+struct from_string<Tagged_view_test>
+{
+   static Tagged_view_test convert( const std::string& s )
+   {
+      return { s, false };
+   }
+
+   static Tagged_view_test convert( std::string_view s )
+   {
+      return { std::string{ s }, true };
+   }
+};
+}   // namespace argumentum
+
+TEST( ArgumentParserConvertTest, shouldSupportCustomTypesWith_from_string_view )
+{
+   HexId_view_test hexId;
+   std::vector<EColor_view_test> colors;
+   Tagged_view_test tagged;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( hexId, "--id" ).nargs( 1 );
+   params.add_parameter( colors, "--color" ).minargs( 1 );
+   params.add_parameter( tagged, "--tag" ).nargs( 1 );
+
+   auto res = parser.parse_args( { "--id", "ff10", "--color", "green", "red", "--tag", "t" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 0xff10, hexId.id );
+   ASSERT_EQ( 2, colors.size() );
+   EXPECT_EQ( EColor_view_test::green, colors[0] );
+   EXPECT_EQ( EColor_view_test::red, colors[1] );
+   EXPECT_EQ( "t", tagged.value );
+   EXPECT_TRUE( tagged.fromView );
+}
+
+TEST( ArgumentParserConvertTest, shouldReportErrorsFrom_from_string_view )
+{
+   HexId_view_test hexId;
+   std::vector<EColor_view_test> colors;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( hexId, "--id" ).nargs( 1 );
+   params.add_parameter( colors, "--color" ).minargs( 1 );
+
+   auto res = parser.parse_args( { "--id", "xyz", "--color", "green", "blue" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 2, res.errors.size() );
+   EXPECT_EQ( "--id", res.errors[0].option );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[0].errorCode );
+   EXPECT_EQ( "--color", res.errors[1].option );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[1].errorCode );
+   EXPECT_EQ( 0, hexId.id );
+   ASSERT_EQ( 1, colors.size() );
+   EXPECT_EQ( EColor_view_test::green, colors[0] );
+}
+
 TEST( ArgumentParserConvertTest, shouldSupportVectorOptions )
 {
    std::vector<std::string> strings;
@@ -346,3 +451,209 @@ TEST( ArgumentParserConvertTest, shouldConvertValuesWithStringConstructor )
 
    EXPECT_EQ( "Construct", construct.value );
 }
+
+TEST( ArgumentParserConvertTest, shouldSplitNumericListArguments )
+{
+   std::vector<int> ids;
+   std::vector<double> weights;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( ids, "--ids" ).split();
+   params.add_parameter( weights, "--weights" ).split( ':' );
+
+   auto res = parser.parse_args( { "--ids=1,-2,0x10", "--ids", "4,5", "--weights", "0.5:2:-1e3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { 1, -2, 16, 4, 5 }, ids ) );
+   EXPECT_TRUE( vector_eq( { 0.5, 2.0, -1e3 }, weights ) );
+}
+
+TEST( ArgumentParserConvertTest, shouldReportPositionOfInvalidListElement )
+{
+   std::vector<unsigned> ids;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( ids, "--ids" ).split();
+
+   auto res = parser.parse_args( { "--ids", "1,2,x3,4" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--ids[2]", res.errors[0].option );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[0].errorCode );
+
+   res = parser.parse_args( { "--ids", "1,,3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--ids[1]", res.errors[0].option );
+
+   res = parser.parse_args( { "--ids", "1,-3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--ids[1]", res.errors[0].option );
+}
+
+TEST( ArgumentParserConvertTest, shouldNotAppendPartOfInvalidList )
+{
+   std::vector<int> ids;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( ids, "--ids" ).split();
+
+   auto res = parser.parse_args( { "--ids", "1,2", "--ids", "3,x,5", "--ids", "6" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--ids[1]", res.errors[0].option );
+   EXPECT_TRUE( vector_eq( { 1, 2, 6 }, ids ) );
+
+   std::vector<long> values{ 7 };
+   EXPECT_EQ( 2, try_parse_list( "8,9,x", ',', values ).value_or( 0 ) );
+   EXPECT_TRUE( vector_eq( { 7 }, values ) );
+   EXPECT_THROW( parse_list( "x", ',', values ), ListElementError );
+   EXPECT_TRUE( vector_eq( { 7 }, values ) );
+}
+
+TEST( ArgumentParserConvertTest, shouldTreatEmptyListArgumentAsEmptyList )
+{
+   std::vector<int> ids;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( ids, "--ids" ).split();
+
+   auto res = parser.parse_args( { "--ids", "1", "--ids", "" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { 1 }, ids ) );
+
+   // An empty value after '=' is not an argument of the option.
+   res = parser.parse_args( { "--ids=" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( MISSING_ARGUMENT, res.errors[0].errorCode );
+   EXPECT_TRUE( ids.empty() );
+}
+
+TEST( ArgumentParserConvertTest, shouldNotCombineSplitWithAction )
+{
+   std::vector<int> ids;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   auto action = []( std::vector<int>&, const std::string& ) {};
+
+   EXPECT_THROW( params.add_parameter( ids, "--ids" ).split().action( action ),
+         std::invalid_argument );
+   EXPECT_THROW( params.add_parameter( ids, "--other" ).action( action ).split(),
+         std::invalid_argument );
+}
+
+TEST( ArgumentParserConvertTest, shouldParseNumbersWithoutAllocation )
+{
+   int i = 0;
+   EXPECT_TRUE( parse_number( "123", i ) );
+   EXPECT_EQ( 123, i );
+   EXPECT_TRUE( parse_number( "0b101", i ) );
+   EXPECT_EQ( 5, i );
+   EXPECT_FALSE( parse_number( "12a", i ) );
+   EXPECT_FALSE( parse_number( "", i ) );
+   EXPECT_FALSE( parse_number( "99999999999", i ) );
+   EXPECT_TRUE( parse_number( "--0x10", i ) );
+   EXPECT_EQ( 16, i );
+   EXPECT_TRUE( parse_number( "-0x80000000", i ) );
+   EXPECT_EQ( std::numeric_limits<int>::min(), i );
+   EXPECT_FALSE( parse_number( "0x1g", i ) );
+
+   float f = 0;
+   EXPECT_TRUE( parse_number( "2.5", f ) );
+   EXPECT_EQ( 2.5, f );
+   EXPECT_FALSE( parse_number( "1e100", f ) );
+   EXPECT_TRUE( parse_number( "0d-1.5", f ) );
+   EXPECT_FALSE( parse_number( "1.5x", f ) );
+}
+
+TEST( ArgumentParserConvertTest, shouldConvertVectorValuesInParallel )
+{
+   std::vector<long> numbers;
+   std::vector<std::string> words;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" ).minargs( 0 ).parallel( 4 );
+   params.add_parameter( words, "--words" ).parallel();
+
+   std::vector<std::string> args;
+   for ( int i = 0; i < 20000; ++i )
+      args.push_back( std::to_string( i ) );
+   args.insert( args.begin() + 100, { "--words", "one", "two", "--" } );
+
+   auto res = parser.parse_args( args );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   ASSERT_EQ( 20000, numbers.size() );
+   for ( size_t i = 0; i < numbers.size(); ++i )
+      ASSERT_EQ( long( i ), numbers[i] );
+   EXPECT_TRUE( vector_eq( { "one", "two" }, words ) );
+}
+
+TEST( ArgumentParserConvertTest, shouldReuseWorkersAfterFailedParallelConversion )
+{
+   const size_t count = 40000;
+   auto failOn = [&]( size_t bad ) {
+      return convert_in_parallel( count, 4, [bad]( size_t i ) {
+         if ( i == bad )
+            throw std::logic_error( "failed" );
+         return i % 10000 != 5;
+      } );
+   };
+
+   EXPECT_THROW( failOn( 30000 ), std::logic_error );
+
+   // The conversions started from different threads share the workers.
+   std::vector<size_t> failed[2];
+   std::thread other( [&] { failed[0] = failOn( count ); } );
+   failed[1] = failOn( count );
+   other.join();
+   for ( auto& positions : failed )
+      EXPECT_EQ( std::vector<size_t>( { 5, 10005, 20005, 30005 } ), positions );
+}
+
+TEST( ArgumentParserConvertTest, shouldReportPositionsOfValuesThatFailedParallelConversion )
+{
+   std::vector<int> numbers;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "--numbers" ).parallel( 3 );
+
+   std::vector<std::string> args{ "--numbers" };
+   for ( int i = 0; i < 10000; ++i )
+      args.push_back( i == 17 || i == 9000 ? "bad" : std::to_string( i ) );
+
+   auto res = parser.parse_args( args );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 2, res.errors.size() );
+   EXPECT_EQ( "--numbers[17]", res.errors[0].option );
+   EXPECT_EQ( "--numbers[9000]", res.errors[1].option );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[1].errorCode );
+
+   ASSERT_EQ( 9998, numbers.size() );
+   EXPECT_EQ( 16, numbers[16] );
+   EXPECT_EQ( 18, numbers[17] );
+   EXPECT_EQ( 9001, numbers[8999] );
+}
+
+TEST( ArgumentParserConvertTest, shouldReportFailedParallelPositionsRelativeToOptionValues )
+{
+   std::vector<int> numbers;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "--numbers" ).minargs( 0 ).flagValue( "7" ).parallel( 2 );
+
+   // The flag value is assigned when the first option closes; it is not
+   // deferred.
+   auto res = parser.parse_args( { "--numbers", "--numbers", "1", "bad", "3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--numbers[2]", res.errors[0].option );
+   EXPECT_TRUE( vector_eq( { 7, 1, 3 }, numbers ) );
+}
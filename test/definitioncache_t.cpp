@@ -0,0 +1,244 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct CacheFile
+{
+   std::string path;
+
+   CacheFile( const std::string& name )
+      : path( "argumentum-" + name + ".cache" )
+   {
+      std::remove( path.c_str() );
+   }
+
+   ~CacheFile()
+   {
+      std::remove( path.c_str() );
+   }
+
+   bool exists() const
+   {
+      return std::ifstream( path ).good();
+   }
+
+   std::string content() const
+   {
+      std::ifstream file( path, std::ios::binary );
+      return { std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() };
+   }
+
+   bool contains( std::string_view text ) const
+   {
+      return content().find( text ) != std::string::npos;
+   }
+};
+
+struct CachedOptions
+{
+   std::optional<std::string> name;
+   std::vector<long> values;
+   bool verbose = false;
+   std::vector<std::string> files;
+};
+
+void defineOptions( argument_parser& parser, CachedOptions& opt, const std::string& helpSuffix )
+{
+   auto params = parser.params();
+   params.add_group( "main" ).title( "Main options" );
+   params.add_parameter( opt.name, "--name", "-n" ).nargs( 1 ).help( "The name" + helpSuffix );
+   params.add_parameter( opt.values, "--values" ).minargs( 1 ).metavar( "V" );
+   params.end_group();
+   params.add_parameter( opt.verbose, "-v" ).help( "Verbose" + helpSuffix );
+   params.add_parameter( opt.files, "files" ).minargs( 0 );
+}
+
+std::string getHelp( const argument_parser& parser, std::string_view name )
+{
+   return parser.describe_argument( name ).help;
+}
+}   // namespace
+
+TEST( DefinitionCache, shouldRestoreOptionMetadataFromCache )
+{
+   auto cache = CacheFile( "restore" );
+
+   {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema-1" );
+      defineOptions( parser, opt, "" );
+      auto res = parser.parse_args( { "-n", "first" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_TRUE( cache.exists() );
+   }
+
+   CachedOptions opt;
+   auto parser = argument_parser{};
+   parser.config().definition_cache( cache.path, "schema-1" );
+   defineOptions( parser, opt, "" );
+
+   auto res = parser.parse_args( { "--name", "second", "--values", "1", "2", "-v", "a", "b" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "second", opt.name.value_or( "" ) );
+   EXPECT_TRUE( vector_eq( { 1, 2 }, opt.values ) );
+   EXPECT_TRUE( opt.verbose );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, opt.files ) );
+
+   EXPECT_EQ( "The name", getHelp( parser, "--name" ) );
+   EXPECT_EQ( "Verbose", getHelp( parser, "-v" ) );
+
+   auto values = parser.describe_argument( "--values" );
+   EXPECT_TRUE( vector_eq( { "V" }, values.metavar ) );
+   EXPECT_EQ( "main", values.group.name );
+   EXPECT_EQ( "Main options", values.group.title );
+}
+
+TEST( DefinitionCache, shouldRebuildCacheWhenCachedOptionIsConfiguredDifferently )
+{
+   auto cache = CacheFile( "reconfigured" );
+
+   {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, "" );
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+   }
+
+   // The schema is the same but the options are configured differently so
+   // the new configuration is used and the cache is rewritten.
+   for ( int i = 0; i < 2; ++i ) {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      auto params = parser.params();
+      params.add_parameter( opt.name, "--name", "-n" ).nargs( 2 ).required().help( "Changed" );
+      params.add_parameter( opt.values, "--values" ).minargs( 1 ).metavar( "V" );
+      params.add_parameter( opt.verbose, "-v" ).help( "Verbose" );
+      params.add_parameter( opt.files, "files" ).minargs( 0 );
+
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_FALSE( static_cast<bool>( res ) );
+      EXPECT_EQ( "Changed", getHelp( parser, "--name" ) );
+      EXPECT_TRUE( parser.describe_argument( "--name" ).is_required() );
+
+      // With nargs( 1 ) the second value would be a positional argument.
+      res = parser.parse_args( { "-n", "a", "b" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_TRUE( opt.files.empty() );
+   }
+}
+
+TEST( DefinitionCache, shouldRebuildCacheWhenSchemaChanges )
+{
+   auto cache = CacheFile( "schema" );
+
+   for ( auto suffix : { "", " (v2)" } ) {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, std::string( "schema" ) + suffix );
+      defineOptions( parser, opt, suffix );
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_EQ( std::string( "Verbose" ) + suffix, getHelp( parser, "-v" ) );
+   }
+
+   EXPECT_TRUE( cache.contains( "Verbose (v2)" ) );
+}
+
+TEST( DefinitionCache, shouldRebuildStaleCache )
+{
+   auto cache = CacheFile( "stale" );
+
+   {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, "" );
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+   }
+
+   // An option that is not in the cache makes the cache stale.  It is defined
+   // without the cache and the cache is rewritten.  A different help of the
+   // cached option rewrites the cache again.
+   for ( auto help : { "Extra", "Changed" } ) {
+      CachedOptions opt;
+      std::optional<long> extra;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, "" );
+      parser.params().add_parameter( extra, "--extra" ).nargs( 1 ).help( help );
+
+      auto res = parser.parse_args( { "--extra", "5" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_EQ( 5, extra.value_or( 0 ) );
+      EXPECT_EQ( help, getHelp( parser, "--extra" ) );
+      EXPECT_TRUE( cache.contains( help ) );
+   }
+}
+
+TEST( DefinitionCache, shouldDetectDuplicateOptionsWithValidCache )
+{
+   auto cache = CacheFile( "duplicate" );
+
+   {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, "" );
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+   }
+
+   CachedOptions opt;
+   bool other = false;
+   auto parser = argument_parser{};
+   parser.config().definition_cache( cache.path, "schema" );
+   defineOptions( parser, opt, "" );
+   EXPECT_THROW( parser.params().add_parameter( other, "-v" ), DuplicateOption );
+}
+
+TEST( DefinitionCache, shouldIgnoreDamagedCache )
+{
+   auto cache = CacheFile( "damaged" );
+
+   {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, "" );
+      auto res = parser.parse_args( { "-v" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+   }
+
+   // Truncate the cache.
+   auto content = cache.content();
+   ASSERT_GT( content.size(), 100 );
+   std::ofstream( cache.path, std::ios::binary ).write( content.data(), content.size() - 10 );
+
+   for ( auto help : { " (new)", "" } ) {
+      CachedOptions opt;
+      auto parser = argument_parser{};
+      parser.config().definition_cache( cache.path, "schema" );
+      defineOptions( parser, opt, help );
+      auto res = parser.parse_args( { "--name", "x" } );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_EQ( "x", opt.name.value_or( "" ) );
+      EXPECT_EQ( std::string( "The name" ) + help, getHelp( parser, "--name" ) );
+      EXPECT_TRUE( cache.contains( "The name" + std::string( help ) ) );
+   }
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+// Set an environment variable for the duration of a test.
+class EnvVar
+{
+   std::string mName;
+
+public:
+   EnvVar( const std::string& name, const std::string& value )
+      : mName( name )
+   {
+#ifdef _WIN32
+      _putenv_s( mName.c_str(), value.c_str() );
+#else
+      setenv( mName.c_str(), value.c_str(), 1 );
+#endif
+   }
+
+   ~EnvVar()
+   {
+#ifdef _WIN32
+      _putenv_s( mName.c_str(), "" );
+#else
+      unsetenv( mName.c_str() );
+#endif
+   }
+};
+}   // namespace
+
+TEST( EnvironmentVariables, shouldReadValueFromNamedVariable )
+{
+   auto level = EnvVar( "ARGUMENTUM_TEST_LEVEL", "7" );
+   auto verbose = EnvVar( "ARGUMENTUM_TEST_VERBOSE", "yes" );
+
+   std::optional<long> value;
+   bool isVerbose = false;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( value, "--level" ).nargs( 1 ).env( "ARGUMENTUM_TEST_LEVEL" );
+   params.add_parameter( isVerbose, "-v" ).env( "ARGUMENTUM_TEST_VERBOSE" );
+
+   auto res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 7, value.value_or( 0 ) );
+   EXPECT_TRUE( isVerbose );
+}
+
+TEST( EnvironmentVariables, shouldPreferInputArguments )
+{
+   auto level = EnvVar( "ARGUMENTUM_TEST_LEVEL", "7" );
+
+   std::vector<long> values;
+   auto parser = argument_parser{};
+   parser.params().add_parameter( values, "--level" ).env( "ARGUMENTUM_TEST_LEVEL" );
+
+   auto res = parser.parse_args( { "--level", "1", "2" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { 1, 2 }, values ) );
+}
+
+TEST( EnvironmentVariables, shouldDeriveNamesFromPrefix )
+{
+   auto level = EnvVar( "ARGUMENTUM_T_LOG_LEVEL", "3" );
+   auto name = EnvVar( "ARGUMENTUM_OTHER_NAME", "other" );
+   auto quiet = EnvVar( "ARGUMENTUM_T_QUIET", "off" );
+
+   std::optional<long> logLevel;
+   std::optional<std::string> nameValue;
+   bool isQuiet = false;
+   auto parser = argument_parser{};
+   parser.config().env_prefix( "ARGUMENTUM_T_" );
+   auto params = parser.params();
+   params.add_parameter( logLevel, "--log-level" ).nargs( 1 );
+   params.add_parameter( nameValue, "--name" ).nargs( 1 ).env( "ARGUMENTUM_OTHER_NAME" );
+   params.add_parameter( isQuiet, "--quiet" );
+
+   auto res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, logLevel.value_or( 0 ) );
+   EXPECT_EQ( "other", nameValue.value_or( "" ) );
+   EXPECT_FALSE( isQuiet );
+}
+
+TEST( EnvironmentVariables, shouldCompareFlagValuesIgnoringCase )
+{
+   auto quiet = EnvVar( "ARGUMENTUM_T_QUIET", "FaLsE" );
+   auto verbose = EnvVar( "ARGUMENTUM_T_VERBOSE", "OFFICIAL" );
+   auto color = EnvVar( "ARGUMENTUM_T_COLOR", "No" );
+
+   bool isQuiet = false;
+   bool isVerbose = false;
+   bool hasColor = false;
+   auto parser = argument_parser{};
+   parser.config().env_prefix( "ARGUMENTUM_T_" );
+   auto params = parser.params();
+   params.add_parameter( isQuiet, "--quiet" );
+   params.add_parameter( isVerbose, "--verbose" );
+   params.add_parameter( hasColor, "--color" );
+
+   auto res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_FALSE( isQuiet );
+   EXPECT_TRUE( isVerbose );
+   EXPECT_FALSE( hasColor );
+}
+
+TEST( EnvironmentVariables, shouldNotBindHelpOptionsThroughPrefix )
+{
+   auto help = EnvVar( "ARGUMENTUM_T_HELP", "1" );
+   auto usage = EnvVar( "ARGUMENTUM_T_USAGE", "1" );
+
+   long value = 0;
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout ).env_prefix( "ARGUMENTUM_T_" );
+   auto params = parser.params();
+   params.add_parameter( value, "--value" ).nargs( 1 );
+   params.add_help_option( "--usage" );
+   params.add_default_help_option();
+
+   auto res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_FALSE( res.help_was_shown() );
+   EXPECT_EQ( "", strout.str() );
+}
+
+// A name set with env() has precedence over a name derived from the prefix
+// even when the option with the derived name is defined first.
+TEST( EnvironmentVariables, shouldPreferExplicitNamesOverDerivedNames )
+{
+   auto levelVar = EnvVar( "ARGUMENTUM_T_LEVEL", "3" );
+
+   std::optional<long> level;
+   std::optional<long> depth;
+   auto parser = argument_parser{};
+   parser.config().env_prefix( "ARGUMENTUM_T_" );
+   auto params = parser.params();
+   params.add_parameter( level, "--level" ).nargs( 1 );
+   params.add_parameter( depth, "--depth" ).nargs( 1 ).env( "ARGUMENTUM_T_LEVEL" );
+
+   auto res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_FALSE( level.has_value() );
+   EXPECT_EQ( 3, depth.value_or( 0 ) );
+}
+
+TEST( EnvironmentVariables, shouldSatisfyRequiredOptionAndReportConversionErrors )
+{
+   auto level = EnvVar( "ARGUMENTUM_TEST_LEVEL", "seven" );
+   auto name = EnvVar( "ARGUMENTUM_TEST_NAME", "x" );
+
+   std::optional<long> value;
+   std::optional<std::string> nameValue;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( value, "--level" ).nargs( 1 ).env( "ARGUMENTUM_TEST_LEVEL" );
+   params.add_parameter( nameValue, "--name" ).nargs( 1 ).required().env( "ARGUMENTUM_TEST_NAME" );
+
+   auto res = parser.parse_args( {} );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--level", res.errors[0].option );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[0].errorCode );
+   EXPECT_EQ( "x", nameValue.value_or( "" ) );
+}
+
+TEST( EnvironmentVariables, shouldNotSetOptionInAssignedExclusiveGroup )
+{
+   auto level = EnvVar( "ARGUMENTUM_TEST_FAST", "1" );
+
+   bool fast = false;
+   bool slow = false;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_exclusive_group( "speed" );
+   params.add_parameter( fast, "--fast" ).env( "ARGUMENTUM_TEST_FAST" );
+   params.add_parameter( slow, "--slow" );
+   params.end_group();
+
+   auto res = parser.parse_args( { "--slow" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( slow );
+   EXPECT_FALSE( fast );
+}
@@ -227,3 +227,87 @@ TEST( ArgumentParserGroupsTest, shouldNotAddDefaultHelpToGroupWhenHelpNotDefined
    EXPECT_TRUE( longInGroup.has_value() );
    EXPECT_FALSE( longInGroup.value_or( true ) );
 }
+
+TEST( ArgumentParserGroupsTest, shouldValidateGroupsWithMembersInManyWords )
+{
+   // The options of the groups are validated in words of 64 options.  The
+   // members of the groups are spread over multiple words.
+   std::vector<int> fillers( 200 );
+   int low, high, required;
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   parser.config().cout( strout );
+   for ( size_t i = 0; i < 60; ++i )
+      params.add_parameter( fillers[i], "--fill-" + std::to_string( i ) );
+   params.add_exclusive_group( "spread" );
+   params.add_parameter( low, "--low" );
+   params.end_group();
+   for ( size_t i = 60; i < 200; ++i )
+      params.add_parameter( fillers[i], "--fill-" + std::to_string( i ) );
+   params.add_exclusive_group( "spread" );
+   params.add_parameter( high, "--high" );
+   params.end_group();
+   params.add_parameter( required, "--required" ).required( true );
+
+   auto res = parser.parse_args( { "--high", "--low", "--fill-130" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 2, res.errors.size() );
+   EXPECT_EQ( "--required", res.errors[0].option );
+   EXPECT_EQ( MISSING_OPTION, res.errors[0].errorCode );
+   EXPECT_EQ( "--low", res.errors[1].option );
+   EXPECT_EQ( EXCLUSIVE_OPTION, res.errors[1].errorCode );
+
+   // The assignments of the previous parse are forgotten.
+   res = parser.parse_args( { "--high", "--required" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+}
+
+TEST( ArgumentParserGroupsTest, shouldSatisfyRequiredOptionThroughSharedTarget )
+{
+   int value;
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   parser.config().cout( strout );
+   params.add_parameter( value, "--value" ).nargs( 1 ).required( true );
+   params.add_parameter( value, "--alias" ).nargs( 1 );
+
+   auto res = parser.parse_args( { "--alias", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, value );
+}
+
+// The validator is rebuilt only when the definitions change after a parse.
+TEST( ArgumentParserGroupsTest, shouldValidateOptionsConfiguredBetweenParses )
+{
+   int first, second, third;
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   parser.config().cout( strout );
+   params.add_group( "ints" );
+   params.add_parameter( first, "--first" );
+   auto secondConfig = params.add_parameter( second, "--second" );
+   params.end_group();
+   auto thirdConfig = params.add_parameter( third, "--third" );
+
+   auto res = parser.parse_args( { "--first" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+
+   thirdConfig.required( true );
+   res = parser.parse_args( { "--first" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--third", res.errors[0].option );
+   EXPECT_EQ( MISSING_OPTION, res.errors[0].errorCode );
+
+   secondConfig.required( true );
+   res = parser.parse_args( { "--first", "--third" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--second", res.errors[0].option );
+}
@@ -64,6 +64,7 @@ TEST( WriterTest, shouldReformatText )
    Writer writer( strout, 27 );
 
    writer.write( text );
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -81,6 +82,7 @@ TEST( WriterIndentTest, shouldIndentFormattedText )
    writer.setIndent( 3 );
 
    writer.write( text );
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -104,6 +106,7 @@ TEST( WriterStartLineTest, shouldStartANewLine )
    writer.startLine();
    writer.write( "cccc" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -125,6 +128,7 @@ TEST( WriterStartLineTest, shouldNotStartANewLineAtBol )
    writer.startLine();
    writer.write( "cccc" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -143,6 +147,7 @@ TEST( WriterSkipToColumnTest, shouldSkipToRequestedColumn )
    writer.startLine();
    writer.write( "cccc" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -162,6 +167,7 @@ TEST( WriterSkipToColumnTest, shouldSkipToNewLineIfPastRequestedColumn )
    writer.startLine();
    writer.write( "cccc" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -181,6 +187,7 @@ TEST( WriterSkipToColumnTest, shouldContinueWritingIfAtRequestedColumn )
    writer.startLine();
    writer.write( "cccc" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written );
 
@@ -197,6 +204,7 @@ TEST( WriterParagraphTest, shouldStartParagraph )
    writer.startParagraph();
    writer.write( "bbbb" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written, EKeepEmpty::yes );
 
@@ -215,6 +223,7 @@ TEST( WriterParagraphTest, shouldStartParagraphWhenAtBol )
    writer.startParagraph();
    writer.write( "bbbb" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written, EKeepEmpty::yes );
 
@@ -235,6 +244,7 @@ TEST( WriterParagraphTest, shouldNotStartConsecutiveParagraphs )
    writer.startParagraph();
    writer.write( "bbbb" );
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written, EKeepEmpty::yes );
 
@@ -253,6 +263,7 @@ TEST( WriterParagraphTest, shouldStartParagraphWithoutNextWrite )
    writer.write( "bbbb" );
    writer.startParagraph();   // no write() after this
 
+   writer.flush();
    auto written = strout.str();
    auto lines = splitLines( written, EKeepEmpty::yes );
 
@@ -312,3 +323,56 @@ TEST( WriterInputParagraphTest, shouldRecognizeTrailingParagraphBreaks )
    EXPECT_EQ( "Paragraphs.", paras[2] );
    EXPECT_EQ( "", paras[3] );
 }
+
+TEST( WriterBufferTest, shouldWriteToStreamOnlyWhenFlushed )
+{
+   std::stringstream strout;
+   {
+      Writer writer( strout, 80 );
+      writer.write( "aaaa" );
+      writer.startLine();
+      EXPECT_EQ( "", strout.str() );
+
+      writer.flush();
+      EXPECT_EQ( "aaaa\n", strout.str() );
+
+      writer.write( "bbbb" );
+   }
+
+   EXPECT_EQ( "aaaa\nbbbb", strout.str() );
+}
+
+TEST( WriterUtf8Test, shouldMeasureDisplayWidthOfUtf8Text )
+{
+   EXPECT_EQ( 4, Writer::displayWidth( "abcd" ) );
+   EXPECT_EQ( 5, Writer::displayWidth( "čšžćđ" ) );
+   EXPECT_EQ( 1, Writer::displayWidth( "e\xcc\x81" ) );     // e + combining acute accent
+   EXPECT_EQ( 4, Writer::displayWidth( "日本" ) );
+   EXPECT_EQ( 2, Writer::displayWidth( "\xff\xc4" ) );     // invalid sequences
+}
+
+TEST( WriterUtf8Test, shouldWrapUtf8TextByColumns )
+{
+   std::stringstream strout;
+   Writer writer( strout, 11 );
+   writer.write( "čšžć čšžć čšžć" );
+   writer.flush();
+
+   auto written = strout.str();
+   auto lines = splitLines( written );
+   ASSERT_EQ( 2, lines.size() );
+   EXPECT_EQ( "čšžć čšžć", lines[0] );
+   EXPECT_EQ( "čšžć", lines[1] );
+}
+
+TEST( WriterUtf8Test, shouldSkipToColumnAfterUtf8Text )
+{
+   std::stringstream strout;
+   Writer writer( strout, 80 );
+   writer.write( "日本" );
+   writer.skipToColumnOrNewLine( 10 );
+   writer.write( "ščž" );
+   writer.flush();
+
+   EXPECT_EQ( "日本      ščž", strout.str() );
+}
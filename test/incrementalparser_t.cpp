@@ -0,0 +1,123 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "testutil.h"
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string_view>
+
+using namespace argumentum;
+using namespace testing;
+using namespace testutil;
+
+namespace {
+struct CmdOptions : public argumentum::CommandOptions
+{
+   std::optional<std::string> str;
+   std::vector<long> numbers;
+
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( str, "-s" ).nargs( 1 );
+      params.add_parameter( numbers, "-n" ).minargs( 1 );
+   }
+};
+
+template<typename TChunk>
+void feed( incremental_parser& parse, const TChunk& chunk )
+{
+   parse.feed( std::begin( chunk ), std::end( chunk ) );
+}
+
+using Chunk = std::vector<std::string_view>;
+}   // namespace
+
+TEST( IncrementalParser, shouldKeepActiveOptionBetweenChunks )
+{
+   std::vector<long> values;
+   std::optional<std::string> name;
+   std::vector<std::string> files;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( values, "--values" ).minargs( 1 );
+   params.add_parameter( name, "--name" ).nargs( 1 );
+   params.add_parameter( files, "files" ).minargs( 0 );
+
+   auto parse = parser.begin_parse();
+   feed( parse, Chunk{ "--values", "1", "2" } );
+   feed( parse, Chunk{ "3", "--name" } );
+   feed( parse, Chunk{ "alpha", "a.txt" } );
+   feed( parse, Chunk{ "b.txt" } );
+   auto res = parse.finish();
+
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( parse.finished() );
+   EXPECT_TRUE( vector_eq( { 1, 2, 3 }, values ) );
+   EXPECT_EQ( "alpha", name.value_or( "" ) );
+   EXPECT_TRUE( vector_eq( { "a.txt", "b.txt" }, files ) );
+}
+
+TEST( IncrementalParser, shouldValidateOptionsOnlyWhenFinished )
+{
+   std::optional<std::string> required;
+   std::optional<std::string> name;
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   auto params = parser.params();
+   params.add_parameter( required, "--required" ).nargs( 1 ).required( true );
+   params.add_parameter( name, "--name" ).nargs( 1 );
+
+   auto parse = parser.begin_parse();
+   feed( parse, Chunk{ "--name", "alpha" } );
+   feed( parse, Chunk{ "--required", "beta" } );
+   auto res = parse.finish();
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "beta", required.value_or( "" ) );
+
+   parse = parser.begin_parse();
+   feed( parse, Chunk{ "--name" } );
+   res = parse.finish();
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_FALSE( required.has_value() );
+
+   auto errors = std::vector<int>{};
+   for ( auto& e : res.errors )
+      errors.push_back( e.errorCode );
+   std::sort( errors.begin(), errors.end() );
+   EXPECT_TRUE( vector_eq( { MISSING_OPTION, MISSING_ARGUMENT }, errors ) );
+}
+
+TEST( IncrementalParser, shouldFeedSelectedCommandWithFollowingChunks )
+{
+   std::optional<std::string> global;
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   auto params = parser.params();
+   params.add_parameter( global, "-g" ).nargs( 1 );
+   params.add_command<CmdOptions>( "cmd" );
+
+   auto parse = parser.begin_parse();
+   feed( parse, Chunk{ "-g", "top", "cmd", "-n" } );
+   feed( parse, Chunk{ "1", "2" } );
+   feed( parse, Chunk{ "3", "-s", "sub" } );
+   auto res = parse.finish();
+
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "top", global.value_or( "" ) );
+
+   auto pCmd = findCommand<CmdOptions>( res, "cmd" );
+   ASSERT_NE( nullptr, pCmd );
+   EXPECT_EQ( "sub", pCmd->str.value_or( "" ) );
+   EXPECT_TRUE( vector_eq( { 1, 2, 3 }, pCmd->numbers ) );
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+size_t naiveDistance( std::string_view a, std::string_view b )
+{
+   std::vector<std::vector<size_t>> d( a.size() + 1, std::vector<size_t>( b.size() + 1 ) );
+   for ( size_t i = 0; i <= a.size(); ++i )
+      d[i][0] = i;
+   for ( size_t j = 0; j <= b.size(); ++j )
+      d[0][j] = j;
+   for ( size_t i = 1; i <= a.size(); ++i )
+      for ( size_t j = 1; j <= b.size(); ++j )
+         d[i][j] = std::min( { d[i - 1][j] + 1, d[i][j - 1] + 1,
+               d[i - 1][j - 1] + ( a[i - 1] == b[j - 1] ? 0 : 1 ) } );
+   return d[a.size()][b.size()];
+}
+
+std::string randomName( std::mt19937& rng, size_t maxLength )
+{
+   std::uniform_int_distribution<size_t> length( 0, maxLength );
+   std::uniform_int_distribution<int> letter( 'a', 'e' );
+   std::string name( length( rng ), ' ' );
+   for ( auto& ch : name )
+      ch = char( letter( rng ) );
+   return name;
+}
+
+struct EmptyCommand : public argumentum::CommandOptions
+{
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& ) override
+   {}
+};
+}   // namespace
+
+TEST( NameSuggester, shouldComputeBoundedEditDistance )
+{
+   std::mt19937 rng( 7 );
+   for ( auto maxLength : { 10, 70, 140 } ) {
+      for ( int i = 0; i < 300; ++i ) {
+         auto a = randomName( rng, maxLength );
+         auto b = randomName( rng, maxLength );
+         auto expected = naiveDistance( a, b );
+         auto distance = EditDistance( a );
+         EXPECT_EQ( expected, distance( b, SIZE_MAX - 1 ) ) << a << " " << b;
+         for ( size_t bound : { 0, 1, 3, 8 } )
+            EXPECT_EQ( std::min( expected, bound + 1 ), distance( b, bound ) ) << a << " " << b;
+      }
+   }
+}
+
+TEST( NameSuggester, shouldSuggestClosestNames )
+{
+   std::mt19937 rng( 11 );
+   std::vector<std::string> names;
+   NameSuggester suggester;
+   for ( int i = 0; i < 500; ++i ) {
+      auto name = randomName( rng, 8 );
+      if ( suggester.insert( name ) )
+         names.push_back( name );
+   }
+   EXPECT_EQ( names.size(), suggester.size() );
+   EXPECT_FALSE( suggester.insert( names.front() ) );
+
+   for ( int i = 0; i < 100; ++i ) {
+      auto query = randomName( rng, 8 );
+      std::vector<std::pair<size_t, std::string>> expected;
+      for ( auto& name : names ) {
+         auto d = naiveDistance( query, name );
+         if ( d <= 2 )
+            expected.emplace_back( d, name );
+      }
+      std::sort( expected.begin(), expected.end() );
+
+      std::vector<std::string> expectedNames;
+      for ( size_t k = 0; k < expected.size() && k < 5; ++k )
+         expectedNames.push_back( expected[k].second );
+      EXPECT_TRUE( vector_eq( expectedNames, suggester.suggest( query, 2, 5 ) ) ) << query;
+   }
+}
+
+TEST( NameSuggester, shouldSuggestOptionsAndCommands )
+{
+   bool verbose = false;
+   bool version = false;
+   std::string output;
+   long job = 0;
+   long jobs = 0;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( verbose, "--verbose" );
+   params.add_parameter( version, "--version" );
+   params.add_parameter( output, "--output", "-o" ).nargs( 1 );
+   params.add_parameter( job, "--job" ).nargs( 1 );
+   params.add_parameter( jobs, "--jobs" ).nargs( 1 );
+   params.add_command<EmptyCommand>( "build" );
+   params.add_command<EmptyCommand>( "bundle" );
+
+   std::stringstream strout;
+   parser.config().cout( strout );
+
+   auto res = parser.parse_args( { "--verison", "--jobz", "-q", "buidl" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 4, res.errors.size() );
+   EXPECT_EQ( UNKNOWN_OPTION, res.errors[0].errorCode );
+   EXPECT_TRUE( vector_eq( { "--version" }, res.errors[0].candidates ) );
+   EXPECT_TRUE( vector_eq( { "--job", "--jobs" }, res.errors[1].candidates ) );
+   // Short names are too short for suggestions.
+   EXPECT_TRUE( res.errors[2].candidates.empty() );
+   EXPECT_EQ( UNKNOWN_COMMAND, res.errors[3].errorCode );
+   EXPECT_EQ( "buidl", res.errors[3].option );
+   EXPECT_TRUE( vector_eq( { "build", "bundle" }, res.errors[3].candidates ) );
+   EXPECT_TRUE( res.ignoredArguments.empty() );
+
+   auto help = strout.str();
+   EXPECT_NE( std::string::npos,
+         help.find( "Unknown option: '--verison'. Did you mean '--version'?" ) );
+   EXPECT_NE( std::string::npos,
+         help.find( "Unknown option: '--jobz'. Did you mean '--job' or '--jobs'?" ) );
+   EXPECT_NE( std::string::npos,
+         help.find( "Unknown command: 'buidl'. Did you mean 'build' or 'bundle'?" ) );
+}
+
+TEST( NameSuggester, shouldDisableSuggestions )
+{
+   bool verbose = false;
+   auto parser = argument_parser{};
+   parser.config().max_suggestions( 0 );
+   parser.params().add_parameter( verbose, "--verbose" );
+   parser.params().add_command<EmptyCommand>( "build" );
+
+   std::stringstream strout;
+   parser.config().cout( strout );
+
+   auto res = parser.parse_args( { "--verbos", "buidl" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_TRUE( res.errors[0].candidates.empty() );
+   EXPECT_TRUE( vector_eq( { "buidl" }, res.ignoredArguments ) );
+}
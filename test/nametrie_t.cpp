@@ -0,0 +1,45 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+
+using namespace argumentum;
+using namespace testing;
+
+TEST( NameTrie, shouldFindInsertedNames )
+{
+   NameTrie trie;
+   EXPECT_TRUE( trie.insert( "--verbose", 0 ) );
+   EXPECT_TRUE( trie.insert( "--version", 1 ) );
+   EXPECT_TRUE( trie.insert( "--ver", 2 ) );
+   EXPECT_TRUE( trie.insert( "-v", 3 ) );
+   EXPECT_FALSE( trie.insert( "--version", 4 ) );
+
+   EXPECT_EQ( 4, trie.size() );
+   EXPECT_EQ( 0, trie.find( "--verbose" ) );
+   EXPECT_EQ( 1, trie.find( "--version" ) );
+   EXPECT_EQ( 2, trie.find( "--ver" ) );
+   EXPECT_EQ( 3, trie.find( "-v" ) );
+   EXPECT_EQ( -1, trie.find( "--ve" ) );
+   EXPECT_EQ( -1, trie.find( "--versions" ) );
+   EXPECT_EQ( -1, trie.find( "" ) );
+}
+
+TEST( NameTrie, shouldFindNamesByPrefixInOrder )
+{
+   NameTrie trie;
+   int value = 0;
+   for ( auto name : { "--verbose", "--version", "--ver", "-v", "--all", "--value" } )
+      trie.insert( name, value++ );
+
+   EXPECT_TRUE( vector_eq( { 2, 0, 1 }, trie.findPrefixed( "--ver" ) ) );
+   EXPECT_TRUE( vector_eq( { 5, 2, 0, 1 }, trie.findPrefixed( "--v" ) ) );
+   EXPECT_TRUE( vector_eq( { 4, 5, 2, 0, 1, 3 }, trie.findPrefixed( "" ) ) );
+   EXPECT_TRUE( vector_eq( { 4, 5 }, trie.findPrefixed( "--", 2 ) ) );
+   EXPECT_TRUE( trie.findPrefixed( "--x" ).empty() );
+   EXPECT_TRUE( trie.findPrefixed( "--verx" ).empty() );
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// This test is compiled with ARGUMENTUM_NO_EXCEPTIONS and without the support
+// for exceptions in the compiler.
+#include <argumentum/argparse-h.h>
+#include <argumentum/structparser.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct TestOptions
+{
+   long count = 0;
+   short level = 0;
+   double ratio = 0;
+   std::string color;
+   std::vector<long> ids;
+   std::vector<long> values;
+
+   void add( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( count, "--count" ).nargs( 1 );
+      params.add_parameter( level, "--level" ).nargs( 1 );
+      params.add_parameter( ratio, "--ratio" ).nargs( 1 );
+      params.add_parameter( color, "--color" ).nargs( 1 ).choices( { "red", "green" } );
+      params.add_parameter( ids, "--ids" ).minargs( 1 ).split( ',' );
+      params.add_parameter( values, "--values" ).minargs( 1 ).parallel( 2 );
+   }
+};
+
+std::vector<std::pair<std::string, int>> getErrors( const ParseResult& result )
+{
+   std::vector<std::pair<std::string, int>> errors;
+   for ( auto& error : result.errors )
+      errors.emplace_back( error.option, error.errorCode );
+   return errors;
+}
+}   // namespace
+
+TEST( NoExceptions, shouldBeBuiltWithoutExceptions )
+{
+#ifdef ARGUMENTUM_NO_EXCEPTIONS
+   constexpr bool hasExceptions = false;
+#else
+   constexpr bool hasExceptions = true;
+#endif
+   EXPECT_FALSE( hasExceptions );
+}
+
+TEST( NoExceptions, shouldReturnConversionErrorsInResult )
+{
+   EXPECT_EQ( 12, try_parse_int<int>( "12" ).value );
+   EXPECT_EQ( EConversionError::invalidValue, try_parse_int<int>( "x" ).error );
+   EXPECT_EQ( EConversionError::outOfRange, try_parse_int<short>( "99999" ).error );
+   EXPECT_EQ( 2.5, try_parse_float<double>( "2.5" ).value );
+   EXPECT_EQ( EConversionError::invalidValue, try_parse_float<double>( "x" ).error );
+   EXPECT_FALSE( static_cast<bool>( from_string<double>::try_convert( "abc" ) ) );
+}
+
+TEST( NoExceptions, shouldReportInvalidArguments )
+{
+   std::stringstream strout;
+   TestOptions opt;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   opt.add( parser );
+
+   auto res = parser.parse_args( { "--count", "many", "--level", "99999", "--ratio", "0.5",
+         "--color", "blue", "--ids", "1,2,x,4", "--values", "1", "two", "3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+
+   auto expected = std::vector<std::pair<std::string, int>>{ { "--count", CONVERSION_ERROR },
+      { "--level", CONVERSION_ERROR }, { "--color", INVALID_CHOICE },
+      { "--ids[2]", CONVERSION_ERROR }, { "--values[1]", CONVERSION_ERROR } };
+   EXPECT_EQ( expected, getErrors( res ) );
+   EXPECT_EQ( 0.5, opt.ratio );
+   EXPECT_EQ( std::vector<long>{}, opt.ids );
+   EXPECT_EQ( std::vector<long>( { 1, 3 } ), opt.values );
+}
+
+TEST( NoExceptions, shouldReportDefinitionErrorsInResult )
+{
+   std::stringstream strout;
+   long first = 0;
+   long second = 0;
+   std::vector<long> values;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   auto params = parser.params();
+   params.add_parameter( first, "--value" ).nargs( 1 );
+   params.add_parameter( second, "--value" ).nargs( 1 );
+   params.add_parameter( second, "-long" );
+   params.add_parameter( values, "--values" ).nargs( 1 ).minargs( 1 );
+
+   auto errors = parser.definition_errors();
+   ASSERT_EQ( 3, errors.size() );
+   EXPECT_EQ( "Option '--value' is already defined in group ''.", errors[0] );
+   EXPECT_EQ( "Short option name has too many characters.", errors[1] );
+   EXPECT_EQ( "--values: Only one of nargs, minargs and maxargs can be used.", errors[2] );
+
+   auto res = parser.parse_args( { "--value", "1" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 3, res.errors.size() );
+   EXPECT_EQ( INVALID_DEFINITION, res.errors[0].errorCode );
+   EXPECT_EQ( 0, first );
+   EXPECT_NE( std::string::npos, strout.str().find( "Invalid parameter definition" ) );
+}
+
+TEST( NoExceptions, shouldReportDefinitionErrorsOfCommands )
+{
+   struct CmdOptions : public CommandOptions
+   {
+      long value = 0;
+      using CommandOptions::CommandOptions;
+
+      void add_parameters( ParameterConfig& params ) override
+      {
+         params.add_parameter( value, "--value" ).nargs( 1 );
+         params.add_parameter( value, "--value" ).nargs( 1 );
+      }
+   };
+
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   auto params = parser.params();
+   params.add_command<CmdOptions>( "cmd" );
+   params.add_command<CmdOptions>( "cmd" );
+   params.add_command( "empty", []( std::string_view ) {
+      return std::shared_ptr<CommandOptions>{};
+   } );
+
+   auto errors = parser.definition_errors();
+   ASSERT_EQ( 1, errors.size() );
+   EXPECT_EQ( "Command 'cmd' is already defined.", errors[0] );
+
+   parser = argument_parser{};
+   parser.config().cout( strout );
+   parser.params().add_command<CmdOptions>( "cmd" );
+   parser.params().add_command( "empty", []( std::string_view ) {
+      return std::shared_ptr<CommandOptions>{};
+   } );
+
+   auto res = parser.parse_args( { "cmd", "--value", "1" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( INVALID_DEFINITION, res.errors[0].errorCode );
+
+   res = parser.parse_args( { "empty" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "Command 'empty' has no options.", res.errors[0].option );
+}
+
+TEST( NoExceptions, shouldReportDefinitionErrorsOfStructParser )
+{
+   auto parser = struct_parser<TestOptions>{};
+   parser.add( &TestOptions::count, "--count" ).nargs( 1 );
+   parser.add( &TestOptions::level, "--count" ).nargs( 1 );
+
+   ASSERT_EQ( 1, parser.definition_errors().size() );
+   TestOptions opt;
+   auto res = parser.parse_args( opt, { "--count", "2" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( INVALID_DEFINITION, res.errors[0].errorCode );
+   EXPECT_EQ( 0, opt.count );
+}
+
+TEST( NoExceptions, shouldNotThrowFromUncheckedResult )
+{
+   long count = 0;
+   auto parser = argument_parser{};
+   parser.params().add_parameter( count, "--count" ).nargs( 1 );
+   {
+      auto res = parser.parse_args( { "--count", "1" } );
+   }
+   EXPECT_EQ( 1, count );
+}
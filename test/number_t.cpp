@@ -138,6 +138,16 @@ TEST( ParseFloat, shouldParsNegativeDoubleWithExponent )
    EXPECT_NEAR( -2.345e3, parse_float<double>( "-2.345e3" ), 1e-6 );
 }
 
+TEST( ParseInt, shouldReturnConversionErrorWithoutThrowing )
+{
+   EXPECT_EQ( 12, try_parse_int<int>( "12" ).value );
+   EXPECT_EQ( EConversionError::invalidValue, try_parse_int<int>( "twelve" ).error );
+   EXPECT_EQ( EConversionError::outOfRange, try_parse_int<short>( "99999" ).error );
+   EXPECT_EQ( EConversionError::outOfRange, try_parse_int<unsigned>( "-1" ).error );
+   EXPECT_EQ( EConversionError::invalidValue, try_parse_float<double>( "x1.5" ).error );
+   EXPECT_FALSE( static_cast<bool>( from_string<long>::try_convert( "many" ) ) );
+}
+
 TEST( ParseFloat, shouldThrowOnOutOfRangeFloat )
 {
    EXPECT_THROW( parse_float<float>( "2e100" ), std::out_of_range );
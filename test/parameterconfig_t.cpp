@@ -151,3 +151,68 @@ TEST( ArgumentConfig, shouldAddExclusiveGroup )
    auto res = parser.parse_args( { "-s", "works", "-t", "fails" } );
    EXPECT_FALSE( res );
 }
+
+TEST( ArgumentConfig, shouldAddParametersInBulk )
+{
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   std::vector<std::string> values( 3 );
+   std::vector<std::string> names = { "--one", "--two", "--three" };
+
+   // -- WHEN
+   std::vector<ParameterDescriptor<std::string>> descriptors;
+   for ( size_t i = 0; i < values.size(); ++i )
+      descriptors.push_back( { &values[i], names[i], {}, 1, "A value." } );
+   descriptors[1].altName = "-t";
+   params.add_parameters_bulk( descriptors );
+
+   // -- THEN
+   auto res = parser.parse_args( { "--one", "1", "-t", "2", "--three", "3" } );
+   EXPECT_TRUE( res );
+   EXPECT_TRUE( vector_eq( { "1", "2", "3" }, values ) );
+
+   auto help = getTestHelp( parser, HelpFormatter() );
+   EXPECT_NE( std::string::npos, help.find( "A value." ) );
+}
+
+TEST( ArgumentConfig, shouldRejectDuplicateNamesInBulk )
+{
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   std::string first;
+   std::string second;
+   params.add_parameter( first, "--first", "-f" ).nargs( 1 );
+
+   auto descriptors = std::vector<ParameterDescriptor<std::string>>{
+         { &second, "--second", "-f", 1, {} } };
+   EXPECT_THROW( params.add_parameters_bulk( descriptors ), argumentum::DuplicateOption );
+}
+
+TEST( ArgumentConfig, shouldFindOptionsRenamedAfterTheyWereAdded )
+{
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   long value = 0;
+   long other = 0;
+   params.add_parameter( value, "--old", "-o" )
+         .nargs( 1 )
+         .setLongName( "--new" )
+         .setShortName( "-n" );
+   params.add_parameter( other, "--other" ).nargs( 1 );
+
+   auto res = parser.parse_args( { "--new", "5", "--other", "6" } );
+   EXPECT_TRUE( res );
+   EXPECT_EQ( 5, value );
+   EXPECT_EQ( 6, other );
+
+   res = parser.parse_args( { "-n", "7" } );
+   EXPECT_TRUE( res );
+   EXPECT_EQ( 7, value );
+
+   // The old names are no longer used.
+   std::string old;
+   params.add_parameter( old, "--old" ).nargs( 1 );
+   res = parser.parse_args( { "--old", "8" } );
+   EXPECT_TRUE( res );
+   EXPECT_EQ( "8", old );
+}
@@ -30,6 +30,32 @@ TEST( ParserConfig, shouldSetParserOutputToStream )
    EXPECT_EQ( &strout, pConfiguredStream );
 }
 
+TEST( ParserConfig, shouldSetParserOutputToSink )
+{
+   class StringSink : public IOutputSink
+   {
+   public:
+      std::string text;
+
+   public:
+      void write( std::string_view value ) override
+      {
+         text += value;
+      }
+   };
+
+   auto pSink = std::make_shared<StringSink>();
+   auto parser = argument_parser{};
+   parser.config().program( "testing" ).output_sink( pSink );
+
+   EXPECT_EQ( nullptr, parser.getConfig().output_stream() );
+   EXPECT_EQ( pSink.get(), parser.getConfig().output_sink() );
+
+   auto res = parser.parse_args( { "--help" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "usage: testing" ) );
+}
+
 TEST( ParserConfig, shouldChangeHelpFormatter )
 {
    namespace t = ::testing;
@@ -42,7 +68,7 @@ TEST( ParserConfig, shouldChangeHelpFormatter )
       unsigned formatCount = 0;
 
    public:
-      void format( const ParserDefinition&, std::ostream& ) override
+      void format( const ParserDefinition&, IOutputSink& ) override
       {
          ++formatCount;
       }
@@ -0,0 +1,190 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+using namespace argumentum;
+using namespace testing;
+
+TEST( SinkTest, shouldPassEachPositionalValueToCallback )
+{
+   std::vector<int> received;
+   bool closed = false;
+   auto numbers = value_sink<int>(
+         [&]( int&& value ) {
+            received.push_back( value );
+         },
+         [&]() {
+            closed = true;
+         } );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" ).minargs( 1 );
+
+   auto res = parser.parse_args( { "1", "2", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { 1, 2, 3 }, received ) );
+   EXPECT_EQ( 3, numbers.count() );
+   EXPECT_TRUE( closed );
+}
+
+TEST( SinkTest, shouldRespectArgumentCountsOfSinkOptions )
+{
+   std::vector<std::string> received;
+   auto words = value_sink<std::string>( [&]( std::string&& value ) {
+      received.push_back( value );
+   } );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( words, "--words" ).maxargs( 2 );
+
+   auto res = parser.parse_args( { "--words", "one", "two", "three" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { "one", "two" }, received ) );
+   EXPECT_TRUE( vector_eq( { "three" }, res.ignoredArguments ) );
+
+   received.clear();
+   res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 0, words.count() );
+   EXPECT_TRUE( received.empty() );
+}
+
+TEST( SinkTest, shouldReportConversionErrorsForSinkValues )
+{
+   std::vector<int> received;
+   auto numbers = value_sink<int>( [&]( int&& value ) {
+      received.push_back( value );
+   } );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "--numbers" );
+
+   auto res = parser.parse_args( { "--numbers", "1", "x", "3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( CONVERSION_ERROR, res.errors[0].errorCode );
+   EXPECT_TRUE( vector_eq( { 1, 3 }, received ) );
+}
+
+TEST( SinkTest, shouldConsumeQueuedValuesWhileParsing )
+{
+   const int count = 10000;
+   auto numbers = queue_sink<long>( 16 );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" );
+
+   std::vector<std::string> args;
+   for ( int i = 0; i < count; ++i )
+      args.push_back( std::to_string( i ) );
+
+   long sum = 0;
+   long received = 0;
+   bool ordered = true;
+   std::thread consumer( [&]() {
+      for ( auto value = numbers.pop(); value.has_value(); value = numbers.pop() ) {
+         ordered = ordered && *value == received;
+         sum += *value;
+         ++received;
+      }
+   } );
+
+   auto res = parser.parse_args( args );
+   consumer.join();
+
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( count, received );
+   EXPECT_EQ( long( count ) * ( count - 1 ) / 2, sum );
+   EXPECT_TRUE( ordered );
+}
+
+TEST( SinkTest, shouldCloseQueueWhenParserThrows )
+{
+   auto numbers = queue_sink<long>( 4 );
+   bool fail = false;
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" ).minargs( 0 );
+   params.add_parameter( fail, "--fail" ).action( []( bool&, const std::string& ) {
+      throw std::runtime_error( "failed" );
+   } );
+
+   std::vector<std::string> args;
+   for ( int i = 0; i < 100; ++i )
+      args.push_back( std::to_string( i ) );
+   args.push_back( "--fail" );
+
+   long received = 0;
+   std::thread consumer( [&]() {
+      while ( numbers.pop().has_value() )
+         ++received;
+   } );
+
+   // The parse is not destroyed so the queue is closed while the exception
+   // leaves feed().
+   auto parse = parser.begin_parse();
+   EXPECT_THROW( parse.feed( args.begin(), args.end() ), std::runtime_error );
+   consumer.join();
+   EXPECT_EQ( 100, received );
+}
+
+TEST( SinkTest, shouldKeepUnconsumedQueueValuesInNextParse )
+{
+   auto numbers = queue_sink<long>( 8 );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" );
+
+   auto res = parser.parse_args( { "1", "2", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 1, numbers.pop() );
+
+   res = parser.parse_args( { "4", "5" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, numbers.count() );
+
+   std::vector<long> received;
+   for ( auto value = numbers.pop(); value.has_value(); value = numbers.pop() )
+      received.push_back( *value );
+   EXPECT_TRUE( vector_eq( { 2, 3, 4, 5 }, received ) );
+}
+
+TEST( SinkTest, shouldCloseSinkOnceWhenParseIsAbandoned )
+{
+   int closeCount = 0;
+   auto numbers = value_sink<int>(
+         []( int&& ) {},
+         [&]() {
+            ++closeCount;
+         } );
+
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( numbers, "numbers" );
+
+   std::vector<std::string> args{ "1", "2" };
+   {
+      auto parse = parser.begin_parse();
+      parse.feed( args.begin(), args.end() );
+   }
+   EXPECT_EQ( 1, closeCount );
+
+   auto parse = parser.begin_parse();
+   parse.feed( args.begin(), args.end() );
+   auto res = parse.finish();
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, closeCount );
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// This test is compiled with ARGUMENTUM_SLIM.  The library headers are
+// included before the headers of the test framework so that we can check
+// which standard headers they use.
+#include <argumentum/argparse-h.h>
+
+#if defined( __GLIBCXX__ ) && defined( _GLIBCXX_REGEX )
+constexpr bool libraryIncludesRegex = true;
+#else
+constexpr bool libraryIncludesRegex = false;
+#endif
+
+#if defined( __GLIBCXX__ ) && defined( _GLIBCXX_IOSTREAM )
+constexpr bool libraryIncludesIostream = true;
+#else
+constexpr bool libraryIncludesIostream = false;
+#endif
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+class StringSink : public IOutputSink
+{
+public:
+   std::string text;
+
+public:
+   void write( std::string_view value ) override
+   {
+      text += value;
+   }
+};
+
+struct RunOptions : public CommandOptions
+{
+   long level = 0;
+
+   using CommandOptions::CommandOptions;
+
+   void add_parameters( ParameterConfig& params ) override
+   {
+      params.add_parameter( level, "--level" ).nargs( 1 ).help( "The level of the job." );
+   }
+};
+}   // namespace
+
+TEST( SlimBuild, shouldNotIncludeRegexAndIostream )
+{
+   EXPECT_FALSE( libraryIncludesRegex );
+   EXPECT_FALSE( libraryIncludesIostream );
+}
+
+TEST( SlimBuild, shouldWriteHelpAndErrorsToSink )
+{
+   long count = 0;
+   auto pSink = std::make_shared<StringSink>();
+   auto parser = argument_parser{};
+   parser.config().program( "slim" ).output_sink( pSink );
+   auto params = parser.params();
+   params.add_parameter( count, "--count" ).nargs( 1 ).help( "The number of items." );
+
+   auto res = parser.parse_args( { "--help" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "usage: slim" ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "The number of items." ) );
+
+   pSink->text.clear();
+   res = parser.parse_args( { "--count", "many" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "could not be converted: '--count'" ) );
+}
+
+TEST( SlimBuild, shouldWriteCommandHelpToParentSink )
+{
+   auto pSink = std::make_shared<StringSink>();
+   auto parser = argument_parser{};
+   parser.config().program( "slim" ).output_sink( pSink );
+   auto params = parser.params();
+   params.add_command<RunOptions>( "run" ).help( "Run the job." );
+
+   auto res = parser.parse_args( { "run", "--help" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "usage: slim run" ) );
+   EXPECT_NE( std::string::npos, pSink->text.find( "The level of the job." ) );
+}
+
+TEST( SlimBuild, shouldParseNumbersWithoutRegex )
+{
+   long count = 0;
+   double ratio = 0;
+   std::vector<long> values;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   params.add_parameter( count, "--count" ).nargs( 1 );
+   params.add_parameter( ratio, "--ratio" ).nargs( 1 );
+   params.add_parameter( values, "values" ).minargs( 0 );
+
+   auto res = parser.parse_args( { "--count", "-0x1f", "--ratio", "-0d2.5e1", "-0b101", "0o17" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( -31, count );
+   EXPECT_EQ( -25.0, ratio );
+   ASSERT_EQ( 2U, values.size() );
+   EXPECT_EQ( -5, values[0] );
+   EXPECT_EQ( 15, values[1] );
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include "staticparser_args.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct StaticParse
+{
+   std::vector<const char*> argv;
+   std::stringstream out;
+   generated::StaticArgs args;
+   static_parse_result res;
+
+   StaticParse( std::initializer_list<const char*> args_ )
+      : argv( args_ )
+   {
+      res = args.parse_args( int( argv.size() ), argv.data(), 0, &out );
+   }
+
+   bool hasError( std::string_view option, int errorCode ) const
+   {
+      for ( auto& error : res.errors )
+         if ( error.option == option && error.errorCode == errorCode )
+            return true;
+      return false;
+   }
+};
+}   // namespace
+
+TEST( StaticParser, shouldParseTypedValues )
+{
+   auto parse = StaticParse( { "-v", "--level", "3", "--scale=0.5", "-n", "out", "--values", "1",
+         "-2", "3", "--pair", "1.5", "2.5", "a", "b" } );
+   auto& args = parse.args;
+
+   EXPECT_TRUE( static_cast<bool>( parse.res ) );
+   EXPECT_TRUE( args.verbose );
+   EXPECT_EQ( 3, args.level.value_or( 0 ) );
+   EXPECT_EQ( 0.5, args.scale.value_or( 0 ) );
+   EXPECT_EQ( "out", args.name.value_or( "" ) );
+   EXPECT_TRUE( vector_eq( { 1, -2, 3 }, args.values ) );
+   EXPECT_TRUE( vector_eq( { 1.5, 2.5 }, args.pair ) );
+   ASSERT_EQ( 2, args.files.size() );
+   EXPECT_EQ( "a", args.files[0] );
+   EXPECT_EQ( "b", args.files[1] );
+}
+
+TEST( StaticParser, shouldParseCombinedShortOptions )
+{
+   auto parse = StaticParse( { "-vl", "5", "-n", "x", "--", "-v" } );
+   auto& args = parse.args;
+
+   EXPECT_TRUE( static_cast<bool>( parse.res ) );
+   EXPECT_TRUE( args.verbose );
+   EXPECT_EQ( 5, args.level.value_or( 0 ) );
+   ASSERT_EQ( 1, args.files.size() );
+   EXPECT_EQ( "-v", args.files[0] );
+}
+
+TEST( StaticParser, shouldReportErrors )
+{
+   auto parse = StaticParse( { "--level", "x", "--unknown", "--pair", "1" } );
+
+   EXPECT_FALSE( static_cast<bool>( parse.res ) );
+   EXPECT_TRUE( parse.hasError( "--level", CONVERSION_ERROR ) );
+   EXPECT_TRUE( parse.hasError( "--unknown", UNKNOWN_OPTION ) );
+   EXPECT_TRUE( parse.hasError( "--pair", MISSING_ARGUMENT ) );
+   EXPECT_TRUE( parse.hasError( "--name", MISSING_OPTION ) );
+}
+
+TEST( StaticParser, shouldReportFlagParameter )
+{
+   auto parse = StaticParse( { "--verbose=1", "-n", "x" } );
+
+   EXPECT_FALSE( static_cast<bool>( parse.res ) );
+   EXPECT_TRUE( parse.hasError( "--verbose", FLAG_PARAMETER ) );
+}
+
+TEST( StaticParser, shouldShowPrerenderedHelp )
+{
+   auto parse = StaticParse( { "--level", "1", "--help", "--unknown" } );
+
+   EXPECT_FALSE( static_cast<bool>( parse.res ) );
+   EXPECT_TRUE( parse.res.helpWasShown );
+   EXPECT_TRUE( parse.res.errors.empty() );
+
+   auto help = parse.out.str();
+   EXPECT_EQ( generated::StaticArgs::spec::help, help );
+   EXPECT_NE( std::string::npos, help.find( "usage: static" ) );
+   EXPECT_NE( std::string::npos, help.find( "A parser generated by argumentum-gen." ) );
+   EXPECT_NE( std::string::npos, help.find( "--level LEVEL" ) );
+   EXPECT_NE( std::string::npos, help.find( "The files to process." ) );
+   EXPECT_NE( std::string::npos, help.find( "Display this help message and exit." ) );
+}
+
+TEST( StaticParser, shouldFindAllNamesThroughPerfectHash )
+{
+   using spec = generated::StaticArgs::spec;
+   using parser = StaticParser<spec, generated::StaticArgs>;
+
+   for ( size_t i = 0; i < spec::options.size(); ++i ) {
+      auto& option = spec::options[i];
+      if ( option.isPositional )
+         continue;
+      if ( !option.shortName.empty() ) {
+         EXPECT_EQ( int( i ), parser::findOption( option.shortName ) );
+      }
+      if ( !option.longName.empty() ) {
+         EXPECT_EQ( int( i ), parser::findOption( option.longName ) );
+      }
+   }
+
+   EXPECT_EQ( -1, parser::findOption( "--levels" ) );
+   EXPECT_EQ( -1, parser::findOption( "-x" ) );
+
+   static_assert( spec::nameSlots.size() >= 2 * 11 );
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+
+using namespace argumentum;
+using namespace testing;
+
+TEST( StringPool, shouldStoreEachDistinctStringOnce )
+{
+   StringPool pool;
+   auto first = pool.intern( "The help of an option" );
+   auto second = pool.intern( std::string( "The help of an option" ) );
+   auto other = pool.intern( "Another help" );
+
+   EXPECT_EQ( "The help of an option", first );
+   EXPECT_EQ( first.data(), second.data() );
+   EXPECT_EQ( "Another help", other );
+   EXPECT_EQ( 2, pool.size() );
+}
+
+TEST( StringPool, shouldKeepViewsValidWhenPoolGrows )
+{
+   StringPool pool;
+   auto first = pool.intern( "first" );
+   auto large = pool.intern( std::string( 10000, 'x' ) );
+   for ( int i = 0; i < 5000; ++i )
+      pool.intern( "string " + std::to_string( i ) );
+
+   EXPECT_EQ( "first", first );
+   EXPECT_EQ( std::string( 10000, 'x' ), large );
+   EXPECT_EQ( 5002, pool.size() );
+   EXPECT_EQ( "", pool.intern( "" ) );
+}
+
+TEST( StringPool, shouldShareDescriptiveTextsOfOptions )
+{
+   std::vector<std::string> values( 3 );
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   for ( int i = 0; i < 3; ++i )
+      params.add_parameter( values[i], "--value" + std::to_string( i ) )
+            .nargs( 1 )
+            .metavar( "VALUE" )
+            .choices( { "red", "green", "blue" } )
+            .help( "A value of the option." );
+
+   auto help = parser.describe_arguments();
+   ASSERT_EQ( 3, help.size() );
+   EXPECT_EQ( "A value of the option.", help[2].help );
+   EXPECT_EQ( "VALUE", help[2].arguments );
+
+   // help, metavar and three choices
+   auto usage = parser.memory_usage();
+   EXPECT_EQ( 3, usage.optionCount );
+   EXPECT_LT( 0, usage.stringPoolBytes );
+   EXPECT_LT( 0, usage.options.hotBytes );
+   EXPECT_LT( 0, usage.options.coldBytes );
+   EXPECT_EQ( usage.total() / 3, usage.perOption() );
+
+   auto res = parser.parse_args( { "--value0", "green", "--value1", "black" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_EQ( "green", values[0] );
+   EXPECT_EQ( "", values[1] );
+}
+
+TEST( StringPool, shouldKeepOptionTextsWhenParserIsMoved )
+{
+   std::string value;
+   auto parser = argument_parser{};
+   parser.params().add_parameter( value, "--value" ).nargs( 1 ).help( "The moved help." );
+
+   auto moved = std::move( parser );
+   auto help = moved.describe_arguments();
+   ASSERT_EQ( 1, help.size() );
+   EXPECT_EQ( "The moved help.", help[0].help );
+
+   auto res = moved.parse_args( { "--value", "a" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( "a", value );
+}
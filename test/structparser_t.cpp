@@ -0,0 +1,213 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+#include <argumentum/structparser.h>
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct Request
+{
+   bool verbose = false;
+   long level = 0;
+   std::string name;
+   std::optional<double> scale;
+   std::vector<long> ids;
+   std::optional<std::vector<std::string>> tags;
+   std::string input;
+   std::vector<std::string> outputs;
+};
+
+struct_parser<Request> createParser()
+{
+   auto parser = struct_parser<Request>{};
+   parser.add( &Request::verbose, "--verbose", "-v" );
+   parser.add( &Request::level, "--level", "-l" ).nargs( 1 );
+   parser.add( &Request::name, "--name" ).nargs( 1 ).required();
+   parser.add( &Request::scale, "--scale" ).nargs( 1 );
+   parser.add( &Request::ids, "--ids" );
+   parser.add( &Request::tags, "--tags" );
+   parser.add( &Request::input, "input" );
+   parser.add( &Request::outputs, "outputs" );
+   return parser;
+}
+
+bool hasError( const ParseResult& res, std::string_view option, int errorCode )
+{
+   for ( auto& error : res.errors )
+      if ( error.option == option && error.errorCode == errorCode )
+         return true;
+   return false;
+}
+}   // namespace
+
+TEST( StructParser, shouldStoreValuesInStructMembers )
+{
+   auto parser = createParser();
+
+   Request request;
+   auto res = parser.parse_args( request,
+         { "-v", "--level=3", "--name", "first", "--scale", "0.5", "--ids", "1", "2", "--tags",
+               "a", "b", "--", "in" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( request.verbose );
+   EXPECT_EQ( 3, request.level );
+   EXPECT_EQ( "first", request.name );
+   ASSERT_TRUE( request.scale.has_value() );
+   EXPECT_NEAR( 0.5, *request.scale, 1e-9 );
+   EXPECT_TRUE( vector_eq( { 1, 2 }, request.ids ) );
+   ASSERT_TRUE( request.tags.has_value() );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, *request.tags ) );
+   EXPECT_EQ( "in", request.input );
+}
+
+TEST( StructParser, shouldAssignPositionalParameters )
+{
+   auto parser = createParser();
+
+   Request request;
+   auto res = parser.parse_args( request, { "--name", "n", "-l", "2", "in", "a", "b" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, request.level );
+   EXPECT_EQ( "in", request.input );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, request.outputs ) );
+}
+
+TEST( StructParser, shouldFillNewInstanceOnEveryParse )
+{
+   auto parser = createParser();
+
+   Request first;
+   auto res = parser.parse_args( first, { "--name", "first", "--ids", "1", "--", "in" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+
+   Request second;
+   res = parser.parse_args( second, { "--name", "second", "--tags", "--", "in" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+
+   EXPECT_EQ( "first", first.name );
+   EXPECT_TRUE( vector_eq( { 1 }, first.ids ) );
+   EXPECT_FALSE( first.tags.has_value() );
+   EXPECT_EQ( "second", second.name );
+   EXPECT_TRUE( second.ids.empty() );
+   ASSERT_TRUE( second.tags.has_value() );
+   EXPECT_TRUE( second.tags->empty() );
+}
+
+TEST( StructParser, shouldReportErrors )
+{
+   auto parser = createParser();
+   std::stringstream strout;
+   parser.config().cout( strout );
+
+   Request request;
+   auto res = parser.parse_args(
+         request, { "--level", "many", "--unknown", "--verbose=1", "--scale" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_TRUE( hasError( res, "--level", CONVERSION_ERROR ) );
+   EXPECT_TRUE( hasError( res, "--unknown", UNKNOWN_OPTION ) );
+   EXPECT_TRUE( hasError( res, "--verbose", FLAG_PARAMETER ) );
+   EXPECT_TRUE( hasError( res, "--scale", MISSING_ARGUMENT ) );
+   EXPECT_TRUE( hasError( res, "--name", MISSING_OPTION ) );
+   EXPECT_TRUE( hasError( res, "input", MISSING_ARGUMENT ) );
+   EXPECT_EQ( 0, request.level );
+}
+
+TEST( StructParser, shouldRejectInvalidOptionNames )
+{
+   auto parser = struct_parser<Request>{};
+   parser.add( &Request::name, "--name" ).nargs( 1 );
+   EXPECT_THROW( parser.add( &Request::input, "--name" ), argumentum::DuplicateOption );
+   EXPECT_THROW( parser.add( &Request::input, "-in" ), std::invalid_argument );
+}
+
+TEST( StructParser, shouldSupportArgumentParserFeatures )
+{
+   auto parser = struct_parser<Request>{};
+   parser.add( &Request::level, "--level" ).nargs( 1 ).default_value( 7 ).help( "The level." );
+   parser.add( &Request::name, "--name" ).nargs( 1 ).choices( { "a", "b" } );
+   parser.add( &Request::verbose, "--verbose" );
+   parser.config().allow_abbrev();
+
+   Request first;
+   auto res = parser.parse_args( first, { "--verb", "--name", "a" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( first.verbose );
+   EXPECT_EQ( 7, first.level );
+   EXPECT_EQ( "a", first.name );
+
+   std::stringstream strout;
+   parser.config().cout( strout );
+   Request second;
+   res = parser.parse_args( second, { "--name", "c" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   EXPECT_TRUE( hasError( res, "--name", INVALID_CHOICE ) );
+
+   auto help = parser.parser().describe_argument( "--level" );
+   EXPECT_EQ( "The level.", help.help );
+}
+
+TEST( StructParser, shouldBindMembersInOptions )
+{
+   struct Settings
+   {
+      long count = 0;
+      std::vector<std::string> files;
+   };
+
+   class SettingsOptions : public Options
+   {
+      StructBinding<Settings> mBinding;
+
+   public:
+      SettingsOptions( const StructBinding<Settings>& binding )
+         : mBinding( binding )
+      {}
+
+      void add_parameters( ParameterConfig& params ) override
+      {
+         params.add_parameter( mBinding.member( &Settings::count ), "--count", "-n" ).nargs( 1 );
+         params.add_parameter( mBinding.member( &Settings::files ), "files" ).minargs( 1 );
+      }
+   };
+
+   auto parser = struct_parser<Settings>{};
+   parser.params().add_parameters( std::make_shared<SettingsOptions>( parser.binding() ) );
+
+   Settings first;
+   auto res = parser.parse_args( first, { "-n", "3", "a", "b" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, first.count );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, first.files ) );
+
+   Settings second;
+   res = parser.parse_args( second, { "c" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 0, second.count );
+   EXPECT_TRUE( vector_eq( { "c" }, second.files ) );
+}
+
+TEST( StructParser, shouldBindMembersInArgumentParser )
+{
+   auto binding = StructBinding<Request>{};
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   auto level = binding.member( &Request::level );
+   params.add_parameter( level, "--level" ).nargs( 1 );
+   params.add_parameter( binding.member( &Request::ids ), "--ids" ).minargs( 1 );
+
+   Request request;
+   binding.bind( request );
+   auto res = parser.parse_args( { "--level", "4", "--ids", "5", "6" } );
+   binding.unbind();
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 4, request.level );
+   EXPECT_TRUE( vector_eq( { 5, 6 }, request.ids ) );
+}
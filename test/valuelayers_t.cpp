@@ -0,0 +1,234 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct ConfigFile
+{
+   std::string path;
+   config_file file;
+
+   ConfigFile( const std::string& name, const std::string& content )
+      : path( "argumentum-layer-" + name + ".ini" )
+   {
+      std::ofstream( path, std::ios::binary ) << content;
+      file.open( path );
+   }
+
+   ~ConfigFile()
+   {
+      file = config_file{};
+      std::remove( path.c_str() );
+   }
+};
+
+class EnvVar
+{
+   std::string mName;
+
+public:
+   EnvVar( const std::string& name, const std::string& value )
+      : mName( name )
+   {
+#ifdef _WIN32
+      _putenv_s( mName.c_str(), value.c_str() );
+#else
+      setenv( mName.c_str(), value.c_str(), 1 );
+#endif
+   }
+
+   ~EnvVar()
+   {
+#ifdef _WIN32
+      _putenv_s( mName.c_str(), "" );
+#else
+      unsetenv( mName.c_str() );
+#endif
+   }
+};
+
+struct LayeredOptions
+{
+   long level = 0;
+   std::string mode;
+   std::string color;
+   std::vector<std::string> paths;
+   std::vector<std::string> includes;
+
+   void add( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( level, "--level" ).nargs( 1 ).env( "ARGUMENTUM_LAYER_LEVEL" );
+      params.add_parameter( mode, "--mode" ).nargs( 1 ).env( "ARGUMENTUM_LAYER_MODE" );
+      params.add_parameter( color, "--color" ).nargs( 1 ).default_value( "none" );
+      params.add_parameter( paths, "--path" ).minargs( 1 );
+      params.add_parameter( includes, "--include" )
+            .minargs( 1 )
+            .env( "ARGUMENTUM_LAYER_INCLUDE" )
+            .append_sources();
+   }
+};
+
+ParseResult parse( argument_parser& parser, const std::vector<const config_file*>& files,
+      std::vector<std::string> args )
+{
+   auto parse = parser.begin_parse();
+   for ( auto pFile : files )
+      parse.feed( *pFile );
+   parse.feed( args.begin(), args.end() );
+   return parse.finish();
+}
+
+std::string describeSources( const ParseResult& result, std::string_view option )
+{
+   std::string description;
+   for ( auto& source : result.value_sources( option ) ) {
+      switch ( source.source ) {
+         case EValueSource::arguments:
+            description += "arguments";
+            break;
+         case EValueSource::environment:
+            description += "env:" + source.location;
+            break;
+         case EValueSource::config:
+            description += "config:" + source.location;
+            break;
+         case EValueSource::defaultValue:
+            description += "default";
+            break;
+      }
+      description += "(" + std::to_string( source.count ) + ") ";
+   }
+   return description;
+}
+}   // namespace
+
+TEST( ValueLayers, shouldUseValueFromLayerWithHighestPrecedence )
+{
+   auto system = ConfigFile( "system", "level = 1\nmode = system\npath = /sys\n" );
+   auto user = ConfigFile( "user", "level = 2\nmode = user\n" );
+   auto env = EnvVar( "ARGUMENTUM_LAYER_MODE", "env" );
+
+   LayeredOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, { &system.file, &user.file }, { "--level", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, opt.level );
+   EXPECT_EQ( "env", opt.mode );
+   EXPECT_EQ( "none", opt.color );
+   EXPECT_TRUE( vector_eq( { "/sys" }, opt.paths ) );
+
+   EXPECT_EQ( "arguments(1) ", describeSources( res, "--level" ) );
+   EXPECT_EQ( "env:ARGUMENTUM_LAYER_MODE(1) ", describeSources( res, "--mode" ) );
+   EXPECT_EQ( "default(0) ", describeSources( res, "--color" ) );
+   EXPECT_EQ( "config:" + system.path + "(1) ", describeSources( res, "--path" ) );
+}
+
+TEST( ValueLayers, shouldConvertOnlyValueFromWinningLayer )
+{
+   // The invalid values are in the layers with lower precedence so they are
+   // never converted.
+   auto system = ConfigFile( "convert-system", "level = invalid\n" );
+   auto user = ConfigFile( "convert-user", "level = also invalid\nlevel = 5\n" );
+
+   LayeredOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, { &system.file, &user.file }, {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 5, opt.level );
+   EXPECT_EQ( "config:" + user.path + "(1) ", describeSources( res, "--level" ) );
+}
+
+TEST( ValueLayers, shouldReplaceVectorValuesFromLowerLayers )
+{
+   auto system = ConfigFile( "replace-system", "path = a\npath = b\n" );
+   auto user = ConfigFile( "replace-user", "path = c\nlevel = 1\npath = d\n" );
+
+   {
+      LayeredOptions opt;
+      auto parser = argument_parser{};
+      opt.add( parser );
+
+      auto res = parse( parser, { &system.file, &user.file }, {} );
+      EXPECT_TRUE( static_cast<bool>( res ) );
+      EXPECT_TRUE( vector_eq( { "c", "d" }, opt.paths ) );
+      EXPECT_EQ( "config:" + user.path + "(2) ", describeSources( res, "--path" ) );
+   }
+
+   LayeredOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, { &system.file, &user.file }, { "--path", "e" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { "e" }, opt.paths ) );
+   EXPECT_EQ( "arguments(1) ", describeSources( res, "--path" ) );
+}
+
+TEST( ValueLayers, shouldAppendVectorValuesFromAllLayers )
+{
+   auto system = ConfigFile( "append-system", "include = a\ninclude = b\n" );
+   auto user = ConfigFile( "append-user", "include = c\n" );
+   auto env = EnvVar( "ARGUMENTUM_LAYER_INCLUDE", "d" );
+
+   LayeredOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parse( parser, { &system.file, &user.file }, { "--include", "e", "f" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_TRUE( vector_eq( { "a", "b", "c", "d", "e", "f" }, opt.includes ) );
+   EXPECT_EQ( "config:" + system.path + "(2) config:" + user.path
+               + "(1) env:ARGUMENTUM_LAYER_INCLUDE(1) arguments(2) ",
+         describeSources( res, "--include" ) );
+}
+
+TEST( ValueLayers, shouldRequireVectorTargetToAppendSources )
+{
+   long value = 0;
+   auto parser = argument_parser{};
+   auto params = parser.params();
+   EXPECT_THROW( params.add_parameter( value, "--value" ).append_sources(),
+         std::invalid_argument );
+}
+
+TEST( ValueLayers, shouldAssignValuesFromLayerFedAfterAppendedOption )
+{
+   auto system = ConfigFile( "late-system", "include = a\nlevel = 1\n" );
+   auto user = ConfigFile( "late-user", "include = c\nlevel = 2\n" );
+
+   LayeredOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   // The values of --include from the system layer are assigned when the
+   // option starts.  The user layer is added after that.
+   auto args = std::vector<std::string>{ "--include", "e" };
+   auto parse = parser.begin_parse();
+   parse.feed( system.file );
+   parse.feed( args.begin(), args.end() );
+   parse.feed( user.file );
+   auto res = parse.finish();
+
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, opt.level );
+   EXPECT_TRUE( vector_eq( { "a", "e", "c" }, opt.includes ) );
+   EXPECT_EQ( "config:" + user.path + "(1) ", describeSources( res, "--level" ) );
+   EXPECT_EQ( "config:" + system.path + "(1) arguments(1) config:" + user.path + "(1) ",
+         describeSources( res, "--include" ) );
+}
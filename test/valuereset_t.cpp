@@ -0,0 +1,139 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+#include "vectors.h"
+
+#include <argumentum/argparse.h>
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace argumentum;
+using namespace testing;
+
+namespace {
+struct ResetOptions
+{
+   long count = 0;
+   std::string name;
+   std::vector<std::string> items;
+
+   void add( argument_parser& parser )
+   {
+      auto params = parser.params();
+      params.add_parameter( count, "--count" ).nargs( 1 );
+      params.add_parameter( name, "--name" ).nargs( 1 );
+      params.add_parameter( items, "--item" ).minargs( 1 );
+   }
+};
+}   // namespace
+
+TEST( ValueReset, shouldResetAllTargetsWhenParseStartsByDefault )
+{
+   ResetOptions opt;
+   auto parser = argument_parser{};
+   opt.add( parser );
+
+   auto res = parser.parse_args( { "--count", "2", "--name", "first" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, opt.count );
+
+   res = parser.parse_args( { "--name", "second" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 0, opt.count );
+   EXPECT_EQ( "second", opt.name );
+}
+
+TEST( ValueReset, shouldResetTargetsWhenOptionsAreUsed )
+{
+   ResetOptions opt;
+   auto parser = argument_parser{};
+   parser.config().value_reset( EValueReset::onTouch );
+   opt.add( parser );
+
+   auto res = parser.parse_args( { "--count", "2", "--item", "a", "b" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, opt.count );
+   EXPECT_TRUE( vector_eq( { "a", "b" }, opt.items ) );
+
+   // The targets of the options that are not used keep their values.
+   res = parser.parse_args( { "--name", "second", "--item", "c" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 2, opt.count );
+   EXPECT_EQ( "second", opt.name );
+   EXPECT_TRUE( vector_eq( { "c" }, opt.items ) );
+}
+
+TEST( ValueReset, shouldOverrideParserResetInOption )
+{
+   long eager = 0;
+   long lazy = 0;
+   auto parser = argument_parser{};
+   parser.config().value_reset( EValueReset::onTouch );
+   auto params = parser.params();
+   params.add_parameter( eager, "--eager" ).nargs( 1 ).value_reset( EValueReset::eager );
+   params.add_parameter( lazy, "--lazy" ).nargs( 1 );
+
+   auto res = parser.parse_args( { "--eager", "1", "--lazy", "2" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+
+   res = parser.parse_args( {} );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 0, eager );
+   EXPECT_EQ( 2, lazy );
+}
+
+TEST( ValueReset, shouldForgetAssignmentsOfPreviousParse )
+{
+   long required = 0;
+   long value = 0;
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout ).value_reset( EValueReset::onTouch );
+   auto params = parser.params();
+   params.add_parameter( required, "--required" ).nargs( 1 ).required( true );
+   params.add_parameter( value, "--value" ).nargs( 1 ).default_value( 7 );
+
+   auto res = parser.parse_args( { "--required", "1", "--value", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 3, value );
+
+   // The required option was assigned only in the previous parse and the
+   // default value is assigned again.
+   res = parser.parse_args( { "--value" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 2, res.errors.size() );
+   EXPECT_EQ( "--value", res.errors[0].option );
+   EXPECT_EQ( MISSING_ARGUMENT, res.errors[0].errorCode );
+   EXPECT_EQ( "--required", res.errors[1].option );
+   EXPECT_EQ( MISSING_OPTION, res.errors[1].errorCode );
+   EXPECT_EQ( 1, required );
+   EXPECT_EQ( 7, value );
+}
+
+TEST( ValueReset, shouldApplyConfigurationChangedBetweenParses )
+{
+   long required = 0;
+   long value = 0;
+   std::stringstream strout;
+   auto parser = argument_parser{};
+   parser.config().cout( strout );
+   auto params = parser.params();
+   auto requiredConfig = params.add_parameter( required, "--required" ).nargs( 1 );
+   auto valueConfig = params.add_parameter( value, "--value" ).nargs( 1 );
+
+   auto res = parser.parse_args( { "--value", "3" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+
+   requiredConfig.required( true );
+   valueConfig.default_value( 7 );
+   res = parser.parse_args( { "--value", "3" } );
+   EXPECT_FALSE( static_cast<bool>( res ) );
+   ASSERT_EQ( 1, res.errors.size() );
+   EXPECT_EQ( "--required", res.errors[0].option );
+   EXPECT_EQ( MISSING_OPTION, res.errors[0].errorCode );
+
+   res = parser.parse_args( { "--required", "1" } );
+   EXPECT_TRUE( static_cast<bool>( res ) );
+   EXPECT_EQ( 7, value );
+}
@@ -0,0 +1,597 @@
+// Copyright (c) 2018, 2019, 2020 Marko Mahnič
+// License: MPL2. See LICENSE in the root of the project.
+
+// argumentum-gen: generate a static parser from a declarative schema.
+//
+// usage: argumentum-gen SCHEMA OUTPUT
+//
+// The schema is a sequence of sections.  Each section is followed by `key =
+// value` lines.  Empty lines and lines starting with '#' are ignored.
+//
+//    [parser]
+//    struct = ToolArgs          # the name of the generated structure
+//    namespace = tool           # optional
+//    program = tool
+//    description = Process some files.
+//    epilog = ...
+//
+//    [option]
+//    names = --level -l
+//    type = int                 # flag, int, float, string, int_list,
+//                               # float_list, string_list
+//    field = level              # optional, derived from the long name
+//    help = The level of processing.
+//    metavar = LEVEL
+//    required = true
+//    nargs = 1                  # or minargs, maxargs
+//
+//    [positional]
+//    name = files
+//    type = string_list
+//    help = The files to process.
+//
+// The generated header defines the structure with a field for each
+// parameter, constexpr tables with the parameters and a perfect hash of the
+// option names, the help text rendered by argumentum and the typed
+// assignment of the values to the fields.
+
+#include <argumentum/argparse-h.h>
+#include <argumentum/staticparser.h>
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argumentum;
+
+namespace {
+
+class SchemaError : public std::runtime_error
+{
+public:
+   using std::runtime_error::runtime_error;
+};
+
+enum class EType { flag, integer, real, string, integerList, realList, stringList };
+
+struct ParameterSpec
+{
+   bool isPositional = false;
+   std::string shortName;
+   std::string longName;
+   std::string field;
+   EType type = EType::string;
+   std::string help;
+   std::string metavar;
+   bool isRequired = false;
+   bool isHelp = false;
+   int minArgs = 0;
+   int maxArgs = 0;
+   std::string countKey;
+   int line = 0;
+
+   bool isList() const
+   {
+      return type == EType::integerList || type == EType::realList || type == EType::stringList;
+   }
+
+   std::string getName() const
+   {
+      return longName.empty() ? shortName : longName;
+   }
+};
+
+struct ParserSpec
+{
+   std::string structName;
+   std::string ns;
+   std::string program;
+   std::string description;
+   std::string epilog;
+   std::vector<ParameterSpec> parameters;
+};
+
+std::string trim( const std::string& str )
+{
+   auto b = str.find_first_not_of( " \t\r" );
+   if ( b == std::string::npos )
+      return {};
+   auto e = str.find_last_not_of( " \t\r" );
+   return str.substr( b, e - b + 1 );
+}
+
+bool isIdentifier( const std::string& name )
+{
+   if ( name.empty() || std::isdigit( static_cast<unsigned char>( name[0] ) ) )
+      return false;
+   return std::all_of( name.begin(), name.end(), []( char ch ) {
+      return std::isalnum( static_cast<unsigned char>( ch ) ) || ch == '_';
+   } );
+}
+
+EType parseType( const std::string& value, const std::string& where )
+{
+   static const std::map<std::string, EType> types = { { "flag", EType::flag },
+      { "int", EType::integer }, { "float", EType::real }, { "string", EType::string },
+      { "int_list", EType::integerList }, { "float_list", EType::realList },
+      { "string_list", EType::stringList } };
+
+   auto it = types.find( value );
+   if ( it == types.end() )
+      throw SchemaError( where + ": unknown type '" + value + "'" );
+   return it->second;
+}
+
+int parseCount( const std::string& value, const std::string& where )
+{
+   int count = 0;
+   if ( !parse_number( value, count ) || count < 0 )
+      throw SchemaError( where + ": invalid argument count '" + value + "'" );
+   return count;
+}
+
+bool parseBool( const std::string& value, const std::string& where )
+{
+   if ( value == "true" || value == "yes" || value == "1" )
+      return true;
+   if ( value == "false" || value == "no" || value == "0" )
+      return false;
+   throw SchemaError( where + ": invalid boolean '" + value + "'" );
+}
+
+void setDefaultCounts( ParameterSpec& param, const std::string& where )
+{
+   if ( param.type == EType::flag ) {
+      if ( !param.countKey.empty() || param.isPositional )
+         throw SchemaError( where + ": a flag can not have arguments" );
+      return;
+   }
+
+   if ( !param.countKey.empty() )
+      return;
+
+   if ( param.isPositional ) {
+      param.minArgs = param.isList() ? 0 : 1;
+      param.maxArgs = param.isList() ? -1 : 1;
+      param.isRequired = true;
+   }
+   else {
+      param.minArgs = 1;
+      param.maxArgs = param.isList() ? -1 : 1;
+   }
+}
+
+void finishParameter( ParameterSpec& param, const std::string& schemaPath )
+{
+   auto where = schemaPath + ":" + std::to_string( param.line );
+   if ( param.isPositional ) {
+      if ( param.longName.empty() )
+         throw SchemaError( where + ": a positional parameter must have a name" );
+   }
+   else if ( param.shortName.empty() && param.longName.empty() )
+      throw SchemaError( where + ": an option must have a name" );
+
+   if ( param.field.empty() ) {
+      auto name = param.longName.empty() ? param.shortName : param.longName;
+      name = name.substr( name.find_first_not_of( '-' ) );
+      std::replace( name.begin(), name.end(), '-', '_' );
+      param.field = name;
+   }
+
+   if ( !isIdentifier( param.field ) )
+      throw SchemaError( where + ": invalid field name '" + param.field + "'" );
+
+   setDefaultCounts( param, where );
+}
+
+ParserSpec readSchema( const std::string& schemaPath )
+{
+   std::ifstream file( schemaPath );
+   if ( !file )
+      throw SchemaError( schemaPath + ": can not open the schema" );
+
+   ParserSpec spec;
+   ParameterSpec* pParam = nullptr;
+   bool inParser = false;
+   std::string line;
+   int lineNo = 0;
+
+   while ( std::getline( file, line ) ) {
+      ++lineNo;
+      auto where = schemaPath + ":" + std::to_string( lineNo );
+      line = trim( line );
+      if ( line.empty() || line[0] == '#' )
+         continue;
+
+      if ( line[0] == '[' ) {
+         if ( line.back() != ']' )
+            throw SchemaError( where + ": invalid section" );
+         auto section = trim( line.substr( 1, line.size() - 2 ) );
+         inParser = section == "parser";
+         pParam = nullptr;
+         if ( section == "option" || section == "positional" ) {
+            spec.parameters.emplace_back();
+            pParam = &spec.parameters.back();
+            pParam->isPositional = section == "positional";
+            pParam->line = lineNo;
+         }
+         else if ( !inParser )
+            throw SchemaError( where + ": unknown section '" + section + "'" );
+         continue;
+      }
+
+      auto eqpos = line.find( '=' );
+      if ( eqpos == std::string::npos )
+         throw SchemaError( where + ": expected 'key = value'" );
+      auto key = trim( line.substr( 0, eqpos ) );
+      auto value = trim( line.substr( eqpos + 1 ) );
+
+      if ( inParser ) {
+         if ( key == "struct" )
+            spec.structName = value;
+         else if ( key == "namespace" )
+            spec.ns = value;
+         else if ( key == "program" )
+            spec.program = value;
+         else if ( key == "description" )
+            spec.description = value;
+         else if ( key == "epilog" )
+            spec.epilog = value;
+         else
+            throw SchemaError( where + ": unknown key '" + key + "'" );
+         continue;
+      }
+
+      if ( !pParam )
+         throw SchemaError( where + ": a key outside of a section" );
+
+      auto& param = *pParam;
+      if ( key == "names" && !param.isPositional ) {
+         std::istringstream names( value );
+         for ( std::string name; names >> name; ) {
+            if ( name.substr( 0, 2 ) == "--" && name.size() > 2 )
+               param.longName = name;
+            else if ( name.size() == 2 && name[0] == '-' )
+               param.shortName = name;
+            else
+               throw SchemaError( where + ": invalid option name '" + name + "'" );
+         }
+      }
+      else if ( key == "name" && param.isPositional )
+         param.longName = value;
+      else if ( key == "type" )
+         param.type = parseType( value, where );
+      else if ( key == "field" )
+         param.field = value;
+      else if ( key == "help" )
+         param.help = value;
+      else if ( key == "metavar" )
+         param.metavar = value;
+      else if ( key == "required" )
+         param.isRequired = parseBool( value, where );
+      else if ( key == "nargs" || key == "minargs" || key == "maxargs" ) {
+         if ( !param.countKey.empty() )
+            throw SchemaError( where + ": only one of nargs, minargs and maxargs can be used" );
+         param.countKey = key;
+         auto count = parseCount( value, where );
+         param.minArgs = key == "maxargs" ? 0 : count;
+         param.maxArgs = key == "minargs" ? -1 : count;
+      }
+      else
+         throw SchemaError( where + ": unknown key '" + key + "'" );
+   }
+
+   if ( !isIdentifier( spec.structName ) )
+      throw SchemaError( schemaPath + ": the parser needs a valid 'struct' name" );
+
+   std::set<std::string> names;
+   std::set<std::string> fields;
+   for ( auto& param : spec.parameters ) {
+      finishParameter( param, schemaPath );
+      auto where = schemaPath + ":" + std::to_string( param.line );
+      for ( auto& name : { param.shortName, param.longName } )
+         if ( !name.empty() && !names.insert( name ).second )
+            throw SchemaError( where + ": duplicate name '" + name + "'" );
+      if ( !fields.insert( param.field ).second )
+         throw SchemaError( where + ": duplicate field '" + param.field + "'" );
+   }
+
+   return spec;
+}
+
+// Add the default help options if they are not used by other options.
+void addHelpOption( ParserSpec& spec )
+{
+   auto isUsed = [&]( const std::string& name ) {
+      return std::any_of( spec.parameters.begin(), spec.parameters.end(), [&]( auto& param ) {
+         return !param.isPositional && ( param.shortName == name || param.longName == name );
+      } );
+   };
+
+   ParameterSpec help;
+   help.isHelp = true;
+   help.type = EType::flag;
+   help.shortName = isUsed( "-h" ) ? "" : "-h";
+   help.longName = isUsed( "--help" ) ? "" : "--help";
+   help.help = "Display this help message and exit.";
+   if ( !help.shortName.empty() || !help.longName.empty() )
+      spec.parameters.push_back( help );
+}
+
+// Render the help with the same formatter that is used by argument_parser.
+std::string renderHelp( const ParserSpec& spec )
+{
+   std::deque<bool> flags;
+   std::deque<std::optional<long>> integers;
+   std::deque<std::optional<double>> reals;
+   std::deque<std::optional<std::string>> strings;
+   std::deque<std::vector<long>> integerLists;
+   std::deque<std::vector<double>> realLists;
+   std::deque<std::vector<std::string>> stringLists;
+
+   std::stringstream help;
+   auto parser = argument_parser{};
+   parser.config().program( spec.program ).description( spec.description ).epilog( spec.epilog );
+   parser.config().cout( help );
+   auto params = parser.params();
+
+   auto configure = [&]( auto&& config, const ParameterSpec& param ) {
+      config.help( param.help );
+      if ( !param.metavar.empty() )
+         config.metavar( param.metavar );
+      if ( param.type != EType::flag ) {
+         if ( param.maxArgs < 0 )
+            config.minargs( param.minArgs );
+         else if ( param.minArgs == 0 && param.maxArgs > 0 && param.countKey == "maxargs" )
+            config.maxargs( param.maxArgs );
+         else
+            config.nargs( param.maxArgs );
+      }
+      config.required( param.isRequired );
+   };
+
+   auto add = [&]( auto& targets, const ParameterSpec& param ) {
+      auto& target = targets.emplace_back();
+      auto config = params.add_parameter( target, param.shortName, param.longName );
+      configure( config, param );
+   };
+
+   for ( auto& param : spec.parameters ) {
+      if ( param.isHelp ) {
+         params.add_help_option( param.shortName, param.longName );
+         continue;
+      }
+      switch ( param.type ) {
+         case EType::flag:
+            add( flags, param );
+            break;
+         case EType::integer:
+            add( integers, param );
+            break;
+         case EType::real:
+            add( reals, param );
+            break;
+         case EType::string:
+            add( strings, param );
+            break;
+         case EType::integerList:
+            add( integerLists, param );
+            break;
+         case EType::realList:
+            add( realLists, param );
+            break;
+         case EType::stringList:
+            add( stringLists, param );
+            break;
+      }
+   }
+
+   auto helpName = std::string( spec.parameters.back().getName() );
+   auto res = parser.parse_args( { helpName } );
+   if ( res || !res.help_was_shown() )
+      throw SchemaError( "failed to render the help" );
+
+   return help.str();
+}
+
+// Find the seed and the size of a perfect hash table of the option names.
+std::vector<int> buildNameSlots( const ParserSpec& spec, uint32_t& seed )
+{
+   std::vector<std::pair<std::string, int>> names;
+   for ( size_t i = 0; i < spec.parameters.size(); ++i ) {
+      auto& param = spec.parameters[i];
+      if ( param.isPositional )
+         continue;
+      for ( auto& name : { param.shortName, param.longName } )
+         if ( !name.empty() )
+            names.emplace_back( name, int( i ) );
+   }
+
+   size_t size = 1;
+   while ( size < 2 * names.size() )
+      size *= 2;
+
+   for ( ;; size *= 2 ) {
+      std::vector<int> slots( size, -1 );
+      for ( seed = 0; seed < 100000; ++seed ) {
+         std::fill( slots.begin(), slots.end(), -1 );
+         auto collision = false;
+         for ( auto& [name, index] : names ) {
+            auto& slot = slots[static_name_hash( name, seed ) & ( size - 1 )];
+            if ( slot >= 0 ) {
+               collision = true;
+               break;
+            }
+            slot = index;
+         }
+         if ( !collision )
+            return slots;
+      }
+   }
+}
+
+std::string quote( std::string_view str )
+{
+   std::string res = "\"";
+   for ( auto ch : str ) {
+      switch ( ch ) {
+         case '"':
+            res += "\\\"";
+            break;
+         case '\\':
+            res += "\\\\";
+            break;
+         case '\n':
+            res += "\\n\"\n         \"";
+            break;
+         case '\t':
+            res += "\\t";
+            break;
+         default:
+            res += ch;
+      }
+   }
+   res += "\"";
+
+   // Drop the empty literal after the last line.
+   auto empty = std::string( "\n         \"\"" );
+   if ( res.size() > empty.size() + 2 && res.substr( res.size() - empty.size() ) == empty )
+      res.resize( res.size() - empty.size() );
+   return res;
+}
+
+std::string fieldType( const ParameterSpec& param )
+{
+   switch ( param.type ) {
+      case EType::flag:
+         return "bool";
+      case EType::integer:
+         return "std::optional<long>";
+      case EType::real:
+         return "std::optional<double>";
+      case EType::string:
+         return "std::optional<std::string_view>";
+      case EType::integerList:
+         return "std::vector<long>";
+      case EType::realList:
+         return "std::vector<double>";
+      case EType::stringList:
+         return "std::vector<std::string_view>";
+   }
+   return {};
+}
+
+void writeHeader( std::ostream& out, const ParserSpec& spec, const std::string& schemaPath )
+{
+   const auto& name = spec.structName;
+   uint32_t seed = 0;
+   auto slots = buildNameSlots( spec, seed );
+   auto help = renderHelp( spec );
+
+   out << "// Generated by argumentum-gen from "
+       << std::filesystem::path( schemaPath ).filename().string() << ".  Do not edit.\n\n";
+   out << "#pragma once\n\n";
+   out << "#include <argumentum/staticparser.h>\n\n";
+   out << "#include <array>\n#include <cstdint>\n#include <optional>\n";
+   out << "#include <string_view>\n#include <vector>\n\n";
+   if ( !spec.ns.empty() )
+      out << "namespace " << spec.ns << " {\n\n";
+
+   out << "struct " << name << "\n{\n";
+   for ( auto& param : spec.parameters )
+      if ( !param.isHelp )
+         out << "   " << fieldType( param ) << " " << param.field
+             << ( param.type == EType::flag ? " = false;\n" : ";\n" );
+   out << "\n   struct spec;\n\n";
+   out << "   // Parse the arguments.  The string values are views into argv.\n";
+   out << "   argumentum::static_parse_result parse_args( int argc, const char* const* argv,\n";
+   out << "         int skip_args = 1,\n";
+   out << "         argumentum::static_output_t* pOut = argumentum::default_static_output() );\n";
+   out << "};\n\n";
+
+   out << "struct " << name << "::spec\n{\n";
+   out << "   static constexpr std::array<argumentum::StaticOption, " << spec.parameters.size()
+       << "> options = { {\n";
+   for ( auto& param : spec.parameters ) {
+      out << "      { " << quote( param.shortName ) << ", " << quote( param.longName ) << ", "
+          << param.minArgs << ", " << param.maxArgs << ", "
+          << ( param.isRequired ? "true" : "false" ) << ", "
+          << ( param.isPositional ? "true" : "false" ) << ", "
+          << ( param.isHelp ? "true" : "false" ) << " },\n";
+   }
+   out << "   } };\n\n";
+
+   std::vector<size_t> positional;
+   for ( size_t i = 0; i < spec.parameters.size(); ++i )
+      if ( spec.parameters[i].isPositional )
+         positional.push_back( i );
+   out << "   static constexpr std::array<int, " << positional.size() << "> positional = { {";
+   for ( size_t i = 0; i < positional.size(); ++i )
+      out << ( i > 0 ? ", " : " " ) << positional[i];
+   out << " } };\n\n";
+
+   out << "   static constexpr uint32_t hashSeed = " << seed << ";\n";
+   out << "   static constexpr std::array<int16_t, " << slots.size() << "> nameSlots = { {";
+   for ( size_t i = 0; i < slots.size(); ++i )
+      out << ( i % 16 == 0 ? "\n         " : " " ) << slots[i] << ",";
+   out << "\n   } };\n\n";
+
+   out << "   static constexpr std::string_view help =\n         " << quote( help ) << ";\n\n";
+
+   out << "   static bool assign( " << name << "& args, int index, std::string_view value )\n";
+   out << "   {\n      switch ( index ) {\n";
+   for ( size_t i = 0; i < spec.parameters.size(); ++i ) {
+      auto& param = spec.parameters[i];
+      if ( !param.isHelp )
+         out << "         case " << i << ":\n            return argumentum::static_assign( args."
+             << param.field << ", value );\n";
+   }
+   out << "      }\n      return false;\n   }\n};\n\n";
+
+   out << "inline argumentum::static_parse_result " << name
+       << "::parse_args( int argc, const char* const* argv, int skip_args,\n"
+       << "      argumentum::static_output_t* pOut )\n";
+   out << "{\n   return argumentum::static_parse_args<spec>( *this, argc, argv, skip_args, pOut );\n}\n";
+
+   if ( !spec.ns.empty() )
+      out << "\n}   // namespace " << spec.ns << "\n";
+}
+
+}   // namespace
+
+int main( int argc, char** argv )
+{
+   if ( argc != 3 ) {
+      std::cerr << "usage: argumentum-gen SCHEMA OUTPUT\n";
+      return 2;
+   }
+
+   try {
+      auto spec = readSchema( argv[1] );
+      addHelpOption( spec );
+
+      std::stringstream header;
+      writeHeader( header, spec, argv[1] );
+
+      std::ofstream out( argv[2] );
+      out << header.str();
+      if ( !out ) {
+         std::cerr << argv[2] << ": can not write the output\n";
+         return 1;
+      }
+   }
+   catch ( const std::exception& e ) {
+      std::cerr << e.what() << "\n";
+      return 1;
+   }
+
+   return 0;
+}